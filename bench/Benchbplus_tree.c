@@ -0,0 +1,173 @@
+#include <stdlib.h>
+#include "bench.h"
+#include "array_methods.h"
+#include "linked_list_methods_EmbArt.h"
+#include "vector.h"
+#include "bplus_tree.h"
+
+// An ordered set of random 64-bit keys: a sorted "vector_t" ("vector_sorted_insert", binary search, "vector_remove")
+// and a sorted "ll_t" list ("linked_list_sorted_insert", "linked_list_find", "list_del"), against "bplus_tree_t" with
+// nodes of 128, 256, 1024 (the default) and 4096 bytes. The array and the list are O(n) per insert, so they're run on
+// fewer keys; the tree is run on both sizes. Also range counts, a full scan, and "bplus_tree_bulk_load".
+
+#ifndef NUM_KEYS
+#define NUM_KEYS        (1u << 20)
+#endif
+#define NUM_ARRAY_KEYS  16384
+#define NUM_LIST_KEYS   8192
+#define NUM_RANGES      100000
+
+typedef struct key_node_t
+{
+    ll_t        node;
+    uint64_t    key;
+} key_node_t;
+
+static int compare_keys( const void * item_one, const void * item_two )
+{
+    uint64_t one = *(const uint64_t *)item_one, two = *(const uint64_t *)item_two;
+    return ( one > two ) - ( one < two );
+}
+
+static int compare_key_nodes( const void * item_one, const void * item_two )
+{
+    uint64_t one = ((const key_node_t *)item_one)->key, two = ((const key_node_t *)item_two)->key;
+    return ( one > two ) - ( one < two );
+}
+
+// "linked_list_find" passes the key itself as its first argument
+//
+static int compare_key_to_node( const void * key, const void * elem )
+{
+    return *(const uint64_t *)key != ((const key_node_t *)elem)->key;
+}
+
+static void make_keys( uint64_t * keys, size_t num )
+{
+    uint64_t state = 88172645463325252ULL;
+
+    for( size_t idx = 0; idx < num; idx++ ) keys[idx] = bench_rand( &state );
+}
+
+static void run_tree( const uint64_t * keys, size_t num, size_t node_bytes )
+{
+    char name[96];
+    bplus_tree_t tree;
+    uint64_t sum = 0;
+
+    bplus_tree_init( &tree, sizeof(uint64_t), node_bytes, compare_keys );
+
+    double start = bench_now();
+    for( size_t idx = 0; idx < num; idx++ ) bplus_tree_insert( &tree, &keys[idx] );
+    snprintf( name, sizeof(name), "%zu bplus_tree_insert (%zu-byte nodes)", num, tree.node_bytes );
+    bench_report( name, num, bench_now() - start );
+
+    start = bench_now();
+    for( size_t idx = 0; idx < num; idx++ ) sum += bplus_tree_find( &tree, &keys[num - 1 - idx] ) != NULL;
+    snprintf( name, sizeof(name), "%zu bplus_tree_find (%zu-byte nodes)", num, tree.node_bytes );
+    bench_report( name, num, bench_now() - start );
+
+    start = bench_now();
+    for( size_t idx = 0; idx < num; idx++ ) sum += bplus_tree_remove( &tree, &keys[idx], NULL );
+    snprintf( name, sizeof(name), "%zu bplus_tree_remove (%zu-byte nodes)", num, tree.node_bytes );
+    bench_report( name, num, bench_now() - start );
+
+    bplus_tree_free( &tree, NULL );
+    bench_sink += sum;
+}
+
+int main( void )
+{
+    uint64_t * keys = malloc( NUM_KEYS * sizeof(uint64_t) ), * sorted = malloc( NUM_KEYS * sizeof(uint64_t) ), sum = 0;
+    key_node_t * nodes = malloc( NUM_LIST_KEYS * sizeof(key_node_t) );
+    vector_t vec = VECTOR_INIT(sizeof(uint64_t));
+    bplus_tree_t tree;
+    bplus_iter_t iter;
+    LIST_INIT(head);
+    size_t node_sizes[] = { 128, 256, 1024, 4096 };
+
+    make_keys( keys, NUM_KEYS );
+
+    // Sorted array
+    //
+    double start = bench_now();
+    for( size_t idx = 0; idx < NUM_ARRAY_KEYS; idx++ ) vector_sorted_insert( &vec, &keys[idx], compare_keys );
+    bench_report( "16K vector_sorted_insert", NUM_ARRAY_KEYS, bench_now() - start );
+
+    start = bench_now();
+    for( size_t idx = 0; idx < NUM_ARRAY_KEYS; idx++ ) sum += array_lower_bound( &keys[NUM_ARRAY_KEYS - 1 - idx], vec.data, vec.len, vec.size, compare_keys );
+    bench_report( "16K array_lower_bound", NUM_ARRAY_KEYS, bench_now() - start );
+
+    start = bench_now();
+    for( size_t idx = 0; idx < NUM_ARRAY_KEYS; idx++ ) vector_remove( &vec, array_lower_bound( &keys[idx], vec.data, vec.len, vec.size, compare_keys ), NULL );
+    bench_report( "16K array_lower_bound + vector_remove", NUM_ARRAY_KEYS, bench_now() - start );
+    vector_free( &vec, NULL );
+
+    // Sorted list
+    //
+    start = bench_now();
+    for( size_t idx = 0; idx < NUM_LIST_KEYS; idx++ )
+    {
+        nodes[idx].key = keys[idx];
+        linked_list_sorted_insert( &head, &nodes[idx].node, compare_key_nodes );
+    }
+    bench_report( "8K linked_list_sorted_insert", NUM_LIST_KEYS, bench_now() - start );
+
+    start = bench_now();
+    for( size_t idx = 0; idx < NUM_LIST_KEYS; idx++ ) sum += linked_list_find( &keys[NUM_LIST_KEYS - 1 - idx], &head, compare_key_to_node ) != NULL;
+    bench_report( "8K linked_list_find", NUM_LIST_KEYS, bench_now() - start );
+
+    start = bench_now();
+    for( size_t idx = 0; idx < NUM_LIST_KEYS; idx++ ) list_del( linked_list_find( &keys[idx], &head, compare_key_to_node ) );
+    bench_report( "8K linked_list_find + list_del", NUM_LIST_KEYS, bench_now() - start );
+
+    // Tree, on as many keys as the array and the list, then on all of them
+    //
+    run_tree( keys, NUM_ARRAY_KEYS, 0 );
+    run_tree( keys, NUM_LIST_KEYS, 0 );
+    ARRAY_FOR_EACH( node_sizes, idx ) run_tree( keys, NUM_KEYS, node_sizes[idx] );
+
+    // Bulk loading, counting random ranges (about 1000 keys each), and reading every key in order. The sorted array
+    // does the same with two binary searches and a loop.
+    //
+    memcpy( sorted, keys, NUM_KEYS * sizeof(uint64_t) );
+    qsort( sorted, NUM_KEYS, sizeof(uint64_t), compare_keys );
+    bplus_tree_init( &tree, sizeof(uint64_t), 0, compare_keys );
+    start = bench_now();
+    bplus_tree_bulk_load( &tree, sorted, NUM_KEYS );
+    bench_report( "1M bplus_tree_bulk_load", NUM_KEYS, bench_now() - start );
+
+    start = bench_now();
+    for( size_t idx = 0; idx < NUM_RANGES; idx++ )
+    {
+        uint64_t lo = keys[idx], hi = lo + ( UINT64_MAX / NUM_KEYS ) * 1000;
+        sum += bplus_tree_count_range( &tree, &lo, hi > lo ? &hi : NULL );
+    }
+    bench_report( "1M bplus_tree_count_range (~1000 keys)", NUM_RANGES, bench_now() - start );
+
+    start = bench_now();
+    for( size_t idx = 0; idx < NUM_RANGES; idx++ )
+    {
+        uint64_t lo = keys[idx], hi = lo + ( UINT64_MAX / NUM_KEYS ) * 1000;
+        sum += ( hi > lo ? array_upper_bound( &hi, sorted, NUM_KEYS, sizeof(uint64_t), compare_keys ) : NUM_KEYS ) -
+               array_lower_bound( &lo, sorted, NUM_KEYS, sizeof(uint64_t), compare_keys );
+    }
+    bench_report( "1M array_lower_bound + _upper_bound", NUM_RANGES, bench_now() - start );
+
+    start = bench_now();
+    uint64_t * key;
+    bplus_tree_for_each( key, &iter, &tree ) sum += *key;
+    bench_report( "1M bplus_tree_for_each", NUM_KEYS, bench_now() - start );
+
+    start = bench_now();
+    for( size_t idx = 0; idx < NUM_KEYS; idx++ ) sum += sorted[idx];
+    bench_report( "1M sorted array loop", NUM_KEYS, bench_now() - start );
+
+    bplus_tree_free( &tree, NULL );
+    free( keys );
+    free( sorted );
+    free( nodes );
+    bench_sink += sum;
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include <stdlib.h>
+#include <stddef.h>     // For offsetof
+#include "bench.h"
+#include "array_methods.h"
+
+// Queries on one 4-byte field of 64-byte records: "array_count", "array_find_minmax" and "array_find" with a callback
+// on each record, against the field kernels on the records themselves (strided), and on a dense column of the field
+// made with "array_aos_to_soa" (whose cost is reported separately).
+
+#ifndef NUM_RECORDS
+#define NUM_RECORDS     (1u << 20)
+#endif
+
+typedef struct record_t
+{
+    uint64_t    id;
+    uint32_t    status;
+    uint32_t    amount;
+    uint64_t    payload[6];
+} record_t;
+
+static bool is_pending( const void * elem )
+{
+    return ((const record_t *)elem)->status == 3;
+}
+
+static int compare_amounts( const void * item_one, const void * item_two )
+{
+    uint32_t one = ((const record_t *)item_one)->amount, two = ((const record_t *)item_two)->amount;
+    return ( one > two ) - ( one < two );
+}
+
+static int compare_id( const void * key, const void * elem )
+{
+    return *(const uint64_t *)key != ((const record_t *)elem)->id;
+}
+
+int main( void )
+{
+    record_t * records = malloc( NUM_RECORDS * sizeof(record_t) );
+    uint32_t * status = malloc( NUM_RECORDS * sizeof(uint32_t) ), * amount = malloc( NUM_RECORDS * sizeof(uint32_t) );
+    uint64_t state = 88172645463325252ULL, sum = 0, last_id = NUM_RECORDS - 1;
+    size_t offsets[] = { offsetof(record_t, status), offsetof(record_t, amount) }, widths[] = { 4, 4 };
+    void * columns[] = { status, amount };
+    int min, max;
+
+    for( size_t idx = 0; idx < NUM_RECORDS; idx++ )
+    {
+        records[idx].id = idx;
+        records[idx].status = bench_rand( &state ) % 8;
+        records[idx].amount = bench_rand( &state ) >> 32;
+    }
+    memset( status, 0, NUM_RECORDS * sizeof(uint32_t) );
+    memset( amount, 0, NUM_RECORDS * sizeof(uint32_t) );
+
+    double start = bench_now();
+    sum += array_count( records, NUM_RECORDS, sizeof(record_t), is_pending );
+    bench_report( "array_count (callback)", NUM_RECORDS, bench_now() - start );
+
+    start = bench_now();
+    sum += array_count_field_range( records, NUM_RECORDS, sizeof(record_t), offsetof(record_t, status), 4, 3, 3 );
+    bench_report( "array_count_field_range (strided)", NUM_RECORDS, bench_now() - start );
+
+    start = bench_now();
+    array_aos_to_soa( records, NUM_RECORDS, sizeof(record_t), offsets, widths, LEN_ARRAY(offsets), columns );
+    bench_report( "array_aos_to_soa (2 fields)", NUM_RECORDS, bench_now() - start );
+
+    start = bench_now();
+    sum += array_count_field_range( status, NUM_RECORDS, sizeof(uint32_t), 0, 4, 3, 3 );
+    bench_report( "array_count_field_range (column)", NUM_RECORDS, bench_now() - start );
+
+    start = bench_now();
+    array_find_minmax( records, NUM_RECORDS, sizeof(record_t), &min, &max, compare_amounts );
+    bench_report( "array_find_minmax (callback)", NUM_RECORDS, bench_now() - start );
+    sum += min + max;
+
+    start = bench_now();
+    array_find_minmax_field( records, NUM_RECORDS, sizeof(record_t), offsetof(record_t, amount), 4, &min, &max );
+    bench_report( "array_find_minmax_field (strided)", NUM_RECORDS, bench_now() - start );
+    sum += min + max;
+
+    start = bench_now();
+    array_find_minmax_field( amount, NUM_RECORDS, sizeof(uint32_t), 0, 4, &min, &max );
+    bench_report( "array_find_minmax_field (column)", NUM_RECORDS, bench_now() - start );
+    sum += min + max;
+
+    start = bench_now();
+    sum += array_find( &last_id, records, NUM_RECORDS, sizeof(record_t), compare_id );
+    bench_report( "array_find (callback, last record)", NUM_RECORDS, bench_now() - start );
+
+    start = bench_now();
+    sum += array_find_field( records, NUM_RECORDS, sizeof(record_t), offsetof(record_t, id), 8, last_id );
+    bench_report( "array_find_field (strided, last record)", NUM_RECORDS, bench_now() - start );
+
+    free( records );
+    free( status );
+    free( amount );
+    bench_sink = sum;
+
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include <stdlib.h>
+#include "bench.h"
+#include "array_methods.h"
+
+// Two predicates chained over an array of wide (64-byte) records, keeping the rows that pass both: copying the
+// survivors of each predicate with "array_filter_pure", against late materialization with a selection vector
+// ("array_filter_select", "array_filter_select_more", then "array_gather") and with bitmaps ("array_filter_bitmap"
+// twice, "array_bitmap_and", "array_bitmap_to_selection", then "array_gather"). Also counts the rows that pass both,
+// with "array_count_bitmap" on the combined bitmap.
+
+#ifndef NUM_ROWS
+#define NUM_ROWS        (1u << 20)
+#endif
+
+typedef struct row_t
+{
+    uint32_t    region;
+    uint32_t    amount;
+    uint64_t    payload[7];
+} row_t;
+
+static bool in_region( const void * elem )
+{
+    return ((const row_t *)elem)->region < 128;     // About half of the rows
+}
+
+static bool is_large( const void * elem )
+{
+    return ((const row_t *)elem)->amount < 1u << 28;    // About a sixteenth of the rows
+}
+
+int main( void )
+{
+    row_t * rows = malloc( NUM_ROWS * sizeof(row_t) ), * out = malloc( NUM_ROWS * sizeof(row_t) ), * temp = malloc( NUM_ROWS * sizeof(row_t) );
+    uint32_t * selection = malloc( NUM_ROWS * sizeof(uint32_t) );
+    uint64_t * one = malloc( ARRAY_BITMAP_WORDS(NUM_ROWS) * sizeof(uint64_t) ), * two = malloc( ARRAY_BITMAP_WORDS(NUM_ROWS) * sizeof(uint64_t) );
+    uint64_t state = 88172645463325252ULL, sum = 0;
+    size_t count;
+
+    for( size_t idx = 0; idx < NUM_ROWS; idx++ )
+    {
+        rows[idx].region = bench_rand( &state ) >> 56;
+        rows[idx].amount = bench_rand( &state ) >> 32;
+        for( int word = 0; word < 7; word++ ) rows[idx].payload[word] = idx;
+    }
+    memset( out, 0, NUM_ROWS * sizeof(row_t) );         // So that no run pays for first touching the pages
+    memset( temp, 0, NUM_ROWS * sizeof(row_t) );
+    memset( selection, 0, NUM_ROWS * sizeof(uint32_t) );
+
+    double start = bench_now();
+    count = array_filter_pure( rows, NUM_ROWS, sizeof(rows[0]), temp, in_region );
+    count = array_filter_pure( temp, count, sizeof(rows[0]), out, is_large );
+    bench_report( "array_filter_pure x2", NUM_ROWS, bench_now() - start );
+    sum += count + out[count / 2].amount;
+
+    start = bench_now();
+    count = array_filter_select( rows, NUM_ROWS, sizeof(rows[0]), selection, in_region );
+    count = array_filter_select_more( rows, sizeof(rows[0]), selection, count, is_large );
+    array_gather( rows, sizeof(rows[0]), selection, count, out );
+    bench_report( "array_filter_select + _more + gather", NUM_ROWS, bench_now() - start );
+    sum += count + out[count / 2].amount;
+
+    start = bench_now();
+    array_filter_bitmap( rows, NUM_ROWS, sizeof(rows[0]), one, in_region );
+    array_filter_bitmap( rows, NUM_ROWS, sizeof(rows[0]), two, is_large );
+    array_bitmap_and( one, two, NUM_ROWS );
+    count = array_bitmap_to_selection( one, NUM_ROWS, selection );
+    array_gather( rows, sizeof(rows[0]), selection, count, out );
+    bench_report( "array_filter_bitmap x2 + and + gather", NUM_ROWS, bench_now() - start );
+    sum += count + out[count / 2].amount;
+
+    // Counting only: no rows are copied at all.
+    //
+    start = bench_now();
+    count = array_count_bitmap( one, NUM_ROWS );
+    bench_report( "array_count_bitmap (after and)", NUM_ROWS, bench_now() - start );
+    sum += count;
+
+    start = bench_now();
+    count = array_filter_pure( rows, NUM_ROWS, sizeof(rows[0]), temp, in_region );
+    count = array_count( temp, count, sizeof(rows[0]), is_large );
+    bench_report( "array_filter_pure + array_count", NUM_ROWS, bench_now() - start );
+    sum += count;
+
+    free( rows );
+    free( out );
+    free( temp );
+    free( selection );
+    free( one );
+    free( two );
+    bench_sink = sum;
+
+    return 0;
+}
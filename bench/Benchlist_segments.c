@@ -0,0 +1,92 @@
+#include <stdlib.h>
+#include "bench.h"
+#include "array_methods.h"
+#include "linked_list_methods_EmbArt.h"
+#include "list_segments.h"
+
+// Serial "linked_list_count"/"linked_list_find" against the segmented parallel versions, on a list whose nodes are
+// scattered through memory. Speedup is limited by the number of CPUs available.
+
+#ifndef NUM_ITEMS
+#define NUM_ITEMS       (1u << 22)
+#endif
+#define SEGMENT_LENGTH  65536
+
+typedef struct node_t
+{
+    ll_t        node;
+    uint32_t    data;
+} node_t;
+
+static node_t nodes[NUM_ITEMS];
+static uint32_t link_order[NUM_ITEMS];
+
+static bool is_odd_node( const void * elem )
+{
+    return ((const node_t *)elem)->data & 1;
+}
+
+static int compare_node( const void * key, const void * elem )
+{
+    return *(const uint32_t *)key != ((const node_t *)elem)->data;
+}
+
+int main( void )
+{
+    static const size_t threads[] = { 1, 2, 4, 8 };
+    uint64_t state = 88172645463325252ULL, sum = 0;
+    LIST_INIT(head);
+    list_segments_t segments;
+    char name[64];
+
+    for( size_t idx = 0; idx < NUM_ITEMS; idx++ ) link_order[idx] = idx;
+    for( size_t idx = NUM_ITEMS - 1; idx > 0; idx-- )
+    {
+        size_t other = bench_rand( &state ) % ( idx + 1 );
+        uint32_t temp = link_order[idx];
+        link_order[idx] = link_order[other];
+        link_order[other] = temp;
+    }
+    for( size_t idx = 0; idx < NUM_ITEMS; idx++ )
+    {
+        nodes[link_order[idx]].data = idx;
+        list_add_tail( &nodes[link_order[idx]].node, &head );
+    }
+
+    // The key is the last node in the list, so every search walks the whole list.
+    //
+    uint32_t key = NUM_ITEMS - 1;
+
+    double start = bench_now();
+    list_segments_build( &segments, &head, SEGMENT_LENGTH );
+    bench_report( "list_segments_build", NUM_ITEMS, bench_now() - start );
+
+    start = bench_now();
+    sum += linked_list_count( &head, is_odd_node );
+    bench_report( "linked_list_count", NUM_ITEMS, bench_now() - start );
+
+    for( size_t idx = 0; idx < LEN_ARRAY(threads); idx++ )
+    {
+        start = bench_now();
+        sum += linked_list_count_par( &segments, is_odd_node, threads[idx] );
+        snprintf( name, sizeof(name), "linked_list_count_par (%zu threads)", threads[idx] );
+        bench_report( name, NUM_ITEMS, bench_now() - start );
+    }
+
+    start = bench_now();
+    sum += (uintptr_t)linked_list_find( &key, &head, compare_node );
+    bench_report( "linked_list_find", NUM_ITEMS, bench_now() - start );
+
+    for( size_t idx = 0; idx < LEN_ARRAY(threads); idx++ )
+    {
+        start = bench_now();
+        sum += (uintptr_t)linked_list_find_par( &key, &segments, compare_node, threads[idx] );
+        snprintf( name, sizeof(name), "linked_list_find_par (%zu threads)", threads[idx] );
+        bench_report( name, NUM_ITEMS, bench_now() - start );
+    }
+
+    list_segments_free( &segments );
+    bench_sink = sum;
+
+    return 0;
+}
@@ -0,0 +1,208 @@
+#include <stdlib.h>
+#include <math.h>
+#include "bench.h"
+#include "array_methods.h"
+#include "linked_list_methods_EmbArt.h"
+#include "parallel.h"
+#include "lru_cache.h"
+
+// "lru_cache_t" against the usual hand-rolled LRU (an "ll_t" recency list searched with "linked_list_find"), and the
+// sharded cache from several threads, on keys drawn from a Zipfian distribution (s = 0.99) over a million distinct
+// keys. Each access looks the key up and, on a miss, allocates a node and puts it in the cache, evicting (and freeing)
+// the least recently used node if the cache is full. Speedup of the sharded cache is limited by the number of CPUs
+// available.
+
+#ifndef NUM_ACCESSES
+#define NUM_ACCESSES    (1u << 22)
+#endif
+#define NUM_KEYS        (1u << 20)
+#define ZIPF_S          0.99
+#define NUM_SHARDS      16
+
+static uint64_t accesses[NUM_ACCESSES];
+
+static void free_node( lru_node_t * node, void * context )
+{
+    free( node );
+}
+
+static int compare_key( const void * key, const void * elem )
+{
+    return *(const uint64_t *)key != ((const lru_node_t *)elem)->key;
+}
+
+// Fills "accesses" with keys whose popularity follows Zipf's law: the key of rank r is accessed with a probability
+// proportional to 1 / r^s. Ranks are scrambled into keys so that popular keys aren't numerically close.
+//
+static void make_accesses( void )
+{
+    double * cdf = malloc( NUM_KEYS * sizeof(double) ), total = 0;
+    uint64_t state = 88172645463325252ULL;
+
+    for( size_t rank = 0; rank < NUM_KEYS; rank++ )
+    {
+        total += 1.0 / pow( rank + 1, ZIPF_S );
+        cdf[rank] = total;
+    }
+
+    for( size_t idx = 0; idx < NUM_ACCESSES; idx++ )
+    {
+        double target = ( bench_rand( &state ) >> 11 ) * 0x1.0p-53 * total;
+        size_t lo = 0, hi = NUM_KEYS - 1;
+
+        while( lo < hi )
+        {
+            size_t mid = lo + ( hi - lo ) / 2;
+            if( cdf[mid] < target ) lo = mid + 1;
+            else hi = mid;
+        }
+        accesses[idx] = ( lo + 1 ) * 0x9E3779B97F4A7C15ULL;
+    }
+
+    free( cdf );
+}
+
+static size_t run_lru_cache( size_t capacity, size_t num_accesses )
+{
+    lru_cache_t cache;
+    size_t hits = 0;
+
+    lru_cache_init( &cache, capacity, free_node, NULL );
+    for( size_t idx = 0; idx < num_accesses; idx++ )
+    {
+        if( lru_cache_get( &cache, accesses[idx] ) )
+        {
+            hits++;
+            continue;
+        }
+
+        lru_node_t * node = malloc( sizeof(lru_node_t) );
+        node->key = accesses[idx];
+        lru_cache_put( &cache, node );
+    }
+    lru_cache_free( &cache );
+
+    return hits;
+}
+
+// The LRU most services write for themselves: look the key up by walking the recency list.
+//
+static size_t run_list_lru( size_t capacity, size_t num_accesses )
+{
+    LIST_INIT(recency);
+    size_t hits = 0, count = 0;
+    ll_t * node, * copy;
+
+    for( size_t idx = 0; idx < num_accesses; idx++ )
+    {
+        lru_node_t * found = linked_list_find( &accesses[idx], &recency, compare_key );
+
+        if( found )
+        {
+            hits++;
+            list_del( &found->list );
+            list_add( &found->list, &recency );
+            continue;
+        }
+
+        if( count == capacity )
+        {
+            node = recency.prev;
+            list_del( node );
+            free( node );
+            count--;
+        }
+
+        found = malloc( sizeof(lru_node_t) );
+        found->key = accesses[idx];
+        list_add( &found->list, &recency );
+        count++;
+    }
+    list_for_each_safe( node, copy, &recency ) free( node );
+
+    return hits;
+}
+
+typedef struct sharded_task_t
+{
+    lru_sharded_t * cache;
+    size_t          first;
+    size_t          num;
+    size_t          hits;
+} sharded_task_t;
+
+static void * run_sharded_task( void * arg )
+{
+    sharded_task_t * task = arg;
+
+    for( size_t idx = task->first; idx < task->first + task->num; idx++ )
+    {
+        if( lru_sharded_get( task->cache, accesses[idx], NULL, NULL ) )
+        {
+            task->hits++;
+            continue;
+        }
+
+        lru_node_t * node = malloc( sizeof(lru_node_t) );
+        node->key = accesses[idx];
+        lru_sharded_put( task->cache, node );
+    }
+
+    return NULL;
+}
+
+static void report( const char * name, size_t capacity, size_t num_accesses, size_t hits, double seconds )
+{
+    char label[96];
+
+    snprintf( label, sizeof(label), "%s (%zu, %4.1f%% hits)", name, capacity, 100.0 * hits / num_accesses );
+    bench_report( label, num_accesses, seconds );
+}
+
+int main( void )
+{
+    static const size_t capacities[] = { 1024, 65536 }, threads[] = { 1, 2, 4, 8 };
+    size_t hits;
+    char name[64];
+
+    make_accesses();
+
+    for( size_t idx = 0; idx < LEN_ARRAY(capacities); idx++ )
+    {
+        double start = bench_now();
+        hits = run_lru_cache( capacities[idx], NUM_ACCESSES );
+        report( "lru_cache", capacities[idx], NUM_ACCESSES, hits, bench_now() - start );
+    }
+
+    // Every miss walks the whole list, so the list-based LRU only gets a fraction of the accesses.
+    //
+    double start = bench_now();
+    hits = run_list_lru( capacities[0], NUM_ACCESSES / 16 );
+    report( "ll_t + linked_list_find", capacities[0], NUM_ACCESSES / 16, hits, bench_now() - start );
+
+    for( size_t idx = 0; idx < LEN_ARRAY(threads); idx++ )
+    {
+        lru_sharded_t cache;
+        sharded_task_t tasks[threads[idx]];
+
+        lru_sharded_init( &cache, NUM_SHARDS, capacities[1], free_node, NULL );
+        for( size_t task = 0; task < threads[idx]; task++ )
+        {
+            tasks[task] = (sharded_task_t){ &cache, task * NUM_ACCESSES / threads[idx], NUM_ACCESSES / threads[idx], 0 };
+        }
+
+        start = bench_now();
+        parallel_run( run_sharded_task, tasks, sizeof(tasks[0]), threads[idx] );
+        double seconds = bench_now() - start;
+
+        hits = 0;
+        for( size_t task = 0; task < threads[idx]; task++ ) hits += tasks[task].hits;
+        snprintf( name, sizeof(name), "lru_sharded/%zu, %zu threads", (size_t)NUM_SHARDS, threads[idx] );
+        report( name, capacities[1], NUM_ACCESSES, hits, seconds );
+        lru_sharded_free( &cache );
+    }
+
+    bench_sink = hits;
+
+    return 0;
+}
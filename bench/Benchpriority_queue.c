@@ -0,0 +1,167 @@
+#include <stdlib.h>
+#include "bench.h"
+#include "array_methods.h"
+#include "linked_list_methods_EmbArt.h"
+#include "pairing_heap.h"
+
+// Priority queues on the "hold" model: the queue is filled with Q events, then each operation pops the earliest event
+// and pushes it back with a later time (its old time plus a random increment), so the queue stays at Q events. This
+// is what an event simulation or a timer queue does. Compares an "ll_t" list kept sorted with
+// "linked_list_sorted_insert" (only at the smaller Q, since every push walks the list), the binary and 4-ary array
+// heaps, and the pairing heap.
+
+#ifndef NUM_HOLDS
+#define NUM_HOLDS       (1u << 21)
+#endif
+
+typedef struct event_t
+{
+    pairing_node_t  node;       // Also used as an "ll_t" by the sorted list
+    uint64_t        time;
+} event_t;
+
+static int compare_events( const void * item_one, const void * item_two )
+{
+    uint64_t one = ((const event_t *)item_one)->time, two = ((const event_t *)item_two)->time;
+    return ( two < one ) - ( one < two );
+}
+
+static int compare_times( const void * item_one, const void * item_two )
+{
+    uint64_t one = *(const uint64_t *)item_one, two = *(const uint64_t *)item_two;
+    return ( two < one ) - ( one < two );
+}
+
+static uint64_t increment( uint64_t * state )
+{
+    return bench_rand( state ) >> 44;
+}
+
+static uint64_t run_sorted_list( event_t * events, size_t queue, size_t num_holds )
+{
+    uint64_t state = 88172645463325252ULL;
+    LIST_INIT(head);
+
+    for( size_t idx = 0; idx < queue; idx++ )
+    {
+        events[idx].time = increment( &state );
+        linked_list_sorted_insert( &head, &events[idx].node.link, compare_events );
+    }
+    for( size_t idx = 0; idx < num_holds; idx++ )
+    {
+        event_t * event = (event_t *)head.next;
+        list_del( &event->node.link );
+        event->time += increment( &state );
+        linked_list_sorted_insert( &head, &event->node.link, compare_events );
+    }
+
+    return ((event_t *)head.next)->time;
+}
+
+static uint64_t run_array_heap( uint64_t * heap, size_t queue, size_t num_holds, size_t arity )
+{
+    uint64_t state = 88172645463325252ULL, time = 0;
+
+    for( size_t idx = 0; idx < queue; idx++ ) heap[idx] = increment( &state );
+    array_dheapify( heap, queue, sizeof(heap[0]), arity, compare_times );
+    for( size_t idx = 0; idx < num_holds; idx++ )
+    {
+        size_t num = array_dheap_pop( heap, queue, sizeof(heap[0]), arity, &time, compare_times );
+        time += increment( &state );
+        array_dheap_push( heap, num, sizeof(heap[0]), arity, &time, compare_times );
+    }
+
+    return heap[0];
+}
+
+// The usual way to "hold" with an array heap: replace the top in place and sift it down, instead of popping and
+// pushing.
+//
+static uint64_t run_array_heap_update( uint64_t * heap, size_t queue, size_t num_holds, size_t arity )
+{
+    uint64_t state = 88172645463325252ULL;
+
+    for( size_t idx = 0; idx < queue; idx++ ) heap[idx] = increment( &state );
+    array_dheapify( heap, queue, sizeof(heap[0]), arity, compare_times );
+    for( size_t idx = 0; idx < num_holds; idx++ )
+    {
+        heap[0] += increment( &state );
+        array_dheap_update( heap, queue, sizeof(heap[0]), arity, 0, compare_times );
+    }
+
+    return heap[0];
+}
+
+static uint64_t run_pairing_heap( event_t * events, size_t queue, size_t num_holds )
+{
+    uint64_t state = 88172645463325252ULL;
+    pairing_heap_t heap;
+
+    pairing_heap_init( &heap );
+    for( size_t idx = 0; idx < queue; idx++ )
+    {
+        events[idx].time = increment( &state );
+        pairing_heap_push( &heap, &events[idx].node, compare_events );
+    }
+    for( size_t idx = 0; idx < num_holds; idx++ )
+    {
+        event_t * event = (event_t *)pairing_heap_pop( &heap, compare_events );
+        event->time += increment( &state );
+        pairing_heap_push( &heap, &event->node, compare_events );
+    }
+
+    return ((event_t *)pairing_heap_top( &heap ))->time;
+}
+
+int main( void )
+{
+    static const size_t queues[] = { 1024, 65536 };
+    event_t * events = malloc( queues[1] * sizeof(event_t) );
+    uint64_t * heap = malloc( queues[1] * sizeof(uint64_t) ), sum = 0;
+    char name[64];
+    double start;
+
+    for( size_t idx = 0; idx < LEN_ARRAY(queues); idx++ )
+    {
+        size_t queue = queues[idx];
+
+        if( idx == 0 )
+        {
+            start = bench_now();
+            sum += run_sorted_list( events, queue, NUM_HOLDS / 16 );
+            snprintf( name, sizeof(name), "sorted ll_t, Q = %zu", queue );
+            bench_report( name, NUM_HOLDS / 16, bench_now() - start );
+        }
+
+        start = bench_now();
+        sum += run_array_heap( heap, queue, NUM_HOLDS, 2 );
+        snprintf( name, sizeof(name), "array_heap, Q = %zu", queue );
+        bench_report( name, NUM_HOLDS, bench_now() - start );
+
+        start = bench_now();
+        sum += run_array_heap( heap, queue, NUM_HOLDS, 4 );
+        snprintf( name, sizeof(name), "array_heap4, Q = %zu", queue );
+        bench_report( name, NUM_HOLDS, bench_now() - start );
+
+        start = bench_now();
+        sum += run_array_heap_update( heap, queue, NUM_HOLDS, 2 );
+        snprintf( name, sizeof(name), "array_heap_update, Q = %zu", queue );
+        bench_report( name, NUM_HOLDS, bench_now() - start );
+
+        start = bench_now();
+        sum += run_array_heap_update( heap, queue, NUM_HOLDS, 4 );
+        snprintf( name, sizeof(name), "array_heap4_update, Q = %zu", queue );
+        bench_report( name, NUM_HOLDS, bench_now() - start );
+
+        start = bench_now();
+        sum += run_pairing_heap( events, queue, NUM_HOLDS );
+        snprintf( name, sizeof(name), "pairing_heap, Q = %zu", queue );
+        bench_report( name, NUM_HOLDS, bench_now() - start );
+    }
+
+    free( events );
+    free( heap );
+    bench_sink = sum;
+
+    return 0;
+}
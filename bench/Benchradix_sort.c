@@ -0,0 +1,122 @@
+#include <stdlib.h>
+#include "bench.h"
+#include "array_methods.h"
+#include "linked_list_methods_EmbArt.h"
+#include "radix_sort.h"
+
+// Comparison sorts against key-extraction radix sorts, for an "ll_t" list whose nodes are scattered through memory
+// (so following a node pointer is usually a cache miss) and for an array of 32-byte records.
+
+#ifndef NUM_ITEMS
+#define NUM_ITEMS   (1u << 19)      // "linked_list_qsort" keeps an array of every node pointer on the stack
+#endif
+
+typedef struct node_t
+{
+    ll_t        node;
+    uint64_t    key;
+    uint64_t    payload[4];
+} node_t;
+
+typedef struct record_t
+{
+    uint64_t    key;
+    uint64_t    payload[3];
+} record_t;
+
+static node_t nodes[NUM_ITEMS];
+static uint32_t link_order[NUM_ITEMS];
+static record_t input[NUM_ITEMS], work[NUM_ITEMS];
+
+static int compare_node_pointers( const void * item_one, const void * item_two )
+{
+    uint64_t one = (*(node_t **)item_one)->key, two = (*(node_t **)item_two)->key;
+    return ( two < one ) - ( one < two );
+}
+
+static uint64_t key_of_node( const void * elem )
+{
+    return ((const node_t *)elem)->key;
+}
+
+static int compare_records( const void * item_one, const void * item_two )
+{
+    uint64_t one = ((const record_t *)item_one)->key, two = ((const record_t *)item_two)->key;
+    return ( two < one ) - ( one < two );
+}
+
+static uint64_t key_of_record( const void * elem )
+{
+    return ((const record_t *)elem)->key;
+}
+
+// Links the nodes into "head" in a random order, so consecutive nodes in the list are far apart in memory.
+//
+static void build_list( ll_t * head )
+{
+    head->next = head->prev = head;
+    for( size_t idx = 0; idx < NUM_ITEMS; idx++ ) list_add_tail( &nodes[link_order[idx]].node, head );
+}
+
+static void bench_list( bool radix )
+{
+    LIST_INIT(head);
+    uint64_t sum = 0;
+    ll_t * node;
+
+    build_list( &head );
+
+    double start = bench_now();
+    if( radix ) linked_list_radix_sort( &head, key_of_node );
+    else linked_list_qsort( &head, compare_node_pointers );
+    double elapsed = bench_now() - start;
+
+    bench_report( radix ? "linked_list_radix_sort (32-bit keys)" : "linked_list_qsort", NUM_ITEMS, elapsed );
+    list_for_each( node, &head ) sum = sum * 31 + ((node_t *)node)->key;
+    bench_sink = sum;
+}
+
+static void bench_array( int method )
+{
+    static const char * names[] = { "qsort (32-byte records)", "array_stable_sort (32-byte records)", "array_radix_sort (32-byte records)" };
+
+    memcpy( work, input, sizeof(work) );
+
+    double start = bench_now();
+    switch( method )
+    {
+        case 0: qsort( work, NUM_ITEMS, sizeof(record_t), compare_records ); break;
+        case 1: array_stable_sort( work, NUM_ITEMS, sizeof(record_t), compare_records ); break;
+        case 2: array_radix_sort( work, NUM_ITEMS, sizeof(record_t), key_of_record ); break;
+    }
+    double elapsed = bench_now() - start;
+
+    bench_report( names[method], NUM_ITEMS, elapsed );
+    bench_sink = work[NUM_ITEMS / 2].payload[0];
+}
+
+int main( void )
+{
+    uint64_t state = 88172645463325252ULL;
+
+    for( size_t idx = 0; idx < NUM_ITEMS; idx++ )
+    {
+        nodes[idx].key = (uint32_t)bench_rand( &state );
+        input[idx].key = (uint32_t)bench_rand( &state );
+        input[idx].payload[0] = idx;
+        link_order[idx] = idx;
+    }
+    for( size_t idx = NUM_ITEMS - 1; idx > 0; idx-- )
+    {
+        size_t other = bench_rand( &state ) % ( idx + 1 );
+        uint32_t temp = link_order[idx];
+        link_order[idx] = link_order[other];
+        link_order[other] = temp;
+    }
+
+    bench_list( false );
+    bench_list( true );
+    for( int method = 0; method < 3; method++ ) bench_array( method );
+
+    return 0;
+}
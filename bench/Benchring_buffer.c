@@ -0,0 +1,195 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>      // For sched_yield
+#include "bench.h"
+#include "ring_buffer.h"
+#include "ll.h"
+
+// Throughput of a FIFO queue of uint32_t items: the contiguous ring buffer against a queue of "ll_t" nodes (one node
+// per queued item, taken from and returned to a free list so that no allocation is timed).
+
+#ifndef NUM_ITEMS
+#define NUM_ITEMS   (1u << 24)
+#endif
+#define CAPACITY    1024
+#define BATCH       32
+
+typedef struct queue_node_t
+{
+    ll_t        node;
+    uint32_t    data;
+} queue_node_t;
+
+static uint32_t storage[CAPACITY];
+static queue_node_t nodes[CAPACITY];
+
+static void bench_ring_buffer( size_t batch )
+{
+    ring_buffer_t rb;
+    uint32_t in[BATCH], out[BATCH];
+    uint64_t sum = 0;
+    char name[64];
+
+    ring_buffer_init( &rb, storage, CAPACITY, sizeof(storage[0]) );
+
+    double start = bench_now();
+    for( uint32_t item = 0; item < NUM_ITEMS; item += batch )
+    {
+        for( size_t idx = 0; idx < batch; idx++ ) in[idx] = item + idx;
+        if( batch == 1 )
+        {
+            ring_buffer_push( &rb, in );
+            ring_buffer_pop( &rb, out );
+        }
+        else
+        {
+            ring_buffer_push_n( &rb, in, batch );
+            ring_buffer_pop_n( &rb, out, batch );
+        }
+        for( size_t idx = 0; idx < batch; idx++ ) sum += out[idx];
+    }
+    double elapsed = bench_now() - start;
+
+    snprintf( name, sizeof(name), batch == 1 ? "ring_buffer push/pop" : "ring_buffer push_n/pop_n (batch %zu)", batch );
+    bench_report( name, NUM_ITEMS, elapsed );
+    bench_sink = sum;
+}
+
+static void bench_ll_queue( size_t batch )
+{
+    LIST_INIT(free_list);
+    LIST_INIT(queue);
+    uint64_t sum = 0;
+    char name[64];
+
+    for( size_t idx = 0; idx < CAPACITY; idx++ ) list_add_tail( &nodes[idx].node, &free_list );
+
+    double start = bench_now();
+    for( uint32_t item = 0; item < NUM_ITEMS; item += batch )
+    {
+        for( size_t idx = 0; idx < batch; idx++ )
+        {
+            ll_t * node = free_list.next;
+            list_del( node );
+            ((queue_node_t *)node)->data = item + idx;
+            list_add_tail( node, &queue );
+        }
+        for( size_t idx = 0; idx < batch; idx++ )
+        {
+            ll_t * node = queue.next;
+            list_del( node );
+            sum += ((queue_node_t *)node)->data;
+            list_add( node, &free_list );
+        }
+    }
+    double elapsed = bench_now() - start;
+
+    snprintf( name, sizeof(name), "ll_t queue add_tail/del (batch %zu)", batch );
+    bench_report( name, NUM_ITEMS, elapsed );
+    bench_sink = sum;
+}
+
+// Two-thread versions: one producer and one consumer. The ring buffer uses the lock-free SPSC mode; the "ll_t" queue
+// has to be protected by a mutex.
+
+static ring_buffer_t spsc_rb;
+static pthread_mutex_t ll_lock = PTHREAD_MUTEX_INITIALIZER;
+static LIST_INIT(ll_free_list);
+static LIST_INIT(ll_queue);
+
+static void * spsc_producer( void * arg )
+{
+    uint32_t in[BATCH];
+
+    (void)arg;
+    for( uint32_t item = 0; item < NUM_ITEMS; )
+    {
+        for( size_t idx = 0; idx < BATCH; idx++ ) in[idx] = item + idx;
+        size_t pushed = 0;
+        while( pushed < BATCH )
+        {
+            size_t count = ring_buffer_spsc_push_n( &spsc_rb, in + pushed, BATCH - pushed );
+            if( count == 0 ) sched_yield();
+            pushed += count;
+        }
+        item += BATCH;
+    }
+
+    return NULL;
+}
+
+static void * ll_producer( void * arg )
+{
+    (void)arg;
+    for( uint32_t item = 0; item < NUM_ITEMS; )
+    {
+        uint32_t first = item;
+        pthread_mutex_lock( &ll_lock );
+        while( item < NUM_ITEMS && ll_free_list.next != &ll_free_list )
+        {
+            ll_t * node = ll_free_list.next;
+            list_del( node );
+            ((queue_node_t *)node)->data = item++;
+            list_add_tail( node, &ll_queue );
+        }
+        pthread_mutex_unlock( &ll_lock );
+        if( item == first ) sched_yield();
+    }
+
+    return NULL;
+}
+
+static void bench_threaded( bool use_ring_buffer )
+{
+    pthread_t producer;
+    uint64_t sum = 0;
+    uint32_t out[BATCH];
+
+    if( use_ring_buffer ) ring_buffer_init( &spsc_rb, storage, CAPACITY, sizeof(storage[0]) );
+    else for( size_t idx = 0; idx < CAPACITY; idx++ ) list_add_tail( &nodes[idx].node, &ll_free_list );
+
+    double start = bench_now();
+    pthread_create( &producer, NULL, use_ring_buffer ? spsc_producer : ll_producer, NULL );
+    for( uint32_t received = 0; received < NUM_ITEMS; )
+    {
+        if( use_ring_buffer )
+        {
+            size_t popped = ring_buffer_spsc_pop_n( &spsc_rb, out, BATCH );
+            if( popped == 0 ) sched_yield();
+            for( size_t idx = 0; idx < popped; idx++ ) sum += out[idx];
+            received += popped;
+        }
+        else
+        {
+            uint32_t first = received;
+            pthread_mutex_lock( &ll_lock );
+            while( ll_queue.next != &ll_queue )
+            {
+                ll_t * node = ll_queue.next;
+                list_del( node );
+                sum += ((queue_node_t *)node)->data;
+                list_add( node, &ll_free_list );
+                received++;
+            }
+            pthread_mutex_unlock( &ll_lock );
+            if( received == first ) sched_yield();
+        }
+    }
+    pthread_join( producer, NULL );
+    double elapsed = bench_now() - start;
+
+    bench_report( use_ring_buffer ? "ring_buffer SPSC, 2 threads (batch 32)" : "ll_t queue + mutex, 2 threads", NUM_ITEMS, elapsed );
+    bench_sink = sum;
+}
+
+int main(void)
+{
+    bench_ring_buffer( 1 );
+    bench_ll_queue( 1 );
+    bench_ring_buffer( BATCH );
+    bench_ll_queue( BATCH );
+    bench_threaded( true );
+    bench_threaded( false );
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include <stdlib.h>
+#include "bench.h"
+#include "array_methods.h"
+#include "linked_list_methods_EmbArt.h"
+#include "array_set_simd.h"
+
+// Intersecting sorted arrays of 32-bit IDs: an "array_find" per ID (quadratic, so on short arrays only), against
+// "array_set_intersect" and the typed kernels in "array_set_simd.h" (scalar, SSE2, AVX2). Both for two arrays of
+// similar size, where about half of the IDs are shared, and for a short array against a long one, where
+// "array_set_intersect" gallops. Also union and difference, and the same intersection on "ll_t" lists.
+
+#ifndef NUM_IDS
+#define NUM_IDS         (1u << 20)
+#endif
+#define NUM_FEW         1024
+#define NUM_FIND        8192
+
+typedef struct id_node_t
+{
+    ll_t        node;
+    uint32_t    id;
+} id_node_t;
+
+static int compare_ids( const void * item_one, const void * item_two )
+{
+    uint32_t one = *(const uint32_t *)item_one, two = *(const uint32_t *)item_two;
+    return ( one > two ) - ( one < two );
+}
+
+static int compare_id_nodes( const void * item_one, const void * item_two )
+{
+    uint32_t one = ((const id_node_t *)item_one)->id, two = ((const id_node_t *)item_two)->id;
+    return ( one > two ) - ( one < two );
+}
+
+// Fills "ids" with "num" strictly increasing IDs, each about "gap" more than the last on average.
+//
+static void make_ids( uint32_t * ids, size_t num, uint32_t gap, uint64_t * state )
+{
+    uint32_t id = 0;
+
+    for( size_t idx = 0; idx < num; idx++ )
+    {
+        id += 1 + bench_rand( state ) % ( 2 * gap - 1 );
+        ids[idx] = id;
+    }
+}
+
+static void report( const char * name, size_t num, size_t count, double seconds )
+{
+    char label[96];
+
+    snprintf( label, sizeof(label), "%s (%zu matches)", name, count );
+    bench_report( label, num, seconds );
+}
+
+static void run_intersections( const char * what, const uint32_t * one, size_t num_one, const uint32_t * two, size_t num_two, uint32_t * out )
+{
+    char name[96];
+    size_t count;
+
+    double start = bench_now();
+    count = array_set_intersect( one, num_one, two, num_two, sizeof(one[0]), out, compare_ids );
+    snprintf( name, sizeof(name), "%s array_set_intersect", what );
+    report( name, num_one + num_two, count, bench_now() - start );
+
+    start = bench_now();
+    count = array_set_intersect_u32_scalar( one, num_one, two, num_two, out );
+    snprintf( name, sizeof(name), "%s _u32_scalar", what );
+    report( name, num_one + num_two, count, bench_now() - start );
+
+#if ARRAY_SET_SIMD
+    start = bench_now();
+    count = array_set_intersect_u32_sse2( one, num_one, two, num_two, out );
+    snprintf( name, sizeof(name), "%s _u32_sse2", what );
+    report( name, num_one + num_two, count, bench_now() - start );
+
+    if( __builtin_cpu_supports( "avx2" ) )
+    {
+        start = bench_now();
+        count = array_set_intersect_u32_avx2( one, num_one, two, num_two, out );
+        snprintf( name, sizeof(name), "%s _u32_avx2", what );
+        report( name, num_one + num_two, count, bench_now() - start );
+    }
+#endif
+}
+
+int main( void )
+{
+    uint32_t * one = malloc( NUM_IDS * sizeof(uint32_t) ), * two = malloc( NUM_IDS * sizeof(uint32_t) );
+    uint32_t * few = malloc( NUM_FEW * sizeof(uint32_t) ), * out = malloc( 2 * NUM_IDS * sizeof(uint32_t) );
+    id_node_t * nodes_one = malloc( NUM_IDS * sizeof(id_node_t) ), * nodes_two = malloc( NUM_IDS * sizeof(id_node_t) );
+    uint64_t state = 88172645463325252ULL, sum = 0;
+    LIST_INIT(head);
+    LIST_INIT(other);
+    size_t count;
+
+    make_ids( one, NUM_IDS, 2, &state );
+    make_ids( two, NUM_IDS, 2, &state );
+    make_ids( few, NUM_FEW, 2 * NUM_IDS / NUM_FEW, &state );
+    memset( out, 0, 2 * NUM_IDS * sizeof(uint32_t) );
+
+    double start = bench_now();
+    count = 0;
+    for( size_t idx = 0; idx < NUM_FIND; idx++ )
+    {
+        if( array_find( &one[idx], two, NUM_FIND, sizeof(two[0]), compare_ids ) >= 0 ) out[count++] = one[idx];
+    }
+    report( "array_find per ID (8K x 8K)", 2 * NUM_FIND, count, bench_now() - start );
+    sum += count;
+
+    run_intersections( "1M x 1M", one, NUM_IDS, two, NUM_IDS, out );
+    run_intersections( "1K x 1M", few, NUM_FEW, two, NUM_IDS, out );
+
+    start = bench_now();
+    count = array_set_union( one, NUM_IDS, two, NUM_IDS, sizeof(one[0]), out, compare_ids );
+    report( "1M x 1M array_set_union", 2 * NUM_IDS, count, bench_now() - start );
+    sum += count;
+
+    start = bench_now();
+    count = array_set_difference( one, NUM_IDS, two, NUM_IDS, sizeof(one[0]), out, compare_ids );
+    report( "1M x 1M array_set_difference", 2 * NUM_IDS, count, bench_now() - start );
+    sum += count;
+
+    for( size_t idx = 0; idx < NUM_IDS; idx++ )
+    {
+        nodes_one[idx].id = one[idx];
+        list_add_tail( &nodes_one[idx].node, &head );
+        nodes_two[idx].id = two[idx];
+        list_add_tail( &nodes_two[idx].node, &other );
+    }
+    start = bench_now();
+    linked_list_set_intersect( &head, &other, NULL, compare_id_nodes );
+    bench_report( "1M x 1M linked_list_set_intersect", 2 * NUM_IDS, bench_now() - start );
+    sum += ((id_node_t *)head.next)->id;
+
+    free( one );
+    free( two );
+    free( few );
+    free( out );
+    free( nodes_one );
+    free( nodes_two );
+    bench_sink = sum;
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include <stdlib.h>
+#include "bench.h"
+#include "parallel_sort.h"
+
+// Scaling of "array_sort_par" and "linked_list_sort_par" with the number of threads, against the single-threaded
+// "qsort", "array_stable_sort", and "linked_list_merge_sort". Speedup is limited by the number of CPUs available.
+
+#ifndef NUM_ITEMS
+#define NUM_ITEMS   (1u << 22)
+#endif
+
+typedef struct node_t
+{
+    ll_t        node;
+    uint64_t    key;
+} node_t;
+
+static uint64_t input[NUM_ITEMS], work[NUM_ITEMS];
+static node_t nodes[NUM_ITEMS];
+
+static int compare_u64( const void * item_one, const void * item_two )
+{
+    uint64_t one = *(const uint64_t *)item_one, two = *(const uint64_t *)item_two;
+    return ( two < one ) - ( one < two );
+}
+
+static int compare_nodes( const void * item_one, const void * item_two )
+{
+    uint64_t one = ((const node_t *)item_one)->key, two = ((const node_t *)item_two)->key;
+    return ( two < one ) - ( one < two );
+}
+
+static void bench_array( const char * name, int method, size_t num_threads )
+{
+    char label[64];
+
+    memcpy( work, input, sizeof(work) );
+
+    double start = bench_now();
+    switch( method )
+    {
+        case 0: qsort( work, NUM_ITEMS, sizeof(work[0]), compare_u64 ); break;
+        case 1: array_stable_sort( work, NUM_ITEMS, sizeof(work[0]), compare_u64 ); break;
+        case 2: array_sort_par( work, NUM_ITEMS, sizeof(work[0]), compare_u64, num_threads ); break;
+    }
+    double elapsed = bench_now() - start;
+
+    if( method == 2 ) snprintf( label, sizeof(label), "%s (%zu threads)", name, num_threads );
+    else snprintf( label, sizeof(label), "%s", name );
+    bench_report( label, NUM_ITEMS, elapsed );
+    bench_sink = work[NUM_ITEMS / 2];
+}
+
+static void bench_list( size_t num_threads )
+{
+    LIST_INIT(head);
+    char label[64];
+
+    for( size_t idx = 0; idx < NUM_ITEMS; idx++ )
+    {
+        nodes[idx].key = input[idx];
+        list_add_tail( &nodes[idx].node, &head );
+    }
+
+    double start = bench_now();
+    if( num_threads == 0 ) linked_list_merge_sort( &head, compare_nodes );
+    else linked_list_sort_par( &head, compare_nodes, num_threads );
+    double elapsed = bench_now() - start;
+
+    if( num_threads == 0 ) snprintf( label, sizeof(label), "linked_list_merge_sort" );
+    else snprintf( label, sizeof(label), "linked_list_sort_par (%zu threads)", num_threads );
+    bench_report( label, NUM_ITEMS, elapsed );
+    bench_sink = ((node_t *)head.next)->key;
+}
+
+int main( void )
+{
+    static const size_t threads[] = { 1, 2, 4, 8 };
+    uint64_t state = 88172645463325252ULL;
+
+    for( size_t idx = 0; idx < NUM_ITEMS; idx++ ) input[idx] = bench_rand( &state );
+
+    printf( "(%ld CPUs online)\n", sysconf( _SC_NPROCESSORS_ONLN ) );
+
+    bench_array( "qsort", 0, 1 );
+    bench_array( "array_stable_sort", 1, 1 );
+    for( size_t idx = 0; idx < LEN_ARRAY(threads); idx++ ) bench_array( "array_sort_par", 2, threads[idx] );
+
+    bench_list( 0 );
+    for( size_t idx = 0; idx < LEN_ARRAY(threads); idx++ ) bench_list( threads[idx] );
+
+    return 0;
+}
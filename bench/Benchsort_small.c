@@ -0,0 +1,80 @@
+#include <stdlib.h>
+#include <string.h>     // For memcpy
+#include "bench.h"
+#include "array_sort_small.h"
+
+// Sorting many tiny arrays of uint32_t: "qsort", a plain insertion sort on uint32_t, the generic "array_sort_small"
+// (network through a compare function), and the typed "array_sort_small_u32" (branch-free network).
+
+#ifndef NUM_ITEMS
+#define NUM_ITEMS   (1u << 24)
+#endif
+
+static uint32_t input[NUM_ITEMS], work[NUM_ITEMS];
+
+static int compare_u32( const void * item_one, const void * item_two )
+{
+    uint32_t one = *(const uint32_t *)item_one, two = *(const uint32_t *)item_two;
+    return ( two < one ) - ( one < two );
+}
+
+static void insertion_sort_u32( uint32_t * base, size_t num )
+{
+    for( size_t idx = 1; idx < num; idx++ )
+    {
+        uint32_t value = base[idx];
+        size_t pos = idx;
+        while( pos > 0 && base[pos - 1] > value )
+        {
+            base[pos] = base[pos - 1];
+            pos--;
+        }
+        base[pos] = value;
+    }
+}
+
+enum { QSORT, INSERTION, NETWORK_COMPARE, NETWORK_TYPED };
+
+static void bench_sort( int method, size_t num )
+{
+    static const char * names[] = { "qsort", "insertion sort", "array_sort_small", "array_sort_small_u32" };
+    size_t arrays = NUM_ITEMS / num;
+    uint64_t sum = 0;
+    char name[64];
+
+    memcpy( work, input, sizeof(work) );
+
+    double start = bench_now();
+    for( size_t array = 0; array < arrays; array++ )
+    {
+        uint32_t * base = work + array * num;
+        switch( method )
+        {
+            case QSORT:             qsort( base, num, sizeof(uint32_t), compare_u32 ); break;
+            case INSERTION:         insertion_sort_u32( base, num ); break;
+            case NETWORK_COMPARE:   array_sort_small( base, num, sizeof(uint32_t), compare_u32 ); break;
+            case NETWORK_TYPED:     array_sort_small_u32( base, num ); break;
+        }
+        sum += base[num / 2];
+    }
+    double elapsed = bench_now() - start;
+
+    snprintf( name, sizeof(name), "%s (%zu elements)", names[method], num );
+    bench_report( name, arrays * num, elapsed );
+    bench_sink = sum;
+}
+
+int main( void )
+{
+    static const size_t lengths[] = { 4, 8, 16, 32 };
+    uint64_t state = 88172645463325252ULL;
+
+    for( size_t idx = 0; idx < NUM_ITEMS; idx++ ) input[idx] = (uint32_t)bench_rand( &state );
+
+    for( size_t length = 0; length < sizeof(lengths) / sizeof(lengths[0]); length++ )
+    {
+        for( int method = QSORT; method <= NETWORK_TYPED; method++ ) bench_sort( method, lengths[length] );
+    }
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include <stdlib.h>
+#include "bench.h"
+#include "linked_list_methods_EmbArt.h"
+
+// Inserting timestamped samples into a sorted list: "linked_list_sorted_insert" (which walks from the front, so on a
+// shorter list) against "linked_list_sorted_insert_hint" with the previous sample as the finger. Timestamps arrive in
+// order, nearly in order (each one up to a few samples late), and in random order. Also sorting a list that's nearly
+// in order with "linked_list_insertion_sort" (shorter list), "linked_list_adaptive_insertion_sort" and
+// "linked_list_merge_sort".
+
+#ifndef NUM_SAMPLES
+#define NUM_SAMPLES     (1u << 20)
+#endif
+#define NUM_FEW         8192
+#define JITTER          64      // Timestamps are up to this much late, with samples 16 apart
+
+typedef struct sample_t
+{
+    ll_t        node;
+    uint64_t    timestamp;
+} sample_t;
+
+static int compare_timestamps( const void * item_one, const void * item_two )
+{
+    uint64_t one = ((const sample_t *)item_one)->timestamp, two = ((const sample_t *)item_two)->timestamp;
+    return ( one > two ) - ( one < two );
+}
+
+enum { IN_ORDER, NEARLY_IN_ORDER, RANDOM };
+
+static void make_samples( sample_t * samples, size_t num, int order )
+{
+    uint64_t state = 88172645463325252ULL;
+
+    for( size_t idx = 0; idx < num; idx++ )
+    {
+        if( order == IN_ORDER ) samples[idx].timestamp = idx * 16;
+        else if( order == NEARLY_IN_ORDER ) samples[idx].timestamp = idx * 16 + bench_rand( &state ) % JITTER;
+        else samples[idx].timestamp = bench_rand( &state ) % ( num * 16 );
+    }
+}
+
+static void make_list( ll_t * head, sample_t * samples, size_t num )
+{
+    head->next = head->prev = head;
+    for( size_t idx = 0; idx < num; idx++ ) list_add_tail( &samples[idx].node, head );
+}
+
+static void run_inserts( const char * what, sample_t * samples, size_t num, int order, bool plain )
+{
+    char name[96];
+    LIST_INIT(head);
+    ll_t * finger = NULL;
+
+    make_samples( samples, num, order );
+    if( plain )
+    {
+        double start = bench_now();
+        for( size_t idx = 0; idx < num; idx++ ) linked_list_sorted_insert( &head, &samples[idx].node, compare_timestamps );
+        snprintf( name, sizeof(name), "%s linked_list_sorted_insert", what );
+        bench_report( name, num, bench_now() - start );
+        head.next = head.prev = &head;
+    }
+
+    double start = bench_now();
+    for( size_t idx = 0; idx < num; idx++ ) finger = linked_list_sorted_insert_hint( &head, &samples[idx].node, finger, compare_timestamps );
+    snprintf( name, sizeof(name), "%s _sorted_insert_hint", what );
+    bench_report( name, num, bench_now() - start );
+    bench_sink += ((sample_t *)head.prev)->timestamp;
+}
+
+int main( void )
+{
+    sample_t * samples = malloc( NUM_SAMPLES * sizeof(sample_t) );
+    LIST_INIT(head);
+
+    memset( samples, 0, NUM_SAMPLES * sizeof(sample_t) );
+
+    run_inserts( "8K in order", samples, NUM_FEW, IN_ORDER, true );
+    run_inserts( "1M in order", samples, NUM_SAMPLES, IN_ORDER, false );
+    run_inserts( "8K nearly in order", samples, NUM_FEW, NEARLY_IN_ORDER, true );
+    run_inserts( "1M nearly in order", samples, NUM_SAMPLES, NEARLY_IN_ORDER, false );
+    run_inserts( "8K random", samples, NUM_FEW, RANDOM, true );
+
+    make_samples( samples, NUM_FEW, NEARLY_IN_ORDER );
+    make_list( &head, samples, NUM_FEW );
+    double start = bench_now();
+    linked_list_insertion_sort( &head, compare_timestamps );
+    bench_report( "8K nearly in order linked_list_insertion_sort", NUM_FEW, bench_now() - start );
+
+    make_list( &head, samples, NUM_FEW );
+    start = bench_now();
+    linked_list_adaptive_insertion_sort( &head, compare_timestamps );
+    bench_report( "8K nearly in order _adaptive_insertion_sort", NUM_FEW, bench_now() - start );
+
+    make_samples( samples, NUM_SAMPLES, NEARLY_IN_ORDER );
+    make_list( &head, samples, NUM_SAMPLES );
+    start = bench_now();
+    linked_list_adaptive_insertion_sort( &head, compare_timestamps );
+    bench_report( "1M nearly in order _adaptive_insertion_sort", NUM_SAMPLES, bench_now() - start );
+
+    make_list( &head, samples, NUM_SAMPLES );
+    start = bench_now();
+    linked_list_merge_sort( &head, compare_timestamps );
+    bench_report( "1M nearly in order linked_list_merge_sort", NUM_SAMPLES, bench_now() - start );
+    bench_sink += ((sample_t *)head.next)->timestamp;
+
+    free( samples );
+
+    return 0;
+}
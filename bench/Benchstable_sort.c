@@ -0,0 +1,92 @@
+#include <stdlib.h>
+#include "bench.h"
+#include "array_methods.h"
+
+// "qsort" against "array_stable_sort" on 16-byte records keyed by a timestamp, for inputs with different amounts of
+// existing order.
+
+#ifndef NUM_ITEMS
+#define NUM_ITEMS   (1u << 20)
+#endif
+
+typedef struct record_t
+{
+    uint64_t    timestamp;
+    uint64_t    id;
+} record_t;
+
+static record_t input[NUM_ITEMS], work[NUM_ITEMS], scratch[NUM_ITEMS / 2];
+
+static int compare_records( const void * item_one, const void * item_two )
+{
+    uint64_t one = ((const record_t *)item_one)->timestamp, two = ((const record_t *)item_two)->timestamp;
+    return ( two < one ) - ( one < two );
+}
+
+enum { SORTED, REVERSED, SWAPPED, JITTERED, APPENDED, RANDOM };
+
+static void make_input( int shape )
+{
+    uint64_t state = 88172645463325252ULL;
+
+    for( size_t idx = 0; idx < NUM_ITEMS; idx++ )
+    {
+        switch( shape )
+        {
+            case SORTED:    input[idx].timestamp = idx; break;
+            case REVERSED:  input[idx].timestamp = NUM_ITEMS - idx; break;
+            case SWAPPED:   input[idx].timestamp = idx; break;
+            case JITTERED:  input[idx].timestamp = idx * 16 + bench_rand( &state ) % 64; break;    // Arrives a little out of order
+            case APPENDED:  input[idx].timestamp = idx < NUM_ITEMS - NUM_ITEMS / 16 ? idx * 2 : bench_rand( &state ) % ( 2 * NUM_ITEMS ); break;
+            case RANDOM:    input[idx].timestamp = bench_rand( &state ); break;
+        }
+        input[idx].id = idx;
+    }
+
+    // 1% of the elements swapped with another random element.
+    //
+    if( shape == SWAPPED )
+    {
+        for( size_t count = 0; count < NUM_ITEMS / 100; count++ )
+        {
+            size_t one = bench_rand( &state ) % NUM_ITEMS, two = bench_rand( &state ) % NUM_ITEMS;
+            record_t temp = input[one];
+            input[one] = input[two];
+            input[two] = temp;
+        }
+    }
+}
+
+static void bench_sort( const char * shape_name, int method )
+{
+    static const char * names[] = { "qsort", "array_stable_sort", "array_stable_sort_with_scratch" };
+    char name[80];
+
+    memcpy( work, input, sizeof(work) );
+
+    double start = bench_now();
+    switch( method )
+    {
+        case 0: qsort( work, NUM_ITEMS, sizeof(record_t), compare_records ); break;
+        case 1: array_stable_sort( work, NUM_ITEMS, sizeof(record_t), compare_records ); break;
+        case 2: array_stable_sort_with_scratch( work, NUM_ITEMS, sizeof(record_t), scratch, compare_records ); break;
+    }
+    double elapsed = bench_now() - start;
+
+    snprintf( name, sizeof(name), "%s (%s)", names[method], shape_name );
+    bench_report( name, NUM_ITEMS, elapsed );
+    bench_sink = work[NUM_ITEMS / 2].id;
+}
+
+int main( void )
+{
+    static const char * shapes[] = { "sorted", "reversed", "1% swapped", "jittered", "6% appended", "random" };
+
+    for( int shape = SORTED; shape <= RANDOM; shape++ )
+    {
+        make_input( shape );
+        for( int method = 0; method < 3; method++ ) bench_sort( shapes[shape], method );
+    }
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include <stdlib.h>
+#include "bench.h"
+#include "array_methods.h"
+#include "linked_list_methods_EmbArt.h"
+#include "timer_wheel.h"
+
+// "timer_wheel_t" against a single "ll_t" list of timers kept in order with "linked_list_sorted_insert", the way
+// firmware often does it: each tick, the list is checked from the front for expired timers. Every timer is periodic
+// (re-armed with its own period, between 1 and 4096 ticks, when it expires) and, on each tick, a few timers chosen at
+// random are "kicked" (re-armed before they expire, like a watchdog or an idle timeout being reset), which is where
+// the sorted list spends its time.
+
+#ifndef NUM_TICKS
+#define NUM_TICKS       (1u << 16)
+#endif
+#define KICKS_PER_TICK  4
+#define MAX_PERIOD      4096
+
+typedef struct soft_timer_t
+{
+    timer_node_t    node;
+    uint64_t        period;
+} soft_timer_t;
+
+static int compare_expires( const void * item_one, const void * item_two )
+{
+    uint64_t one = ((const timer_node_t *)item_one)->expires, two = ((const timer_node_t *)item_two)->expires;
+    return ( two < one ) - ( one < two );
+}
+
+static void make_timers( soft_timer_t * timers, size_t num )
+{
+    uint64_t state = 88172645463325252ULL;
+
+    for( size_t idx = 0; idx < num; idx++ )
+    {
+        timer_init( &timers[idx].node );
+        timers[idx].period = 1 + bench_rand( &state ) % MAX_PERIOD;
+    }
+}
+
+static uint64_t run_sorted_list( soft_timer_t * timers, size_t num, size_t num_ticks )
+{
+    uint64_t state = 1, fired = 0;
+    LIST_INIT(head);
+
+    for( size_t idx = 0; idx < num; idx++ )
+    {
+        timers[idx].node.expires = timers[idx].period;
+        linked_list_sorted_insert( &head, &timers[idx].node.list, compare_expires );
+    }
+
+    for( uint64_t now = 1; now <= num_ticks; now++ )
+    {
+        while( !list_empty( &head ) && ((timer_node_t *)head.next)->expires <= now )
+        {
+            soft_timer_t * timer = (soft_timer_t *)head.next;
+            list_del( &timer->node.list );
+            timer->node.expires = now + timer->period;
+            linked_list_sorted_insert( &head, &timer->node.list, compare_expires );
+            fired++;
+        }
+        for( int kick = 0; kick < KICKS_PER_TICK; kick++ )
+        {
+            soft_timer_t * timer = &timers[bench_rand( &state ) % num];
+            list_del( &timer->node.list );
+            timer->node.expires = now + timer->period;
+            linked_list_sorted_insert( &head, &timer->node.list, compare_expires );
+        }
+    }
+
+    return fired;
+}
+
+static uint64_t run_timer_wheel( soft_timer_t * timers, size_t num, size_t num_ticks )
+{
+    static timer_wheel_t wheel;
+    uint64_t state = 1, fired = 0;
+    LIST_INIT(expired);
+
+    timer_wheel_init( &wheel, 1 );
+    for( size_t idx = 0; idx < num; idx++ )
+    {
+        timer_init( &timers[idx].node );
+        timer_wheel_arm( &wheel, &timers[idx].node, timers[idx].period );
+    }
+
+    for( uint64_t now = 1; now <= num_ticks; now++ )
+    {
+        timer_wheel_advance( &wheel, now, &expired );
+        while( !list_empty( &expired ) )
+        {
+            soft_timer_t * timer = (soft_timer_t *)expired.next;
+            timer_wheel_arm( &wheel, &timer->node, now + timer->period );
+            fired++;
+        }
+        for( int kick = 0; kick < KICKS_PER_TICK; kick++ )
+        {
+            soft_timer_t * timer = &timers[bench_rand( &state ) % num];
+            timer_wheel_arm( &wheel, &timer->node, now + timer->period );
+        }
+    }
+
+    return fired;
+}
+
+int main( void )
+{
+    static const size_t counts[] = { 256, 4096, 65536 };
+    uint64_t sum = 0;
+    char name[64];
+
+    for( size_t idx = 0; idx < LEN_ARRAY(counts); idx++ )
+    {
+        soft_timer_t * timers = malloc( counts[idx] * sizeof(soft_timer_t) );
+        double start;
+
+        // Every insert walks the list, so the sorted list gets fewer ticks with more timers, and is left out for the
+        // most.
+        //
+        if( counts[idx] <= 4096 )
+        {
+            size_t ticks = NUM_TICKS * 256 / counts[idx];
+
+            make_timers( timers, counts[idx] );
+            start = bench_now();
+            sum += run_sorted_list( timers, counts[idx], ticks );
+            snprintf( name, sizeof(name), "sorted ll_t, %zu timers (ticks)", counts[idx] );
+            bench_report( name, ticks, bench_now() - start );
+        }
+
+        make_timers( timers, counts[idx] );
+        start = bench_now();
+        sum += run_timer_wheel( timers, counts[idx], NUM_TICKS );
+        snprintf( name, sizeof(name), "timer_wheel, %zu timers (ticks)", counts[idx] );
+        bench_report( name, NUM_TICKS, bench_now() - start );
+
+        free( timers );
+    }
+
+    bench_sink = sum;
+
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include <stdlib.h>
+#include "bench.h"
+#include "array_methods.h"
+#include "linked_list_methods_EmbArt.h"
+#include "tlist.h"
+
+// The typed "tlist.h" macros, whose comparisons and predicates are inlined expressions, against the "ll_t" functions
+// in "linked_list_methods_EmbArt.h", which call a function pointer per element. Both lists hold the same values in
+// nodes of the same size, allocated alternately so that their layouts in memory match.
+
+#ifndef NUM_ITEMS
+#define NUM_ITEMS       (1u << 20)
+#endif
+#define NUM_INSERTS     8192
+
+typedef struct node_t
+{
+    ll_t        node;
+    uint64_t    data;
+} node_t;
+
+TLISTDEF(uint64_t, tlist_t);
+
+static bool is_odd_node( const void * elem )
+{
+    return ((const node_t *)elem)->data & 1;
+}
+
+static int compare_nodes( const void * item_one, const void * item_two )
+{
+    uint64_t one = ((const node_t *)item_one)->data, two = ((const node_t *)item_two)->data;
+    return ( two < one ) - ( one < two );
+}
+
+static void free_nodes( ll_t * head )
+{
+    ll_t * node, * copy;
+    list_for_each_safe( node, copy, head ) free( node );
+    head->next = head->prev = head;
+}
+
+int main( void )
+{
+    uint64_t state = 88172645463325252ULL, sum = 0;
+    LIST_INIT(head);
+    LIST_INIT(removed);
+    tlist_t tlist;
+    void * min, * max;
+    TLISTITER(tlist) tmin, tmax;
+
+    TLISTINIT(tlist);
+    for( size_t idx = 0; idx < NUM_ITEMS; idx++ )
+    {
+        node_t * node = malloc( sizeof(node_t) );
+        node->data = bench_rand( &state ) >> 32;
+        list_add_tail( &node->node, &head );
+        TLISTPUSHBACK( tlist, node->data );
+    }
+
+    double start = bench_now();
+    sum += linked_list_count( &head, is_odd_node );
+    bench_report( "linked_list_count", NUM_ITEMS, bench_now() - start );
+
+    start = bench_now();
+    sum += TLISTCOUNT( i, tlist, i->_data & 1 );
+    bench_report( "TLISTCOUNT", NUM_ITEMS, bench_now() - start );
+
+    start = bench_now();
+    linked_list_find_minmax( &head, &min, &max, compare_nodes );
+    bench_report( "linked_list_find_minmax", NUM_ITEMS, bench_now() - start );
+    sum += ((node_t *)min)->data + ((node_t *)max)->data;
+
+    start = bench_now();
+    TLISTMINMAX( a, b, tlist, a->_data < b->_data, tmin, tmax );
+    bench_report( "TLISTMINMAX", NUM_ITEMS, bench_now() - start );
+    sum += tmin->_data + tmax->_data;
+
+    start = bench_now();
+    linked_list_reverse( &head );
+    bench_report( "linked_list_reverse", NUM_ITEMS, bench_now() - start );
+
+    start = bench_now();
+    TLISTREVERSE( tlist );
+    bench_report( "TLISTREVERSE", NUM_ITEMS, bench_now() - start );
+
+    start = bench_now();
+    linked_list_merge_sort( &head, compare_nodes );
+    bench_report( "linked_list_merge_sort", NUM_ITEMS, bench_now() - start );
+
+    start = bench_now();
+    TLISTSORT( a, b, tlist, a->_data < b->_data );
+    bench_report( "TLISTSORT", NUM_ITEMS, bench_now() - start );
+    sum += ((node_t *)head.next)->data + TLISTBEGIN(tlist)->_data;
+
+    // The "ll_t" filter leaves freeing the removed nodes to the caller; "TLISTFILTER" frees them itself.
+    //
+    start = bench_now();
+    sum += linked_list_filter_in_place( &head, &removed, is_odd_node );
+    free_nodes( &removed );
+    bench_report( "linked_list_filter_in_place + free", NUM_ITEMS, bench_now() - start );
+
+    start = bench_now();
+    sum += TLISTFILTER( i, tlist, i->_data & 1 );
+    bench_report( "TLISTFILTER", NUM_ITEMS, bench_now() - start );
+
+    free_nodes( &head );
+    TLISTCLEAR( tlist );
+
+    // Building a sorted list one random value at a time, which is quadratic, so on a shorter list.
+    //
+    uint64_t * inserts = malloc( NUM_INSERTS * sizeof(uint64_t) );
+    for( size_t idx = 0; idx < NUM_INSERTS; idx++ ) inserts[idx] = bench_rand( &state ) >> 32;
+
+    start = bench_now();
+    for( size_t idx = 0; idx < NUM_INSERTS; idx++ )
+    {
+        node_t * node = malloc( sizeof(node_t) );
+        node->data = inserts[idx];
+        linked_list_sorted_insert( &head, &node->node, compare_nodes );
+    }
+    bench_report( "linked_list_sorted_insert", NUM_INSERTS, bench_now() - start );
+
+    start = bench_now();
+    for( size_t idx = 0; idx < NUM_INSERTS; idx++ ) TLISTSORTEDINSERT( a, b, tlist, a->_data < b->_data, inserts[idx] );
+    bench_report( "TLISTSORTEDINSERT", NUM_INSERTS, bench_now() - start );
+    sum += ((node_t *)head.prev)->data + TLISTEND(tlist)->_prev->_data;
+
+    free_nodes( &head );
+    TLISTCLEAR( tlist );
+    free( inserts );
+
+    bench_sink = sum;
+
+    return 0;
+}
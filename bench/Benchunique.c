@@ -0,0 +1,141 @@
+#include <stdlib.h>
+#include "bench.h"
+#include "array_methods.h"
+#include "linked_list_methods_EmbArt.h"
+
+// Deduplicating event IDs (about half of them repeats): "qsort" followed by the usual compaction loop, against "qsort"
+// followed by "array_unique_sorted", and "array_unique_hash" (which keeps the original order and doesn't sort). For
+// lists, a "linked_list_find" per node (quadratic, so on a shorter list) against "linked_list_unique" with a hash
+// function, and "linked_list_unique" on a list that's already sorted.
+
+#ifndef NUM_IDS
+#define NUM_IDS         (1u << 20)
+#endif
+#define NUM_LIST_IDS    8192
+
+typedef struct event_t
+{
+    ll_t        node;
+    uint64_t    id;
+} event_t;
+
+static int compare_ids( const void * item_one, const void * item_two )
+{
+    uint64_t one = *(const uint64_t *)item_one, two = *(const uint64_t *)item_two;
+    return ( one > two ) - ( one < two );
+}
+
+static uint64_t hash_id( const void * elem )
+{
+    return *(const uint64_t *)elem;
+}
+
+static int compare_events( const void * item_one, const void * item_two )
+{
+    uint64_t one = ((const event_t *)item_one)->id, two = ((const event_t *)item_two)->id;
+    return ( one > two ) - ( one < two );
+}
+
+static uint64_t hash_event( const void * elem )
+{
+    return ((const event_t *)elem)->id;
+}
+
+static void make_ids( uint64_t * ids, size_t num )
+{
+    uint64_t state = 88172645463325252ULL;
+
+    for( size_t idx = 0; idx < num; idx++ ) ids[idx] = bench_rand( &state ) % ( num / 2 );
+}
+
+static void make_list( ll_t * head, event_t * events, const uint64_t * ids, size_t num )
+{
+    head->next = head->prev = head;
+    for( size_t idx = 0; idx < num; idx++ )
+    {
+        events[idx].id = ids[idx];
+        list_add_tail( &events[idx].node, head );
+    }
+}
+
+int main( void )
+{
+    uint64_t * ids = malloc( NUM_IDS * sizeof(uint64_t) ), sum = 0;
+    event_t * events = malloc( NUM_IDS * sizeof(event_t) );
+    LIST_INIT(head);
+    LIST_INIT(removed);
+    size_t count;
+
+    make_ids( ids, NUM_IDS );
+    double start = bench_now();
+    qsort( ids, NUM_IDS, sizeof(ids[0]), compare_ids );
+    count = 1;
+    for( size_t idx = 1; idx < NUM_IDS; idx++ )
+    {
+        if( ids[idx] != ids[count - 1] ) ids[count++] = ids[idx];
+    }
+    bench_report( "qsort + compaction loop", NUM_IDS, bench_now() - start );
+    sum += count;
+
+    make_ids( ids, NUM_IDS );
+    start = bench_now();
+    qsort( ids, NUM_IDS, sizeof(ids[0]), compare_ids );
+    sum += array_unique_sorted( ids, NUM_IDS, sizeof(ids[0]), compare_ids, NULL );
+    bench_report( "qsort + array_unique_sorted", NUM_IDS, bench_now() - start );
+
+    make_ids( ids, NUM_IDS );
+    qsort( ids, NUM_IDS, sizeof(ids[0]), compare_ids );
+    start = bench_now();
+    sum += array_unique_sorted( ids, NUM_IDS, sizeof(ids[0]), compare_ids, NULL );
+    bench_report( "array_unique_sorted alone", NUM_IDS, bench_now() - start );
+
+    make_ids( ids, NUM_IDS );
+    start = bench_now();
+    sum += array_unique_hash( ids, NUM_IDS, sizeof(ids[0]), hash_id, compare_ids, NULL );
+    bench_report( "array_unique_hash", NUM_IDS, bench_now() - start );
+
+    // Lists. The "linked_list_find" version checks each node against the nodes kept so far.
+    //
+    make_ids( ids, NUM_LIST_IDS );
+    make_list( &head, events, ids, NUM_LIST_IDS );
+    start = bench_now();
+    {
+        LIST_INIT(kept);
+        ll_t * node, * copy;
+
+        list_for_each_safe( node, copy, &head )
+        {
+            list_del( node );
+            if( linked_list_find( node, &kept, compare_events ) ) list_add_tail( node, &removed );
+            else list_add_tail( node, &kept );
+        }
+        list_splice( &kept, &head );
+    }
+    bench_report( "linked_list_find per node", NUM_LIST_IDS, bench_now() - start );
+
+    make_list( &head, events, ids, NUM_LIST_IDS );
+    removed.next = removed.prev = &removed;
+    start = bench_now();
+    sum += linked_list_unique( &head, &removed, hash_event, compare_events );
+    bench_report( "linked_list_unique (hash)", NUM_LIST_IDS, bench_now() - start );
+
+    make_ids( ids, NUM_IDS );
+    make_list( &head, events, ids, NUM_IDS );
+    removed.next = removed.prev = &removed;
+    start = bench_now();
+    sum += linked_list_unique( &head, &removed, hash_event, compare_events );
+    bench_report( "linked_list_unique (hash)", NUM_IDS, bench_now() - start );
+
+    qsort( ids, NUM_IDS, sizeof(ids[0]), compare_ids );
+    make_list( &head, events, ids, NUM_IDS );
+    removed.next = removed.prev = &removed;
+    start = bench_now();
+    sum += linked_list_unique( &head, &removed, NULL, compare_events );
+    bench_report( "linked_list_unique (sorted, no hash)", NUM_IDS, bench_now() - start );
+
+    free( ids );
+    free( events );
+    bench_sink = sum;
+
+    return 0;
+}
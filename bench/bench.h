@@ -0,0 +1,43 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>       // For clock_gettime
+
+// Shared helpers for the benchmarks in this directory. Each "Bench*.c" file is a standalone program built and run by
+// "make bench"; results are written to "build/results/Bench*.txt".
+
+// Returns a monotonic timestamp in seconds.
+//
+static inline double bench_now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Prints one row of results: the name of what was measured, the number of items it processed, and how long it took.
+//
+static inline void bench_report( const char * name, size_t items, double seconds )
+{
+    printf( "%-48s %12zu items %10.3f ms %10.2f ns/item\n", name, items, seconds * 1e3, seconds * 1e9 / items );
+}
+
+// Small, fast pseudo-random number generator (xorshift64*) so that inputs are reproducible across runs.
+//
+static inline uint64_t bench_rand( uint64_t * state )
+{
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+// Written to at the end of each benchmark so the compiler can't optimize away the work being measured.
+//
+static volatile uint64_t bench_sink;
+
+#endif // BENCH_H
@@ -0,0 +1,257 @@
+#ifndef ARRAY_FILE_H
+#define ARRAY_FILE_H
+
+#include <stdint.h>     // For uint32_t, uint64_t
+#include <stdio.h>      // For snprintf, rename
+#include <string.h>     // For memset, strlen
+#include <stdbool.h>    // For bool
+#include <errno.h>      // For errno
+#include <fcntl.h>      // For open
+#include <unistd.h>     // For write, close, fsync
+#include <sys/mman.h>   // For mmap, munmap
+#include <sys/stat.h>   // For fstat
+
+// A simple on-disk format for arrays, so that a large array can be saved once and then loaded back almost instantly by
+// mapping the file into memory instead of reading and parsing it. The file is a fixed-size header followed by the raw
+// bytes of the array, exactly as they were laid out in memory:
+//
+//     ┌────────────────────────────────────────────────┬───────────┬───────────┬─────┬─────────────┐
+//     │ header (64 bytes)                              │ element 0 │ element 1 │ ... │ element N-1 │
+//     │ magic, version, size, num, flags, checksum ... │           │           │     │             │
+//     └────────────────────────────────────────────────┴───────────┴───────────┴─────┴─────────────┘
+//
+// Because the elements are stored as-is, the "base" pointer of a mapped array can be passed straight to "array_find",
+// "array_count", "bsearch", "array_lower_bound", etc. The operating system only reads in the pages that are actually
+// touched, so a binary search over a multi-GB file reads a handful of pages instead of the whole file. Ex:
+//
+//     array_save( "ids.bin", ids, LEN_ARRAY(ids), sizeof(ids[0]), true );
+//
+//     ...after a restart...
+//
+//     array_view_t view;
+//     if( array_open_mapped( "ids.bin", ARRAY_MAP_READ_ONLY, false, &view ) == 0 )
+//     {
+//         uint32_t * found = bsearch( &key, view.base, view.num, view.size, compare_uint32 );
+//         array_close_mapped( &view );
+//     }
+//
+// The data is written in the byte order and with the struct padding of the machine that saved it, so a file should
+// only be opened on the same kind of machine (and by code built with the same struct layout). Elements that contain
+// pointers can't be saved in a meaningful way.
+//
+// All functions return 0 on success or -1 on failure, with "errno" set to indicate the error.
+
+#define ARRAY_FILE_MAGIC            0x59524141u     // "AARY" when read as little-endian bytes
+#define ARRAY_FILE_VERSION          1
+#define ARRAY_FILE_FLAG_SORTED      (1u << 0)
+
+typedef struct array_file_header_t
+{
+    uint32_t    magic;
+    uint32_t    version;
+    uint64_t    size;           // Size of each element, in bytes
+    uint64_t    num;            // Number of elements
+    uint32_t    flags;          // ARRAY_FILE_FLAG_*
+    uint32_t    header_size;    // Offset of the first element from the start of the file
+    uint64_t    checksum;       // "array_checksum" of the element data
+    uint8_t     reserved[24];   // Pads the header to 64 bytes so the data starts on a cache-line boundary
+} array_file_header_t;
+
+typedef enum array_map_mode_t
+{
+    ARRAY_MAP_READ_ONLY,        // Writing to the mapped array will crash the program
+    ARRAY_MAP_COPY_ON_WRITE,    // The mapped array can be modified, but the changes are private to this process and never written back to the file
+} array_map_mode_t;
+
+// A mapped array: "base", "num", and "size" describe the array in the same way as for the functions in
+// "array_methods.h". "sorted" is the flag that was passed to "array_save".
+//
+typedef struct array_view_t
+{
+    void *      base;
+    size_t      num;
+    size_t      size;
+    bool        sorted;
+    void *      map;
+    size_t      map_length;
+} array_view_t;
+
+// Computes a 64-bit checksum of the array (a variant of FNV-1a that consumes 8 bytes at a time instead of 1). This is
+// for catching truncated or corrupted files, not for security.
+//
+static inline uint64_t array_checksum( const void * base, size_t num, size_t size )
+{
+    const uint64_t prime = 0x100000001B3ULL;
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    const uint8_t * bytes = base;
+    size_t length = num * size, idx = 0;
+
+    for( ; idx + 8 <= length; idx += 8 )
+    {
+        uint64_t word;
+        memcpy( &word, bytes + idx, sizeof(word) );
+        hash = (hash ^ word) * prime;
+    }
+    for( ; idx < length; idx++ ) hash = (hash ^ bytes[idx]) * prime;
+
+    return hash;
+}
+
+// Writes "count" bytes from "buffer" to the file descriptor "fd", retrying after partial writes. Helper function used by
+// "array_save".
+//
+static inline int array_write_all( int fd, const void * buffer, size_t count )
+{
+    while( count > 0 )
+    {
+        ssize_t written = write( fd, buffer, count );
+        if( written < 0 )
+        {
+            if( errno == EINTR ) continue;
+            return -1;
+        }
+        buffer += written;
+        count -= written;
+    }
+
+    return 0;
+}
+
+// Saves the array to the file at "path", replacing it if it already exists. Set "sorted" if the array is sorted, so that
+// whoever opens the file later knows that it can be binary searched. The file is first written under a temporary name
+// and then renamed into place, so a crash part way through never leaves a truncated file at "path".
+//
+static inline int array_save( const char * path, const void * base, size_t num, size_t size, bool sorted )
+{
+    char temp_path[strlen( path ) + sizeof(".tmp")];
+    array_file_header_t header;
+
+    memset( &header, 0, sizeof(header) );
+    header.magic = ARRAY_FILE_MAGIC;
+    header.version = ARRAY_FILE_VERSION;
+    header.size = size;
+    header.num = num;
+    header.flags = sorted ? ARRAY_FILE_FLAG_SORTED : 0;
+    header.header_size = sizeof(header);
+    header.checksum = array_checksum( base, num, size );
+
+    snprintf( temp_path, sizeof(temp_path), "%s.tmp", path );
+
+    int fd = open( temp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+    if( fd < 0 ) return -1;
+
+    if( array_write_all( fd, &header, sizeof(header) ) != 0 ||
+        array_write_all( fd, base, num * size ) != 0 ||
+        fsync( fd ) != 0 )
+    {
+        int saved_errno = errno;
+        close( fd );
+        unlink( temp_path );
+        errno = saved_errno;
+        return -1;
+    }
+
+    if( close( fd ) != 0 || rename( temp_path, path ) != 0 )
+    {
+        int saved_errno = errno;
+        unlink( temp_path );
+        errno = saved_errno;
+        return -1;
+    }
+
+    return 0;
+}
+
+// Maps the array saved at "path" into memory and fills in "view". No element data is read or copied up front; pages
+// are loaded from the file the first time they're touched. If "verify_checksum" is set, the whole file is read once to
+// check it against the checksum in the header (which costs as much as reading the file normally, but catches
+// corruption). Fails with "errno" set to EINVAL if the file isn't an array file or was saved with a newer version of
+// this format, or EIO if the file is truncated, its header claims more data than the file holds, or its checksum
+// doesn't match.
+//
+// Call "array_close_mapped" when finished with the array.
+//
+static inline int array_open_mapped( const char * path, array_map_mode_t mode, bool verify_checksum, array_view_t * view )
+{
+    struct stat info;
+    int error = 0;
+
+    int fd = open( path, O_RDONLY );
+    if( fd < 0 ) return -1;
+
+    if( fstat( fd, &info ) != 0 )
+    {
+        error = errno;
+    }
+    else if( (size_t)info.st_size < sizeof(array_file_header_t) )
+    {
+        error = EINVAL;
+    }
+    else
+    {
+        int protection = mode == ARRAY_MAP_COPY_ON_WRITE ? PROT_READ | PROT_WRITE : PROT_READ;
+        void * map = mmap( NULL, info.st_size, protection, MAP_PRIVATE, fd, 0 );
+
+        if( map == MAP_FAILED )
+        {
+            error = errno;
+        }
+        else
+        {
+            const array_file_header_t * header = map;
+
+            if( header->magic != ARRAY_FILE_MAGIC || header->version > ARRAY_FILE_VERSION ||
+                header->header_size < sizeof(array_file_header_t) || header->size == 0 )
+            {
+                error = EINVAL;
+            }
+            else if( header->header_size > (uint64_t)info.st_size ||
+                     header->num > ( (uint64_t)info.st_size - header->header_size ) / header->size ||
+                     ( verify_checksum && array_checksum( map + header->header_size, header->num, header->size ) != header->checksum ) )
+            {
+                error = EIO;
+            }
+
+            if( error )
+            {
+                munmap( map, info.st_size );
+            }
+            else
+            {
+                view->base = map + header->header_size;
+                view->num = header->num;
+                view->size = header->size;
+                view->sorted = ( header->flags & ARRAY_FILE_FLAG_SORTED ) != 0;
+                view->map = map;
+                view->map_length = info.st_size;
+            }
+        }
+    }
+
+    // The mapping stays valid after the file is closed.
+    //
+    close( fd );
+
+    if( error )
+    {
+        errno = error;
+        return -1;
+    }
+
+    return 0;
+}
+
+// Unmaps an array opened with "array_open_mapped". Any pointers into the array become invalid.
+//
+static inline int array_close_mapped( array_view_t * view )
+{
+    int ret = munmap( view->map, view->map_length );
+
+    view->base = view->map = NULL;
+    view->num = 0;
+    view->map_length = 0;
+
+    return ret;
+}
+
+#endif // ARRAY_FILE_H
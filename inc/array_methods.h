@@ -2,7 +2,9 @@
 #define ARRAY_METHODS_H
 
 #include <string.h>     // For memmove, memset
+#include <stdlib.h>     // For malloc, free
 #include <stdbool.h>    // For bool
+#include <stdint.h>     // For uint32_t, uint64_t
 
 #define LEN_ARRAY(x) (sizeof(x)/sizeof(x[0]))
 
@@ -35,6 +37,9 @@
 //     void* bsearch (const void* key, const void* base, size_t num, size_t size, int (*compar)(const void * key, const void * elem))
 //     void qsort(void *base, size_t nitems, size_t size, int (*compar)(const void * elem1, const void * elem2))
 //
+// "qsort" is not stable (elements that compare equal can end up in any order); use "array_stable_sort" when that
+// matters, or when the array is likely to already be mostly sorted.
+//
 // Those two functions, and the ones below, require 3 parameters, at a minimum, to be able to work on an array of arbitrary data:
 //     - a pointer to the base of the array (of type "void *", so that any data type can be used),
 //     - the total number of elements in the array ("num"), and
@@ -65,6 +70,43 @@ static inline int array_find( const void * key, const void * base, size_t num, s
     return ret;
 }
 
+// Binary search for sorted arrays. Returns the index of the first element that does NOT compare less than "key" (i.e.
+// the first position at which "key" could be inserted while keeping the array sorted), or "num" if every element
+// compares less than "key". Unlike "bsearch", this always returns a position, even if "key" isn't in the array, and
+// always finds the _first_ of several equal elements.
+//
+static inline size_t array_lower_bound( const void * key, const void * base, size_t num, size_t size, int (*compare)(const void * key, const void * elem) )
+{
+    size_t lo = 0, hi = num;
+
+    while( lo < hi )
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if( compare( key, base + mid * size ) > 0 ) lo = mid + 1;
+        else hi = mid;
+    }
+
+    return lo;
+}
+
+// Binary search for sorted arrays. Returns the index of the first element that compares greater than "key" (i.e. the
+// last position at which "key" could be inserted while keeping the array sorted), or "num" if no element compares
+// greater than "key".
+//
+static inline size_t array_upper_bound( const void * key, const void * base, size_t num, size_t size, int (*compare)(const void * key, const void * elem) )
+{
+    size_t lo = 0, hi = num;
+
+    while( lo < hi )
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if( compare( key, base + mid * size ) >= 0 ) lo = mid + 1;
+        else hi = mid;
+    }
+
+    return lo;
+}
+
 // Returns the index of the largest value in the array.
 //
 static inline int array_find_max( const void * base, size_t num, size_t size, int (*compare)(const void * item_one, const void * item_two) )
@@ -74,7 +116,7 @@ static inline int array_find_max( const void * base, size_t num, size_t size, in
     for( int idx = 0; idx < num; idx++ )
     {
         const void * this_item = base + idx * size;
-        if( compare( &ret, this_item ) < 0 ) ret = idx;
+        if( compare( base + ret * size, this_item ) < 0 ) ret = idx;
     }
 
     return ret;
@@ -89,12 +131,59 @@ static inline int array_find_min( const void * base, size_t num, size_t size, in
     for( int idx = 0; idx < num; idx++ )
     {
         const void * this_item = base + idx * size;
-        if( compare( &ret, this_item ) > 0 ) ret = idx;
+        if( compare( base + ret * size, this_item ) > 0 ) ret = idx;
     }
 
     return ret;
 }
 
+// Finds the indices of both the smallest and the largest values in the array in a single pass, storing them in "min"
+// and "max". Elements are taken in pairs: the two are compared against each other first, and then only the smaller
+// one is compared against the current minimum and only the larger one against the current maximum, for a total of
+// about 3n/2 comparisons instead of the 2n needed by calling "array_find_min" and "array_find_max" separately. As
+// with those two functions, ties resolve to the first occurrence.
+//
+static inline void array_find_minmax( const void * base, size_t num, size_t size, int * min, int * max, int (*compare)(const void * item_one, const void * item_two) )
+{
+    int idx_min = 0, idx_max = 0, idx = 1;
+
+    if( num == 0 )
+    {
+        *min = *max = -1;
+        return;
+    }
+
+    // (1) With an even number of elements, the first pair seeds both the minimum and the maximum. With an odd number,
+    // the first element seeds both on its own, and the rest of the array can be taken in pairs.
+    //
+    if( num % 2 == 0 )
+    {
+        int order = compare( base + size, base );
+
+        if( order < 0 ) idx_min = 1;
+        else if( order > 0 ) idx_max = 1;
+        idx = 2;
+    }
+
+    for( ; idx + 1 < num; idx += 2 )
+    {
+        // (2) Order the pair, so that "small" comes first in the case of a tie (to keep the first occurrence of
+        // the minimum) and "large" does too (to keep the first occurrence of the maximum).
+        //
+        int small = idx, large = idx;
+        int order = compare( base + idx * size, base + (idx + 1) * size );
+
+        if( order < 0 ) large = idx + 1;
+        else if( order > 0 ) small = idx + 1;
+
+        if( compare( base + small * size, base + idx_min * size ) < 0 ) idx_min = small;
+        if( compare( base + large * size, base + idx_max * size ) > 0 ) idx_max = large;
+    }
+
+    *min = idx_min;
+    *max = idx_max;
+}
+
 // Keeps only those elements in an array for which the function "keep_this" returns "true", shifting elements
 // to the left as needed. Zeros out any remaining part of the array. Returns the number of elements that were
 // left in, for the purpose of allowing client code to initialize a new array that is just long enough
@@ -222,6 +311,476 @@ static inline int array_count( void * base, size_t num, size_t size, bool (*coun
     return count;
 }
 
+// Filters that record _which_ elements pass instead of copying them ("late materialization"). When several predicates
+// are applied to an array of wide records, copying the survivors of each one (as "array_filter_pure" does) moves most
+// of the data several times over, only for much of it to be thrown away by the next predicate. These functions leave
+// the array alone and write either:
+//
+//     - a "selection vector": the indices of the elements that passed, in order, as "uint32_t"s, or
+//     - a bitmap: one bit per element (bit "idx % 64" of word "idx / 64"), set if the element passed.
+//
+// Selections can be narrowed by further predicates ("array_filter_select_more", which only looks at the elements still
+// selected) and bitmaps can be combined ("array_bitmap_and", "array_bitmap_or"), and once every predicate has been
+// applied, "array_gather" copies out just the elements that are left. Ex:
+//
+//     uint32_t selection[NUM_ORDERS];
+//     size_t num_selected;
+//
+//     num_selected = array_filter_select( orders, NUM_ORDERS, sizeof(orders[0]), selection, is_open );
+//     num_selected = array_filter_select_more( orders, sizeof(orders[0]), selection, num_selected, is_overdue );
+//     array_gather( orders, sizeof(orders[0]), selection, num_selected, overdue_orders );
+//
+// Indices are written (and bits are set) without branching on the result of the predicate, so it doesn't matter how
+// predictable the result is. A bitmap for "num" elements takes ARRAY_BITMAP_WORDS(num) words.
+//
+// **WARNING**: Selection vectors hold 32-bit indices, so these functions only work on arrays of fewer than 2^32
+// elements.
+
+#define ARRAY_BITMAP_WORDS(num) ( ( (num) + 63 ) / 64 )
+
+// Writes to "selection" the index of each element in "base" for which the function "keep_this" returns "true". Returns
+// the number of indices written.
+//
+// **WARNING**: This function _assumes_ that "selection" has room for "num" indices, since every element might pass.
+//
+static inline size_t array_filter_select( const void * base, size_t num, size_t size, uint32_t * selection, bool (*keep_this)(const void * elem) )
+{
+    size_t count = 0;
+
+    for( size_t idx = 0; idx < num; idx++ )
+    {
+        selection[count] = idx;
+        count += keep_this( base + idx * size );
+    }
+
+    return count;
+}
+
+// Narrows a selection vector of "num_selected" indices (from "array_filter_select", say) down to those elements for
+// which "keep_this" also returns "true", in place. Only the elements already selected are looked at. Returns the new
+// number of indices.
+//
+static inline size_t array_filter_select_more( const void * base, size_t size, uint32_t * selection, size_t num_selected, bool (*keep_this)(const void * elem) )
+{
+    size_t count = 0;
+
+    for( size_t idx = 0; idx < num_selected; idx++ )
+    {
+        uint32_t pos = selection[idx];
+        selection[count] = pos;
+        count += keep_this( base + pos * size );
+    }
+
+    return count;
+}
+
+// Sets bit "idx" of "bitmap" if "keep_this" returns "true" for element "idx" of "base", and clears it otherwise.
+// Every word of the bitmap is written, including the unused bits at the end of the last one (which are cleared), so
+// "bitmap" doesn't need to be initialized. Returns the number of elements that passed.
+//
+static inline size_t array_filter_bitmap( const void * base, size_t num, size_t size, uint64_t * bitmap, bool (*keep_this)(const void * elem) )
+{
+    size_t count = 0;
+
+    for( size_t word = 0; word < ARRAY_BITMAP_WORDS(num); word++ )
+    {
+        size_t first = word * 64, last = num - first < 64 ? num : first + 64;
+        uint64_t bits = 0;
+
+        for( size_t idx = first; idx < last; idx++ ) bits |= (uint64_t)keep_this( base + idx * size ) << ( idx - first );
+        bitmap[word] = bits;
+        count += __builtin_popcountll( bits );
+    }
+
+    return count;
+}
+
+// Keeps in "bitmap" only the bits that are also set in "other", i.e. the elements that passed both filters. Both
+// bitmaps are for "num" elements.
+//
+static inline void array_bitmap_and( uint64_t * bitmap, const uint64_t * other, size_t num )
+{
+    for( size_t word = 0; word < ARRAY_BITMAP_WORDS(num); word++ ) bitmap[word] &= other[word];
+}
+
+// Adds to "bitmap" the bits that are set in "other", i.e. the elements that passed either filter. Both bitmaps are for
+// "num" elements.
+//
+static inline void array_bitmap_or( uint64_t * bitmap, const uint64_t * other, size_t num )
+{
+    for( size_t word = 0; word < ARRAY_BITMAP_WORDS(num); word++ ) bitmap[word] |= other[word];
+}
+
+// Counts the bits set in a bitmap for "num" elements, one word at a time with the CPU's population count instruction
+// (where it has one; compile with "-mpopcnt" or "-march=native" to make sure it's used on x86).
+//
+// **WARNING**: Any unused bits at the end of the last word must be clear, as they are after "array_filter_bitmap".
+//
+static inline size_t array_count_bitmap( const uint64_t * bitmap, size_t num )
+{
+    size_t count = 0;
+
+    for( size_t word = 0; word < ARRAY_BITMAP_WORDS(num); word++ ) count += __builtin_popcountll( bitmap[word] );
+
+    return count;
+}
+
+// Converts a bitmap for "num" elements into a selection vector of the indices of its set bits, in order. Only the set
+// bits are visited (each word is consumed by finding and clearing its lowest set bit), so a sparse bitmap is fast to
+// convert. Returns the number of indices written.
+//
+// **WARNING**: This function _assumes_ that "selection" is large enough to hold one index per set bit.
+//
+static inline size_t array_bitmap_to_selection( const uint64_t * bitmap, size_t num, uint32_t * selection )
+{
+    size_t count = 0;
+
+    for( size_t word = 0; word < ARRAY_BITMAP_WORDS(num); word++ )
+    {
+        for( uint64_t bits = bitmap[word]; bits; bits &= bits - 1 ) selection[count++] = word * 64 + __builtin_ctzll( bits );
+    }
+
+    return count;
+}
+
+// Copies the elements of "base" at the "num_selected" indices in "selection", in that order, to "gathered". Returns
+// the number of elements copied.
+//
+// **WARNING**: This function _assumes_ that "gathered" has room for "num_selected" elements and doesn't overlap "base".
+//
+static inline size_t array_gather( const void * base, size_t size, const uint32_t * selection, size_t num_selected, void * gathered )
+{
+    for( size_t idx = 0; idx < num_selected; idx++ ) memcpy( gathered + idx * size, base + selection[idx] * size, size );
+
+    return num_selected;
+}
+
+// Kernels that look at a single field of each element instead of calling a function on the whole element. The field
+// is "width" bytes (1, 2, 4 or 8) at byte "offset" within each element, and is read as an unsigned integer in the
+// machine's byte order; elements are still "size" bytes apart. Because the comparison is done inline, on a value of
+// the right type, there's no call per element, and when the elements are no bigger than the field (a dense column,
+// from "array_aos_to_soa", say) the loops are simple enough for the compiler to vectorize. Ex:
+//
+//     typedef struct order_t
+//     {
+//         uint64_t    id;
+//         uint32_t    status;
+//         ...
+//     } order_t;
+//
+//     int pending = array_count_field_range( orders, num, sizeof(order_t), offsetof(order_t, status),
+//                                            sizeof(uint32_t), PENDING, PENDING );
+//
+// To compare signed fields, flip their sign bit first (or choose "lo" and "hi" with that in mind).
+
+// Runs the code passed after "width" with "field_t" defined as the unsigned integer type of that width. Helper macro
+// used by the field kernels.
+//
+#define ARRAY_FIELD_SWITCH(width, ...)                                  \
+    switch( width )                                                     \
+    {                                                                   \
+        case 1: { typedef uint8_t field_t; __VA_ARGS__; break; }        \
+        case 2: { typedef uint16_t field_t; __VA_ARGS__; break; }       \
+        case 4: { typedef uint32_t field_t; __VA_ARGS__; break; }       \
+        case 8: { typedef uint64_t field_t; __VA_ARGS__; break; }       \
+    }
+
+// Returns the index of the first element whose field equals "value", or -1 if there isn't one (or if "width" isn't
+// 1, 2, 4 or 8).
+//
+static inline int array_find_field( const void * base, size_t num, size_t size, size_t offset, size_t width, uint64_t value )
+{
+    int ret = -1;
+
+    ARRAY_FIELD_SWITCH( width,
+    {
+        for( size_t idx = 0; idx < num; idx++ )
+        {
+            field_t field;
+            memcpy( &field, base + idx * size + offset, sizeof(field) );
+            if( field == (field_t)value )
+            {
+                ret = idx;
+                break;
+            }
+        }
+    })
+
+    return ret;
+}
+
+// Counts the elements whose field is between "lo" and "hi", inclusive. Use the same value for both to count the
+// elements whose field equals it.
+//
+static inline size_t array_count_field_range( const void * base, size_t num, size_t size, size_t offset, size_t width, uint64_t lo, uint64_t hi )
+{
+    size_t count = 0;
+
+    ARRAY_FIELD_SWITCH( width,
+    {
+        field_t low = lo, span = hi - lo;
+
+        if( size == sizeof(field_t) && offset == 0 )
+        {
+            const field_t * column = base;
+            for( size_t idx = 0; idx < num; idx++ ) count += (field_t)( column[idx] - low ) <= span;
+        }
+        else
+        {
+            for( size_t idx = 0; idx < num; idx++ )
+            {
+                field_t field;
+                memcpy( &field, base + idx * size + offset, sizeof(field) );
+                count += (field_t)( field - low ) <= span;
+            }
+        }
+    })
+
+    return count;
+}
+
+// Finds the indices of the elements with the smallest and largest fields, storing them in "min" and "max" (both -1
+// if the array is empty). Ties resolve to the first occurrence, as with "array_find_minmax".
+//
+static inline void array_find_minmax_field( const void * base, size_t num, size_t size, size_t offset, size_t width, int * min, int * max )
+{
+    *min = *max = -1;
+    if( num == 0 ) return;
+
+    ARRAY_FIELD_SWITCH( width,
+    {
+        field_t field, low, high;
+        int idx_min = 0, idx_max = 0;
+
+        memcpy( &low, base + offset, sizeof(low) );
+        high = low;
+        for( size_t idx = 1; idx < num; idx++ )
+        {
+            memcpy( &field, base + idx * size + offset, sizeof(field) );
+            if( field < low ) { low = field; idx_min = idx; }
+            if( field > high ) { high = field; idx_max = idx; }
+        }
+        *min = idx_min;
+        *max = idx_max;
+    })
+}
+
+// Copies "num_fields" fields (field "f" being "widths[f]" bytes at byte "offsets[f]" of each element) out of an array
+// of "num" structures of "size" bytes each, into one dense array per field: "columns[f]" receives the "num" values of
+// field "f", "widths[f]" bytes apart. Any field width works here, not just 1, 2, 4 or 8. Each column is written in a
+// single pass, from front to back.
+//
+// **WARNING**: This function _assumes_ that each of "columns" has room for "num" values of its field.
+//
+static inline void array_aos_to_soa( const void * base, size_t num, size_t size, const size_t * offsets, const size_t * widths, size_t num_fields, void * const * columns )
+{
+    for( size_t f = 0; f < num_fields; f++ )
+    {
+        const void * from = base + offsets[f];
+        void * to = columns[f];
+
+        switch( widths[f] )
+        {
+            case 4:     for( size_t idx = 0; idx < num; idx++ ) memcpy( to + idx * 4, from + idx * size, 4 ); break;
+            case 8:     for( size_t idx = 0; idx < num; idx++ ) memcpy( to + idx * 8, from + idx * size, 8 ); break;
+            default:    for( size_t idx = 0; idx < num; idx++ ) memcpy( to + idx * widths[f], from + idx * size, widths[f] ); break;
+        }
+    }
+}
+
+// The reverse of "array_aos_to_soa": copies each value of each column back into its field of the corresponding
+// structure in "base". Fields that aren't listed are left alone.
+//
+static inline void array_soa_to_aos( void * base, size_t num, size_t size, const size_t * offsets, const size_t * widths, size_t num_fields, const void * const * columns )
+{
+    for( size_t f = 0; f < num_fields; f++ )
+    {
+        const void * from = columns[f];
+        void * to = base + offsets[f];
+
+        switch( widths[f] )
+        {
+            case 4:     for( size_t idx = 0; idx < num; idx++ ) memcpy( to + idx * size, from + idx * 4, 4 ); break;
+            case 8:     for( size_t idx = 0; idx < num; idx++ ) memcpy( to + idx * size, from + idx * 8, 8 ); break;
+            default:    for( size_t idx = 0; idx < num; idx++ ) memcpy( to + idx * size, from + idx * widths[f], widths[f] ); break;
+        }
+    }
+}
+
+// Removes every element of a sorted array that compares equal to the element before it, keeping the first of each
+// group of equal elements. Calls "delete" (if not NULL) on each element removed, zeros out the rest of the array, and
+// returns the number of elements left. Runs of elements to keep are moved with a single "memmove" each (and not at
+// all before the first duplicate), so an array with few duplicates costs little more than the comparisons. Ex:
+//
+//     uint32_t ids[] = {4,1,4,2,1,4};
+//
+//     qsort( ids, LEN_ARRAY(ids), sizeof(ids[0]), compare_uint32 );                              // [1,1,2,4,4,4]
+//     int num_ids = array_unique_sorted( ids, LEN_ARRAY(ids), sizeof(ids[0]), compare_uint32, NULL );   // [1,2,4,0,0,0]
+//
+// **WARNING**: This function copies array elements to different locations in memory. Because of this, it will
+// break any variables that hold pointers to any array elements, since those pointers will point to different
+// pieces of data.
+//
+static inline int array_unique_sorted( void * base, size_t num, size_t size, int (*compare)(const void * item_one, const void * item_two), void (*delete)(void * item) )
+{
+    void * end_of_base_array = base + num * size, * end_of_unique_array = base, * run = base, * last_kept = base;
+
+    if( num == 0 ) return 0;
+
+    // (1) "run" is the start of the elements kept since the last duplicate, which haven't been moved yet, and
+    // "last_kept" is wherever the most recently kept element currently is. Duplicates are compared against that, not
+    // the element just before them, since that may have been deleted.
+    //
+    for( void * this_item = base + size; this_item < end_of_base_array; this_item += size )
+    {
+        if( compare( last_kept, this_item ) != 0 )
+        {
+            last_kept = this_item;
+            continue;
+        }
+
+        // (2) A duplicate: move the run before it into place as one block.
+        //
+        if( this_item > run )
+        {
+            if( end_of_unique_array != run ) memmove( end_of_unique_array, run, this_item - run );
+            end_of_unique_array += this_item - run;
+            last_kept = end_of_unique_array - size;
+        }
+        if( delete ) delete( this_item );
+        run = this_item + size;
+    }
+
+    if( end_of_unique_array != run ) memmove( end_of_unique_array, run, end_of_base_array - run );
+    end_of_unique_array += end_of_base_array - run;
+    memset( end_of_unique_array, 0, end_of_base_array - end_of_unique_array );
+
+    return ( end_of_unique_array - base ) / size;
+}
+
+// A set of pointers to elements, kept in an open-addressing hash table with linear probing, which stores each
+// element's hash next to its pointer so that most probes never have to call the comparison function. Helper used by
+// "array_unique_hash" and "linked_list_unique". The table grows as needed to stay at most half full.
+
+typedef struct unique_slot_t
+{
+    uint64_t        hash;
+    const void *    item;       // NULL for an empty slot
+} unique_slot_t;
+
+typedef struct unique_set_t
+{
+    unique_slot_t * slots;
+    size_t          mask;       // Number of slots minus one (the number of slots is a power of two)
+    size_t          count;
+} unique_set_t;
+
+// Prepares an empty set with room for "expected" items before it has to grow. Returns "false" if the table couldn't
+// be allocated.
+//
+static inline bool unique_set_init( unique_set_t * set, size_t expected )
+{
+    size_t num_slots = 16;
+
+    while( num_slots < 2 * expected ) num_slots *= 2;
+    set->slots = calloc( num_slots, sizeof(unique_slot_t) );
+    set->mask = num_slots - 1;
+    set->count = 0;
+
+    return set->slots != NULL;
+}
+
+static inline void unique_set_free( unique_set_t * set )
+{
+    free( set->slots );
+    set->slots = NULL;
+}
+
+// Mixes all the bits of a hash (the finalizer from MurmurHash3), so that simple hash functions, like using an integer
+// key as its own hash, still spread over the whole table.
+//
+static inline uint64_t unique_set_mix( uint64_t hash )
+{
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+// Adds "item" to the set unless an item that compares equal to it is already there. Returns 1 if it was added, 0 if
+// it was a duplicate, or -1 if the table needed to grow and couldn't.
+//
+static inline int unique_set_insert( unique_set_t * set, const void * item, uint64_t hash, int (*compare)(const void * item_one, const void * item_two) )
+{
+    size_t pos;
+
+    hash = unique_set_mix( hash );
+    for( pos = hash & set->mask; set->slots[pos].item; pos = ( pos + 1 ) & set->mask )
+    {
+        if( set->slots[pos].hash == hash && compare( set->slots[pos].item, item ) == 0 ) return 0;
+    }
+
+    if( 2 * ( set->count + 1 ) > set->mask + 1 )
+    {
+        unique_set_t bigger;
+
+        if( !unique_set_init( &bigger, set->mask + 1 ) ) return -1;
+        for( size_t idx = 0; idx <= set->mask; idx++ )
+        {
+            if( set->slots[idx].item == NULL ) continue;
+            for( pos = set->slots[idx].hash & bigger.mask; bigger.slots[pos].item; pos = ( pos + 1 ) & bigger.mask );
+            bigger.slots[pos] = set->slots[idx];
+        }
+        bigger.count = set->count;
+        unique_set_free( set );
+        *set = bigger;
+        for( pos = hash & set->mask; set->slots[pos].item; pos = ( pos + 1 ) & set->mask );
+    }
+
+    set->slots[pos] = (unique_slot_t){ hash, item };
+    set->count++;
+
+    return 1;
+}
+
+// Removes every element of an array (sorted or not) that compares equal to an earlier element, keeping the first
+// occurrence of each and the order of the elements kept. "hash" must return the same value for any two elements that
+// compare equal. Calls "delete" (if not NULL) on each element removed, zeros out the rest of the array, and returns the
+// number of elements left, or -1 if the hash table couldn't be allocated (in which case the array is unchanged).
+//
+// This takes O(n) expected time, against O(n log n) for sorting and "array_unique_sorted", and doesn't reorder the
+// array; it does need a table of 16 bytes per element (at least) while it runs.
+//
+// **WARNING**: This function copies array elements to different locations in memory. Because of this, it will
+// break any variables that hold pointers to any array elements, since those pointers will point to different
+// pieces of data.
+//
+static inline int array_unique_hash( void * base, size_t num, size_t size, uint64_t (*hash)(const void * elem), int (*compare)(const void * item_one, const void * item_two), void (*delete)(void * item) )
+{
+    void * end_of_unique_array = base, * end_of_base_array = base + num * size;
+    unique_set_t set;
+
+    if( !unique_set_init( &set, num ) ) return -1;
+
+    // Each element is moved into place first (the space it's moved into is free either way) and then looked up, so
+    // the set always points to elements where they'll end up.
+    //
+    for( void * this_item = base; this_item < end_of_base_array; this_item += size )
+    {
+        if( end_of_unique_array != this_item ) memmove( end_of_unique_array, this_item, size );
+        if( unique_set_insert( &set, end_of_unique_array, hash( end_of_unique_array ), compare ) > 0 ) end_of_unique_array += size;    // Never has to grow
+        else if( delete ) delete( end_of_unique_array );
+    }
+
+    unique_set_free( &set );
+    memset( end_of_unique_array, 0, end_of_base_array - end_of_unique_array );
+
+    return ( end_of_unique_array - base ) / size;
+}
+
 // Insert an element into the array at position "pos", shifting "pos" and all remaining elements to the right.
 // Overwrites the last element in the array.
 // 
@@ -252,21 +811,141 @@ static inline void array_remove( void * base, size_t num, size_t size, int pos,
     memset( base+size*(num-1), 0, size);
 }
 
-// Byte-swap of a and b. Helper macro used by "array_reverse".
+// Inserts "elem" into a sorted array that currently holds "num" elements, keeping it sorted. The position is found
+// with a binary search (after any elements equal to "elem", so equal elements stay in the order they were inserted)
+// and everything after it is shifted to the right with a single block move. Returns the index at which "elem" was
+// inserted. Ex:
 //
-#define SWAP(a, b, size)                \
-    do                                  \
-    {                                   \
-        size_t __size = (size);         \
-        char * __a = (a), * __b = (b);  \
-        do                              \
-        {                               \
-            char __tmp = * __a;         \
-            * __a++ = * __b;            \
-            * __b++ = __tmp;            \
-        } while (--__size > 0);         \
-    } while (0);    
-
+//     uint32_t x[8] = {1,3,5,7};
+//     uint32_t new_value = 4;
+//
+//     array_sorted_insert( x, 4, sizeof(x[0]), &new_value, compare_uint32 );   // x is now [1,3,4,5,7,...]
+//
+// **WARNING**: Unlike "array_insert", "num" here is the number of elements _in use_, not the length of the array.
+// This function _assumes_ that the array has room for at least "num + 1" elements. Using an array that is already full
+// incurs the risk of an overflow error, which this function can neither detect nor prevent!
+//
+// **WARNING**: This function copies array elements to different locations in memory. Because of this, it will
+// break any variables that hold pointers to any array elements, since those pointers will point to different
+// pieces of data.
+//
+static inline int array_sorted_insert( void * base, size_t num, size_t size, const void * elem, int (*compare)(const void * key, const void * elem) )
+{
+    size_t pos = array_upper_bound( elem, base, num, size, compare );
+    void * this_item = base + pos * size;
+
+    memmove( this_item + size, this_item, (num - pos) * size );
+    memcpy( this_item, elem, size );
+
+    return pos;
+}
+
+// Merges the sorted arrays "base_one" and "base_two" into "merged", which ends up sorted. When two elements compare
+// equal, the one from "base_one" comes first (i.e. the merge is stable). Once either input runs out, the remainder of
+// the other one is copied over in a single block. Returns the number of elements in "merged". Ex:
+//
+//     uint32_t x[] = {1,4,6}, y[] = {2,3,7,9}, merged[7];
+//
+//     array_merge_sorted( x, LEN_ARRAY(x), y, LEN_ARRAY(y), sizeof(x[0]), merged, compare_uint32 );  // merged is now [1,2,3,4,6,7,9]
+//
+// **WARNING**: This function _assumes_ that "merged" is large enough to hold "num_one + num_two" elements and that it
+// doesn't overlap either of the input arrays.
+//
+static inline int array_merge_sorted( const void * base_one, size_t num_one, const void * base_two, size_t num_two, size_t size, void * merged, int (*compare)(const void * item_one, const void * item_two) )
+{
+    const void * end_one = base_one + num_one * size;
+    const void * end_two = base_two + num_two * size;
+    void * out = merged;
+
+    while( base_one < end_one && base_two < end_two )
+    {
+        if( compare( base_two, base_one ) < 0 )
+        {
+            memcpy( out, base_two, size );
+            base_two += size;
+        }
+        else
+        {
+            memcpy( out, base_one, size );
+            base_one += size;
+        }
+        out += size;
+    }
+
+    memcpy( out, base_one, end_one - base_one );
+    out += end_one - base_one;
+    memcpy( out, base_two, end_two - base_two );
+
+    return num_one + num_two;
+}
+
+// Merges two adjacent sorted runs in the same array, "[0, mid)" and "[mid, num)", so that the whole array ends up
+// sorted. The merge is stable. Any leading elements of the first run that are already in place are skipped (found
+// with a binary search), and only what remains of the first run is copied out to "scratch", so "scratch" must be able
+// to hold at least "mid" elements. If the first run is already entirely less than or equal to the second, the array
+// isn't touched at all.
+//
+// **WARNING**: This function copies array elements to different locations in memory. Because of this, it will
+// break any variables that hold pointers to any array elements, since those pointers will point to different
+// pieces of data.
+//
+static inline void array_merge_sorted_in_place( void * base, size_t mid, size_t num, size_t size, void * scratch, int (*compare)(const void * item_one, const void * item_two) )
+{
+    if( mid == 0 || mid >= num ) return;
+
+    // (1) Elements of the first run that are less than or equal to the first element of the second run are already
+    // where they belong.
+    //
+    size_t skip = array_upper_bound( base + mid * size, base, mid, size, compare );
+    if( skip == mid ) return;
+
+    // (2) Copy what's left of the first run out of the way, then merge it with the second run from front to back. The
+    // output can never catch up to the part of the second run that hasn't been read yet, since it's always exactly
+    // as far behind as the number of elements still waiting in "scratch".
+    //
+    size_t left_count = mid - skip;
+    const void * left = scratch, * end_left = scratch + left_count * size;
+    const void * right = base + mid * size, * end_right = base + num * size;
+    void * out = base + skip * size;
+
+    memcpy( scratch, out, left_count * size );
+
+    while( left < end_left && right < end_right )
+    {
+        if( compare( right, left ) < 0 )
+        {
+            memcpy( out, right, size );
+            right += size;
+        }
+        else
+        {
+            memcpy( out, left, size );
+            left += size;
+        }
+        out += size;
+    }
+
+    // (3) If the second run ran out first, the rest of "scratch" goes at the end. (If "scratch" ran out first, the rest
+    // of the second run is already in place.)
+    //
+    memcpy( out, left, end_left - left );
+}
+
+// Byte-swap of a and b. Helper macro used by "array_reverse".
+//
+#define SWAP(a, b, size)                \
+    do                                  \
+    {                                   \
+        size_t __size = (size);         \
+        char * __a = (a), * __b = (b);  \
+        do                              \
+        {                               \
+            char __tmp = * __a;         \
+            * __a++ = * __b;            \
+            * __b++ = __tmp;            \
+        } while (--__size > 0);         \
+    } while (0);    
+
 // **WARNING**: This function copies array elements to different locations in memory. Because of this, it will
 // break any variables that hold pointers to any array elements, since those pointers will point to different
 // pieces of data.
@@ -276,4 +955,814 @@ static inline void array_reverse( void * base, size_t num, size_t size )
     for( int idx = 0; idx < num/2; idx++ ) SWAP( base+size*idx, base+size*(num-1-idx), size );
 }
 
+// Restores the heap property for the element at position "pos" of an array-based binary heap by moving it down
+// the tree until neither of its children should come before it. If "order" is positive, the heap keeps its largest
+// element at the root (a "max-heap"); if "order" is negative, the heap keeps its smallest element at the root
+// (a "min-heap"). Helper function used by "array_nth_element" and "array_top_k".
+//
+static inline void array_sift_down( void * base, size_t num, size_t size, size_t pos, int order, int (*compare)(const void * item_one, const void * item_two) )
+{
+    for( size_t child = 2*pos + 1; child < num; pos = child, child = 2*pos + 1 )
+    {
+        void * this_item = base + pos * size;
+        void * this_child = base + child * size;
+
+        // Pick whichever child should be closer to the root...
+        //
+        if( child + 1 < num )
+        {
+            void * right_child = this_child + size;
+            if( ( order > 0 ? compare( right_child, this_child ) : compare( this_child, right_child ) ) > 0 )
+            {
+                child++;
+                this_child = right_child;
+            }
+        }
+
+        // ...and stop once that child no longer belongs above "this_item".
+        //
+        if( ( order > 0 ? compare( this_child, this_item ) : compare( this_item, this_child ) ) <= 0 ) break;
+        SWAP( this_item, this_child, size );
+    }
+}
+
+// Partitions the array around its first element (the "pivot"), so that every element to the left of the pivot's
+// final position compares less than or equal to it and every element to the right compares greater than or equal
+// to it. Elements that are equal to the pivot are split between both sides, which keeps runs of duplicates from
+// degrading into a quadratic number of passes. Returns the final index of the pivot. Helper function used by
+// "array_nth_element".
+//
+static inline size_t array_partition( void * base, size_t num, size_t size, int (*compare)(const void * item_one, const void * item_two) )
+{
+    size_t left = 1, right = num - 1;
+
+    for( ;; )
+    {
+        while( left <= right && compare( base + left * size, base ) < 0 ) left++;
+        while( left <= right && compare( base + right * size, base ) > 0 ) right--;
+        if( left >= right ) break;
+        SWAP( base + left * size, base + right * size, size );
+        left++;
+        right--;
+    }
+
+    if( right > 0 ) SWAP( base, base + right * size, size );
+
+    return right;
+}
+
+// Rearranges the array so that the element at position "nth" is the one that would be there if the whole array were
+// sorted, with every element before it comparing less than or equal to it and every element after it comparing
+// greater than or equal to it. Neither side is otherwise sorted. This is the C equivalent of C++'s "std::nth_element",
+// and runs in linear time on average, which makes it a much better fit than "qsort" for finding medians and
+// percentiles. Ex:
+//
+//     uint32_t latencies[1000];
+//     size_t p99 = LEN_ARRAY(latencies) * 99 / 100;
+//
+//     array_nth_element( latencies, LEN_ARRAY(latencies), sizeof(latencies[0]), p99, compare_uint32 );
+//     // latencies[p99] is now the 99th-percentile latency
+//
+// The implementation is an "introselect": a quickselect with a median-of-three pivot, which falls back to a heap-based
+// selection if the partitions stop shrinking quickly enough (i.e. on adversarial inputs), keeping the worst case at
+// O(n log n).
+//
+// **WARNING**: This function copies array elements to different locations in memory. Because of this, it will
+// break any variables that hold pointers to any array elements, since those pointers will point to different
+// pieces of data.
+//
+static inline void array_nth_element( void * base, size_t num, size_t size, size_t nth, int (*compare)(const void * item_one, const void * item_two) )
+{
+    size_t lo = 0, hi = num;
+    int depth_limit = 0;
+
+    if( nth >= num ) return;
+
+    for( size_t remaining = num; remaining > 1; remaining >>= 1 ) depth_limit += 2;
+
+    while( hi - lo > 8 )
+    {
+        void * first = base + lo * size;
+        size_t count = hi - lo;
+
+        if( depth_limit-- == 0 )
+        {
+            // (1) Quickselect is taking too long; fall back to keeping the smallest "nth - lo + 1" elements in a max-heap.
+            // Once every other element has been checked against the root, the root is the element we're looking for.
+            //
+            size_t heap_size = nth - lo + 1;
+
+            for( size_t idx = heap_size / 2; idx-- > 0; ) array_sift_down( first, heap_size, size, idx, 1, compare );
+            for( size_t idx = heap_size; idx < count; idx++ )
+            {
+                if( compare( first + idx * size, first ) < 0 )
+                {
+                    SWAP( first, first + idx * size, size );
+                    array_sift_down( first, heap_size, size, 0, 1, compare );
+                }
+            }
+            SWAP( first, first + (heap_size - 1) * size, size );
+            return;
+        }
+
+        // (2) Move the median of the first, middle, and last elements to the front to use as the pivot.
+        //
+        void * middle = first + (count / 2) * size;
+        void * last = first + (count - 1) * size;
+        void * median;
+
+        if( compare( first, middle ) < 0 )
+        {
+            if( compare( middle, last ) < 0 ) median = middle;
+            else median = compare( first, last ) < 0 ? last : first;
+        }
+        else
+        {
+            if( compare( first, last ) < 0 ) median = first;
+            else median = compare( middle, last ) < 0 ? last : middle;
+        }
+        if( median != first ) SWAP( first, median, size );
+
+        // (3) Partition, then keep going only in the side that contains "nth".
+        //
+        size_t cut = lo + array_partition( first, count, size, compare );
+
+        if( cut == nth ) return;
+        else if( nth < cut ) hi = cut;
+        else lo = cut + 1;
+    }
+
+    // (4) Finish small ranges with an insertion sort.
+    //
+    for( size_t idx = lo + 1; idx < hi; idx++ )
+    {
+        for( size_t pos = idx; pos > lo && compare( base + (pos - 1) * size, base + pos * size ) > 0; pos-- )
+        {
+            SWAP( base + (pos - 1) * size, base + pos * size, size );
+        }
+    }
+}
+
+// Copies the "k" largest elements of the array to "top", ordered from largest to smallest. Does NOT modify the base
+// array. Returns the number of elements copied, which is the smaller of "k" and "num". Only a single pass is made over
+// the base array: "top" is kept as a bounded min-heap of the best "k" elements seen so far, so each new element costs
+// one comparison against the smallest of those unless it is good enough to replace it. Ex:
+//
+//     score_t leaderboard[10];
+//     int count = array_top_k( scores, LEN_ARRAY(scores), sizeof(scores[0]), LEN_ARRAY(leaderboard), leaderboard, compare_scores );
+//
+// To get the "k" _smallest_ elements instead, reverse the order of the comparison function.
+//
+// **WARNING**: This function _assumes_ that "top" is large enough to hold "k" elements.
+//
+static inline int array_top_k( const void * base, size_t num, size_t size, size_t k, void * top, int (*compare)(const void * item_one, const void * item_two) )
+{
+    size_t count = 0;
+    const void * end_of_base_array = base + num * size;
+
+    if( k == 0 ) return 0;
+
+    for( const void * this_item = base; this_item < end_of_base_array; this_item += size )
+    {
+        if( count < k )
+        {
+            memcpy( top + count * size, this_item, size );
+            if( ++count == k )
+            {
+                for( size_t idx = k / 2; idx-- > 0; ) array_sift_down( top, k, size, idx, -1, compare );
+            }
+        }
+        else if( compare( this_item, top ) > 0 )
+        {
+            memcpy( top, this_item, size );
+            array_sift_down( top, k, size, 0, -1, compare );
+        }
+    }
+
+    if( count < k )
+    {
+        for( size_t idx = count / 2; idx-- > 0; ) array_sift_down( top, count, size, idx, -1, compare );
+    }
+
+    // Repeatedly moving the smallest remaining element to the end of the heap leaves "top" sorted from largest to
+    // smallest.
+    //
+    for( size_t end = count; end-- > 1; )
+    {
+        SWAP( top, top + end * size, size );
+        array_sift_down( top, end, size, 0, -1, compare );
+    }
+
+    return count;
+}
+
+// Priority queues kept in an array as an implicit "d-ary" heap, in which the children of the element at position "pos"
+// are at positions d*pos + 1 through d*pos + d. The element that compares smallest is always at position 0 (to take
+// the largest first instead, reverse the order of the comparison function). Ex:
+//
+//     task_t ready[MAX_TASKS], next;
+//     size_t num_ready = 0;
+//
+//     num_ready = array_heap_push( ready, num_ready, sizeof(ready[0]), &new_task, compare_deadlines );
+//     ...
+//     num_ready = array_heap_pop( ready, num_ready, sizeof(ready[0]), &next, compare_deadlines );
+//
+// Pushing and popping take O(log n) time, instead of the O(n) walk per insert needed to keep a sorted list with
+// "linked_list_sorted_insert". The "array_heap4_" functions (and "array_heapify4") use d = 4 instead of 2: the tree is
+// half as deep, and the four children of an element sit next to each other in memory, so a pop takes about half as
+// many cache misses for a few more comparisons per level. For large heaps of small elements, that's usually the faster
+// choice. A heap must always be used with the same arity.
+//
+// Elements are moved with one copy per level (the element being placed is held aside until its position is found),
+// rather than being swapped at each level.
+//
+// **WARNING**: These functions copy array elements to different locations in memory. Because of this, they will
+// break any variables that hold pointers to any array elements, since those pointers will point to different
+// pieces of data.
+
+// Moves the element at position "pos" up the heap until its parent doesn't compare greater. Returns its new position.
+//
+static inline size_t array_dheap_sift_up( void * base, size_t size, size_t pos, size_t arity, int (*compare)(const void * item_one, const void * item_two) )
+{
+    char temp[size];
+
+    memcpy( temp, base + pos * size, size );
+    while( pos > 0 )
+    {
+        size_t parent = ( pos - 1 ) / arity;
+
+        if( compare( temp, base + parent * size ) >= 0 ) break;
+        memcpy( base + pos * size, base + parent * size, size );
+        pos = parent;
+    }
+    memcpy( base + pos * size, temp, size );
+
+    return pos;
+}
+
+// Moves the element at position "pos" down the heap until none of its children compares less. Returns its new
+// position.
+//
+static inline size_t array_dheap_sift_down( void * base, size_t num, size_t size, size_t pos, size_t arity, int (*compare)(const void * item_one, const void * item_two) )
+{
+    char temp[size];
+
+    memcpy( temp, base + pos * size, size );
+    for( size_t first = arity * pos + 1; first < num; first = arity * pos + 1 )
+    {
+        size_t last = num - first > arity ? first + arity : num, best = first;
+
+        for( size_t child = first + 1; child < last; child++ )
+        {
+            if( compare( base + child * size, base + best * size ) < 0 ) best = child;
+        }
+        if( compare( base + best * size, temp ) >= 0 ) break;
+
+        memcpy( base + pos * size, base + best * size, size );
+        pos = best;
+    }
+    memcpy( base + pos * size, temp, size );
+
+    return pos;
+}
+
+// Copies "elem" into the heap of "num" elements with the given arity. Returns the new number of elements.
+//
+// **WARNING**: This function _assumes_ that "base" has room for at least "num + 1" elements.
+//
+static inline size_t array_dheap_push( void * base, size_t num, size_t size, size_t arity, const void * elem, int (*compare)(const void * item_one, const void * item_two) )
+{
+    memcpy( base + num * size, elem, size );
+    array_dheap_sift_up( base, size, num, arity, compare );
+
+    return num + 1;
+}
+
+// Removes the smallest element from the heap, copying it to "top" (if not NULL). Returns the new number of elements.
+//
+static inline size_t array_dheap_pop( void * base, size_t num, size_t size, size_t arity, void * top, int (*compare)(const void * item_one, const void * item_two) )
+{
+    if( num == 0 ) return 0;
+
+    if( top ) memcpy( top, base, size );
+    if( --num > 0 )
+    {
+        memcpy( base, base + num * size, size );
+        array_dheap_sift_down( base, num, size, 0, arity, compare );
+    }
+
+    return num;
+}
+
+// Rearranges an arbitrary array into a heap, in O(n) time.
+//
+static inline void array_dheapify( void * base, size_t num, size_t size, size_t arity, int (*compare)(const void * item_one, const void * item_two) )
+{
+    if( num < 2 ) return;
+
+    for( size_t pos = ( num - 2 ) / arity + 1; pos-- > 0; ) array_dheap_sift_down( base, num, size, pos, arity, compare );
+}
+
+// Restores the heap after the element at position "pos" has been changed in place (e.g. a task's deadline moved
+// earlier or later). Returns the element's new position.
+//
+static inline size_t array_dheap_update( void * base, size_t num, size_t size, size_t arity, size_t pos, int (*compare)(const void * item_one, const void * item_two) )
+{
+    if( pos > 0 && compare( base + pos * size, base + ( pos - 1 ) / arity * size ) < 0 ) return array_dheap_sift_up( base, size, pos, arity, compare );
+
+    return array_dheap_sift_down( base, num, size, pos, arity, compare );
+}
+
+// Binary heaps.
+//
+static inline size_t array_heap_push( void * base, size_t num, size_t size, const void * elem, int (*compare)(const void * item_one, const void * item_two) )
+{
+    return array_dheap_push( base, num, size, 2, elem, compare );
+}
+
+static inline size_t array_heap_pop( void * base, size_t num, size_t size, void * top, int (*compare)(const void * item_one, const void * item_two) )
+{
+    return array_dheap_pop( base, num, size, 2, top, compare );
+}
+
+static inline void array_heapify( void * base, size_t num, size_t size, int (*compare)(const void * item_one, const void * item_two) )
+{
+    array_dheapify( base, num, size, 2, compare );
+}
+
+static inline size_t array_heap_update( void * base, size_t num, size_t size, size_t pos, int (*compare)(const void * item_one, const void * item_two) )
+{
+    return array_dheap_update( base, num, size, 2, pos, compare );
+}
+
+// 4-ary heaps.
+//
+static inline size_t array_heap4_push( void * base, size_t num, size_t size, const void * elem, int (*compare)(const void * item_one, const void * item_two) )
+{
+    return array_dheap_push( base, num, size, 4, elem, compare );
+}
+
+static inline size_t array_heap4_pop( void * base, size_t num, size_t size, void * top, int (*compare)(const void * item_one, const void * item_two) )
+{
+    return array_dheap_pop( base, num, size, 4, top, compare );
+}
+
+static inline void array_heapify4( void * base, size_t num, size_t size, int (*compare)(const void * item_one, const void * item_two) )
+{
+    array_dheapify( base, num, size, 4, compare );
+}
+
+static inline size_t array_heap4_update( void * base, size_t num, size_t size, size_t pos, int (*compare)(const void * item_one, const void * item_two) )
+{
+    return array_dheap_update( base, num, size, 4, pos, compare );
+}
+
+// Finds where "key" belongs in the sorted array, like "array_lower_bound" ("upper" false) or "array_upper_bound" ("upper"
+// true), but starts by probing positions 0, 1, 3, 7, 15, ... from the front of the array (or from the back, if
+// "from_end" is set) and only binary searches the window where the probes cross "key". Finding a position "k" away
+// from the starting end takes O(log k) comparisons instead of O(log num), which is what makes merging runs that
+// barely overlap fast. Helper function used by "array_stable_sort".
+//
+static inline size_t array_gallop( const void * key, const void * base, size_t num, size_t size, bool upper, bool from_end, int (*compare)(const void * item_one, const void * item_two) )
+{
+    size_t lo = 0, hi = num;
+
+    // An element belongs before "key" if it compares less than "key" (lower bound) or not greater than it (upper bound).
+    //
+    int limit = upper ? 0 : -1;
+
+    if( !from_end )
+    {
+        size_t idx = 0;
+        while( idx < num && compare( base + idx * size, key ) <= limit )
+        {
+            lo = idx + 1;
+            idx = 2*idx + 1;
+        }
+        if( idx < num ) hi = idx;
+    }
+    else
+    {
+        size_t offset = 1;
+        while( offset <= num && compare( base + (num - offset) * size, key ) > limit )
+        {
+            hi = num - offset;
+            offset *= 2;
+        }
+        if( offset <= num ) lo = num - offset + 1;
+    }
+
+    return lo + ( upper ? array_upper_bound( key, base + lo * size, hi - lo, size, compare )
+                        : array_lower_bound( key, base + lo * size, hi - lo, size, compare ) );
+}
+
+// Set operations on two sorted arrays, written to "out" in sorted order. Elements that compare equal are matched up one
+// to one, so inputs with repeated elements are treated as multisets (as with C++'s "std::set_intersection" and
+// friends): an element that appears 3 times in one array and once in the other appears once in the intersection, 3
+// times in the union, and twice in the difference. Each function returns the number of elements written. Ex:
+//
+//     uint32_t x[] = {1,3,5,7}, y[] = {3,4,5,6}, out[8];
+//
+//     array_set_intersect( x, 4, y, 4, sizeof(x[0]), out, compare_uint32 );              // out is [3,5]
+//     array_set_union( x, 4, y, 4, sizeof(x[0]), out, compare_uint32 );                  // out is [1,3,4,5,6,7]
+//     array_set_difference( x, 4, y, 4, sizeof(x[0]), out, compare_uint32 );             // out is [1,7]
+//     array_set_symmetric_difference( x, 4, y, 4, sizeof(x[0]), out, compare_uint32 );   // out is [1,4,6,7]
+//
+// When one array is more than ARRAY_SET_GALLOP_RATIO times longer than the other, the longer one isn't walked element
+// by element: the stretch of it before the next element of the shorter one is found with "array_gallop" and skipped
+// (or copied) as a block, so intersecting 100 IDs with a million takes on the order of 100 * log(10000) comparisons
+// rather than a million. For "uint32_t" and "uint64_t" keys, see also "array_set_simd.h".
+//
+// **WARNING**: These functions _assume_ that "out" is large enough for the result (at most "num_one + num_two"
+// elements for a union or symmetric difference, "num_one" for an intersection or difference) and that it doesn't
+// overlap either input.
+
+#define ARRAY_SET_GALLOP_RATIO  16
+
+// Which elements "array_set_operation" keeps: those only in the first array, those only in the second, and those in
+// both (copied from the first).
+//
+#define ARRAY_SET_ONLY_ONE      1
+#define ARRAY_SET_ONLY_TWO      2
+#define ARRAY_SET_BOTH          4
+
+// Merges two sorted arrays, keeping the elements selected by "keep" (a combination of the flags above). Helper
+// function used by the set operations.
+//
+static inline size_t array_set_operation( const void * base_one, size_t num_one, const void * base_two, size_t num_two, size_t size, void * out, int keep, int (*compare)(const void * item_one, const void * item_two) )
+{
+    const void * end_one = base_one + num_one * size, * end_two = base_two + num_two * size;
+    bool gallop_one = num_one / ARRAY_SET_GALLOP_RATIO > num_two, gallop_two = num_two / ARRAY_SET_GALLOP_RATIO > num_one;
+    void * end_of_out = out;
+
+    while( base_one < end_one && base_two < end_two )
+    {
+        int order = compare( base_one, base_two );
+
+        if( order < 0 )
+        {
+            size_t run = gallop_one ? array_gallop( base_two, base_one, ( end_one - base_one ) / size, size, false, false, compare ) : 1;
+
+            if( keep & ARRAY_SET_ONLY_ONE )
+            {
+                memcpy( end_of_out, base_one, run * size );
+                end_of_out += run * size;
+            }
+            base_one += run * size;
+        }
+        else if( order > 0 )
+        {
+            size_t run = gallop_two ? array_gallop( base_one, base_two, ( end_two - base_two ) / size, size, false, false, compare ) : 1;
+
+            if( keep & ARRAY_SET_ONLY_TWO )
+            {
+                memcpy( end_of_out, base_two, run * size );
+                end_of_out += run * size;
+            }
+            base_two += run * size;
+        }
+        else
+        {
+            if( keep & ARRAY_SET_BOTH )
+            {
+                memcpy( end_of_out, base_one, size );
+                end_of_out += size;
+            }
+            base_one += size;
+            base_two += size;
+        }
+    }
+
+    // Whatever is left of either array can't be matched, so it's copied as one block or not at all.
+    //
+    if( keep & ARRAY_SET_ONLY_ONE )
+    {
+        memcpy( end_of_out, base_one, end_one - base_one );
+        end_of_out += end_one - base_one;
+    }
+    if( keep & ARRAY_SET_ONLY_TWO )
+    {
+        memcpy( end_of_out, base_two, end_two - base_two );
+        end_of_out += end_two - base_two;
+    }
+
+    return ( end_of_out - out ) / size;
+}
+
+// Writes the elements that are in both arrays (copied from "base_one").
+//
+static inline size_t array_set_intersect( const void * base_one, size_t num_one, const void * base_two, size_t num_two, size_t size, void * out, int (*compare)(const void * item_one, const void * item_two) )
+{
+    return array_set_operation( base_one, num_one, base_two, num_two, size, out, ARRAY_SET_BOTH, compare );
+}
+
+// Writes the elements that are in either array (those in both, once, copied from "base_one").
+//
+static inline size_t array_set_union( const void * base_one, size_t num_one, const void * base_two, size_t num_two, size_t size, void * out, int (*compare)(const void * item_one, const void * item_two) )
+{
+    return array_set_operation( base_one, num_one, base_two, num_two, size, out, ARRAY_SET_ONLY_ONE | ARRAY_SET_ONLY_TWO | ARRAY_SET_BOTH, compare );
+}
+
+// Writes the elements of "base_one" that aren't in "base_two".
+//
+static inline size_t array_set_difference( const void * base_one, size_t num_one, const void * base_two, size_t num_two, size_t size, void * out, int (*compare)(const void * item_one, const void * item_two) )
+{
+    return array_set_operation( base_one, num_one, base_two, num_two, size, out, ARRAY_SET_ONLY_ONE, compare );
+}
+
+// Writes the elements that are in one array but not the other.
+//
+static inline size_t array_set_symmetric_difference( const void * base_one, size_t num_one, const void * base_two, size_t num_two, size_t size, void * out, int (*compare)(const void * item_one, const void * item_two) )
+{
+    return array_set_operation( base_one, num_one, base_two, num_two, size, out, ARRAY_SET_ONLY_ONE | ARRAY_SET_ONLY_TWO, compare );
+}
+
+// Number of consecutive elements that one side of a merge must win before "array_stable_sort" switches to galloping.
+// The threshold adapts as the sort runs, rising when galloping doesn't pay off and falling when it does.
+//
+#define STABLE_SORT_MIN_GALLOP  7
+
+// Longest the stack of pending runs can get. Runs on the stack grow at least as fast as the Fibonacci numbers, so 85
+// is enough for any array that fits in memory.
+//
+#define STABLE_SORT_MAX_RUNS    85
+
+// State shared by the helper functions of "array_stable_sort".
+//
+typedef struct stable_sort_t
+{
+    void *      base;
+    size_t      size;
+    void *      scratch;
+    size_t      min_gallop;
+    int         (*compare)(const void * item_one, const void * item_two);
+    size_t      num_runs;
+    struct
+    {
+        size_t  start;
+        size_t  len;
+    } runs[STABLE_SORT_MAX_RUNS];
+} stable_sort_t;
+
+// Merges the adjacent runs "[a, a + len_a)" and "[a + len_a, a + len_a + len_b)" from front to back, with the first
+// run copied out to "scratch" (so len_a should be the smaller of the two). Helper function used by "array_stable_sort".
+//
+static inline void stable_sort_merge_low( stable_sort_t * sort, void * a, size_t len_a, size_t len_b )
+{
+    size_t size = sort->size, wins_a = 0, wins_b = 0;
+    void * out = a, * b = a + len_a * size, * left = sort->scratch;
+
+    memcpy( left, a, len_a * size );
+
+    while( len_a > 0 && len_b > 0 )
+    {
+        if( wins_a >= sort->min_gallop || wins_b >= sort->min_gallop )
+        {
+            // One side has been winning consistently, so instead of comparing one element at a time, find how far
+            // each side's winning streak goes and move it as a block.
+            //
+            size_t run_a = array_gallop( b, left, len_a, size, true, false, sort->compare );
+            memcpy( out, left, run_a * size );
+            out += run_a * size;
+            left += run_a * size;
+            len_a -= run_a;
+            if( len_a == 0 ) break;
+
+            size_t run_b = array_gallop( left, b, len_b, size, false, false, sort->compare );
+            memmove( out, b, run_b * size );
+            out += run_b * size;
+            b += run_b * size;
+            len_b -= run_b;
+
+            if( run_a < STABLE_SORT_MIN_GALLOP && run_b < STABLE_SORT_MIN_GALLOP )
+            {
+                sort->min_gallop++;
+                wins_a = wins_b = 0;
+            }
+            else if( sort->min_gallop > 1 ) sort->min_gallop--;
+        }
+        else if( sort->compare( b, left ) < 0 )
+        {
+            memcpy( out, b, size );
+            out += size;
+            b += size;
+            len_b--;
+            wins_b++;
+            wins_a = 0;
+        }
+        else
+        {
+            memcpy( out, left, size );
+            out += size;
+            left += size;
+            len_a--;
+            wins_a++;
+            wins_b = 0;
+        }
+    }
+
+    // Whatever is left of the second run is already in place.
+    //
+    memcpy( out, left, len_a * size );
+}
+
+// Merges the adjacent runs "[a, a + len_a)" and "[a + len_a, a + len_a + len_b)" from back to front, with the second
+// run copied out to "scratch" (so len_b should be the smaller of the two). Helper function used by "array_stable_sort".
+//
+static inline void stable_sort_merge_high( stable_sort_t * sort, void * a, size_t len_a, size_t len_b )
+{
+    size_t size = sort->size, wins_a = 0, wins_b = 0;
+    void * right = sort->scratch;
+
+    memcpy( right, a + len_a * size, len_b * size );
+
+    // The last remaining elements of each run are at "a + (len_a - 1) * size" and "right + (len_b - 1) * size", and the
+    // next output position is "a + (len_a + len_b - 1) * size".
+    //
+    while( len_a > 0 && len_b > 0 )
+    {
+        if( wins_a >= sort->min_gallop || wins_b >= sort->min_gallop )
+        {
+            size_t run_a = len_a - array_gallop( right + (len_b - 1) * size, a, len_a, size, true, true, sort->compare );
+            memmove( a + (len_a + len_b - run_a) * size, a + (len_a - run_a) * size, run_a * size );
+            len_a -= run_a;
+            if( len_a == 0 ) break;
+
+            size_t run_b = len_b - array_gallop( a + (len_a - 1) * size, right, len_b, size, false, true, sort->compare );
+            memcpy( a + (len_a + len_b - run_b) * size, right + (len_b - run_b) * size, run_b * size );
+            len_b -= run_b;
+
+            if( run_a < STABLE_SORT_MIN_GALLOP && run_b < STABLE_SORT_MIN_GALLOP )
+            {
+                sort->min_gallop++;
+                wins_a = wins_b = 0;
+            }
+            else if( sort->min_gallop > 1 ) sort->min_gallop--;
+        }
+        else if( sort->compare( right + (len_b - 1) * size, a + (len_a - 1) * size ) < 0 )
+        {
+            memcpy( a + (len_a + len_b - 1) * size, a + (len_a - 1) * size, size );
+            len_a--;
+            wins_a++;
+            wins_b = 0;
+        }
+        else
+        {
+            memcpy( a + (len_a + len_b - 1) * size, right + (len_b - 1) * size, size );
+            len_b--;
+            wins_b++;
+            wins_a = 0;
+        }
+    }
+
+    // Whatever is left of the first run is already in place.
+    //
+    memcpy( a, right, len_b * size );
+}
+
+// Merges the runs at positions "idx" and "idx + 1" of the run stack. Helper function used by "array_stable_sort".
+//
+static inline void stable_sort_merge_at( stable_sort_t * sort, size_t idx )
+{
+    size_t size = sort->size;
+    void * a = sort->base + sort->runs[idx].start * size;
+    size_t len_a = sort->runs[idx].len, len_b = sort->runs[idx + 1].len;
+    void * b = a + len_a * size;
+
+    sort->runs[idx].len = len_a + len_b;
+    if( idx + 2 < sort->num_runs ) sort->runs[idx + 1] = sort->runs[idx + 2];
+    sort->num_runs--;
+
+    // Elements at the start of the first run that are no greater than the first element of the second run, and
+    // elements at the end of the second run that are no less than the last element of the first run, are already in
+    // place. Only what's left in between needs to be merged.
+    //
+    size_t skip = array_gallop( b, a, len_a, size, true, false, sort->compare );
+    a += skip * size;
+    len_a -= skip;
+    if( len_a == 0 ) return;
+
+    len_b = array_gallop( b - size, b, len_b, size, false, true, sort->compare );
+    if( len_b == 0 ) return;
+
+    if( len_a <= len_b ) stable_sort_merge_low( sort, a, len_a, len_b );
+    else stable_sort_merge_high( sort, a, len_a, len_b );
+}
+
+// Sorts the array in the same manner as "qsort", except that the sort is _stable_: elements that compare equal keep
+// the order they had before the sort. It's a natural merge sort in the style of Python's and Java's "TimSort": the
+// array is split into the runs that are already in order (runs in strictly descending order are reversed in place),
+// short runs are extended with a binary insertion sort, and runs are merged with galloping merges. Sorted and nearly
+// sorted input (e.g. records that arrive roughly in time order) takes close to linear time; random input takes
+// O(n log n), like "qsort".
+//
+// "scratch" must be able to hold at least "num / 2" elements. See "array_stable_sort" for a version that allocates it.
+//
+// **WARNING**: This function copies array elements to different locations in memory. Because of this, it will
+// break any variables that hold pointers to any array elements, since those pointers will point to different
+// pieces of data.
+//
+static inline void array_stable_sort_with_scratch( void * base, size_t num, size_t size, void * scratch, int (*compare)(const void * item_one, const void * item_two) )
+{
+    stable_sort_t sort = { .base = base, .size = size, .scratch = scratch, .min_gallop = STABLE_SORT_MIN_GALLOP, .compare = compare };
+    char temp[size];
+    size_t min_run = num, start = 0;
+
+    // Pick a minimum run length between 32 and 64 such that "num / min_run" is a power of two, or a little less than
+    // one, so the final merges are balanced.
+    //
+    bool remainder = false;
+    while( min_run >= 64 )
+    {
+        remainder |= min_run & 1;
+        min_run >>= 1;
+    }
+    min_run += remainder;
+
+    while( start < num )
+    {
+        // (1) Find the run starting at "start".
+        //
+        void * first = base + start * size;
+        size_t len = 1;
+
+        if( start + 1 < num )
+        {
+            len = 2;
+            if( compare( first + size, first ) < 0 )
+            {
+                while( start + len < num && compare( first + len * size, first + (len - 1) * size ) < 0 ) len++;
+                array_reverse( first, len, size );
+            }
+            else
+            {
+                while( start + len < num && compare( first + len * size, first + (len - 1) * size ) >= 0 ) len++;
+            }
+        }
+
+        // (2) Extend short runs to "min_run" elements with a binary insertion sort.
+        //
+        if( len < min_run )
+        {
+            size_t end = num - start < min_run ? num - start : min_run;
+            for( ; len < end; len++ )
+            {
+                memcpy( temp, first + len * size, size );
+                array_sorted_insert( first, len, size, temp, compare );
+            }
+        }
+
+        sort.runs[sort.num_runs].start = start;
+        sort.runs[sort.num_runs].len = len;
+        sort.num_runs++;
+        start += len;
+
+        // (3) Merge runs until, from the top of the stack down, each run is longer than the next two combined. That keeps
+        // merges balanced and the stack short.
+        //
+        while( sort.num_runs > 1 )
+        {
+            size_t idx = sort.num_runs - 2;
+
+            if( ( idx > 0 && sort.runs[idx - 1].len <= sort.runs[idx].len + sort.runs[idx + 1].len ) ||
+                ( idx > 1 && sort.runs[idx - 2].len <= sort.runs[idx - 1].len + sort.runs[idx].len ) )
+            {
+                if( sort.runs[idx - 1].len < sort.runs[idx + 1].len ) idx--;
+            }
+            else if( sort.runs[idx].len > sort.runs[idx + 1].len ) break;
+
+            stable_sort_merge_at( &sort, idx );
+        }
+    }
+
+    // (4) Merge whatever runs are left.
+    //
+    while( sort.num_runs > 1 )
+    {
+        size_t idx = sort.num_runs - 2;
+        if( idx > 0 && sort.runs[idx - 1].len < sort.runs[idx + 1].len ) idx--;
+        stable_sort_merge_at( &sort, idx );
+    }
+}
+
+// Stable sort with the standard "qsort" parameters. See "array_stable_sort_with_scratch". Allocates the scratch space
+// (only if the array is long enough to need merging) and returns "false", without touching the array, if it couldn't
+// be allocated.
+//
+static inline bool array_stable_sort( void * base, size_t num, size_t size, int (*compare)(const void * item_one, const void * item_two) )
+{
+    void * scratch = NULL;
+
+    if( num >= 64 )
+    {
+        scratch = malloc( num / 2 * size );
+        if( scratch == NULL ) return false;
+    }
+
+    array_stable_sort_with_scratch( base, num, size, scratch, compare );
+    free( scratch );
+
+    return true;
+}
+
 #endif // ARRAY_METHODS_H
\ No newline at end of file
@@ -0,0 +1,187 @@
+#ifndef ARRAY_SET_SIMD_H
+#define ARRAY_SET_SIMD_H
+
+#include <stdint.h>     // For uint32_t, uint64_t
+#include <stddef.h>     // For size_t
+
+// Intersection of sorted arrays of "uint32_t" or "uint64_t" keys, comparing a block of keys from each array at once
+// with SIMD instructions instead of one pair at a time, like "array_set_intersect" does through its comparison
+// function. Each step loads a block of keys from each array (4 x 4 "uint32_t"s with SSE2, 8 x 8 with AVX2; 2 x 2
+// "uint64_t"s with SSE4.1, 4 x 4 with AVX2), compares every key of one block with every key of the other (by comparing
+// against rotated copies of the second block), and writes out the keys of the first block that matched. Whichever
+// block ends with the smaller key is then replaced by the next one (or both, if they end with the same key), so there
+// are no unpredictable branches on individual keys. Once either array has less than a block left, the rest is done
+// one key at a time.
+//
+// "array_set_intersect_u32" and "array_set_intersect_u64" pick the widest version the CPU supports, at run time (on x86
+// with GCC or Clang; elsewhere, they use the scalar version). The versions for each instruction set can also be called
+// directly. Ex:
+//
+//     uint32_t matches[MAX_IDS];
+//     size_t num_matches = array_set_intersect_u32( ids_one, num_one, ids_two, num_two, matches );
+//
+// **WARNING**: Unlike "array_set_intersect", these functions require _strictly_ increasing keys (no key repeated within
+// an array), and they _assume_ that "out" has room for the smaller of "num_one" and "num_two" keys.
+
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#define ARRAY_SET_SIMD  1
+#include <immintrin.h>
+#else
+#define ARRAY_SET_SIMD  0
+#endif
+
+// Finishes an intersection one key at a time, starting at "idx_one" and "idx_two", with "count" keys written so far.
+// Also the whole of the scalar version.
+//
+#define ARRAY_SET_INTERSECT_SCALAR(base_one, num_one, idx_one, base_two, num_two, idx_two, out, count)    \
+    while( idx_one < num_one && idx_two < num_two )                                                     \
+    {                                                                                                   \
+        if( base_one[idx_one] < base_two[idx_two] ) idx_one++;                                          \
+        else if( base_one[idx_one] > base_two[idx_two] ) idx_two++;                                     \
+        else                                                                                            \
+        {                                                                                               \
+            out[count++] = base_one[idx_one++];                                                         \
+            idx_two++;                                                                                  \
+        }                                                                                               \
+    }
+
+// Writes the keys of the block of "base_one" at "idx_one" whose bits are set in "mask", and moves on to the next block
+// of whichever array's block ended with the smaller key. Helper macro used by the SIMD versions.
+//
+#define ARRAY_SET_INTERSECT_BLOCK(base_one, idx_one, base_two, idx_two, out, count, mask, block)    \
+    for( unsigned bits = mask; bits; bits &= bits - 1 ) out[count++] = base_one[idx_one + __builtin_ctz( bits )]; \
+    {                                                                                               \
+        __typeof__(base_one[0]) last_one = base_one[idx_one + block - 1], last_two = base_two[idx_two + block - 1]; \
+        idx_one += ( last_one <= last_two ) * block;                                                \
+        idx_two += ( last_two <= last_one ) * block;                                                \
+    }
+
+static inline size_t array_set_intersect_u32_scalar( const uint32_t * base_one, size_t num_one, const uint32_t * base_two, size_t num_two, uint32_t * out )
+{
+    size_t idx_one = 0, idx_two = 0, count = 0;
+
+    ARRAY_SET_INTERSECT_SCALAR( base_one, num_one, idx_one, base_two, num_two, idx_two, out, count )
+
+    return count;
+}
+
+static inline size_t array_set_intersect_u64_scalar( const uint64_t * base_one, size_t num_one, const uint64_t * base_two, size_t num_two, uint64_t * out )
+{
+    size_t idx_one = 0, idx_two = 0, count = 0;
+
+    ARRAY_SET_INTERSECT_SCALAR( base_one, num_one, idx_one, base_two, num_two, idx_two, out, count )
+
+    return count;
+}
+
+#if ARRAY_SET_SIMD
+
+__attribute__((target("sse2")))
+static inline size_t array_set_intersect_u32_sse2( const uint32_t * base_one, size_t num_one, const uint32_t * base_two, size_t num_two, uint32_t * out )
+{
+    size_t idx_one = 0, idx_two = 0, count = 0;
+
+    while( idx_one + 4 <= num_one && idx_two + 4 <= num_two )
+    {
+        __m128i one = _mm_loadu_si128( (const __m128i *)( base_one + idx_one ) );
+        __m128i two = _mm_loadu_si128( (const __m128i *)( base_two + idx_two ) );
+        __m128i match = _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi32( one, two ),
+                                                    _mm_cmpeq_epi32( one, _mm_shuffle_epi32( two, _MM_SHUFFLE(0,3,2,1) ) ) ),
+                                      _mm_or_si128( _mm_cmpeq_epi32( one, _mm_shuffle_epi32( two, _MM_SHUFFLE(1,0,3,2) ) ),
+                                                    _mm_cmpeq_epi32( one, _mm_shuffle_epi32( two, _MM_SHUFFLE(2,1,0,3) ) ) ) );
+
+        ARRAY_SET_INTERSECT_BLOCK( base_one, idx_one, base_two, idx_two, out, count, _mm_movemask_ps( _mm_castsi128_ps( match ) ), 4 )
+    }
+    ARRAY_SET_INTERSECT_SCALAR( base_one, num_one, idx_one, base_two, num_two, idx_two, out, count )
+
+    return count;
+}
+
+__attribute__((target("avx2")))
+static inline size_t array_set_intersect_u32_avx2( const uint32_t * base_one, size_t num_one, const uint32_t * base_two, size_t num_two, uint32_t * out )
+{
+    size_t idx_one = 0, idx_two = 0, count = 0;
+
+    while( idx_one + 8 <= num_one && idx_two + 8 <= num_two )
+    {
+        __m256i one = _mm256_loadu_si256( (const __m256i *)( base_one + idx_one ) );
+        __m256i two = _mm256_loadu_si256( (const __m256i *)( base_two + idx_two ) );
+        __m256i swapped = _mm256_permute2x128_si256( two, two, 1 );     // The two halves of "two" exchanged
+        __m256i match = _mm256_or_si256(
+            _mm256_or_si256( _mm256_or_si256( _mm256_cmpeq_epi32( one, two ),
+                                              _mm256_cmpeq_epi32( one, _mm256_shuffle_epi32( two, _MM_SHUFFLE(0,3,2,1) ) ) ),
+                             _mm256_or_si256( _mm256_cmpeq_epi32( one, _mm256_shuffle_epi32( two, _MM_SHUFFLE(1,0,3,2) ) ),
+                                              _mm256_cmpeq_epi32( one, _mm256_shuffle_epi32( two, _MM_SHUFFLE(2,1,0,3) ) ) ) ),
+            _mm256_or_si256( _mm256_or_si256( _mm256_cmpeq_epi32( one, swapped ),
+                                              _mm256_cmpeq_epi32( one, _mm256_shuffle_epi32( swapped, _MM_SHUFFLE(0,3,2,1) ) ) ),
+                             _mm256_or_si256( _mm256_cmpeq_epi32( one, _mm256_shuffle_epi32( swapped, _MM_SHUFFLE(1,0,3,2) ) ),
+                                              _mm256_cmpeq_epi32( one, _mm256_shuffle_epi32( swapped, _MM_SHUFFLE(2,1,0,3) ) ) ) ) );
+
+        ARRAY_SET_INTERSECT_BLOCK( base_one, idx_one, base_two, idx_two, out, count, _mm256_movemask_ps( _mm256_castsi256_ps( match ) ), 8 )
+    }
+    ARRAY_SET_INTERSECT_SCALAR( base_one, num_one, idx_one, base_two, num_two, idx_two, out, count )
+
+    return count;
+}
+
+__attribute__((target("sse4.1")))
+static inline size_t array_set_intersect_u64_sse41( const uint64_t * base_one, size_t num_one, const uint64_t * base_two, size_t num_two, uint64_t * out )
+{
+    size_t idx_one = 0, idx_two = 0, count = 0;
+
+    while( idx_one + 2 <= num_one && idx_two + 2 <= num_two )
+    {
+        __m128i one = _mm_loadu_si128( (const __m128i *)( base_one + idx_one ) );
+        __m128i two = _mm_loadu_si128( (const __m128i *)( base_two + idx_two ) );
+        __m128i match = _mm_or_si128( _mm_cmpeq_epi64( one, two ), _mm_cmpeq_epi64( one, _mm_shuffle_epi32( two, _MM_SHUFFLE(1,0,3,2) ) ) );
+
+        ARRAY_SET_INTERSECT_BLOCK( base_one, idx_one, base_two, idx_two, out, count, _mm_movemask_pd( _mm_castsi128_pd( match ) ), 2 )
+    }
+    ARRAY_SET_INTERSECT_SCALAR( base_one, num_one, idx_one, base_two, num_two, idx_two, out, count )
+
+    return count;
+}
+
+__attribute__((target("avx2")))
+static inline size_t array_set_intersect_u64_avx2( const uint64_t * base_one, size_t num_one, const uint64_t * base_two, size_t num_two, uint64_t * out )
+{
+    size_t idx_one = 0, idx_two = 0, count = 0;
+
+    while( idx_one + 4 <= num_one && idx_two + 4 <= num_two )
+    {
+        __m256i one = _mm256_loadu_si256( (const __m256i *)( base_one + idx_one ) );
+        __m256i two = _mm256_loadu_si256( (const __m256i *)( base_two + idx_two ) );
+        __m256i match = _mm256_or_si256(
+            _mm256_or_si256( _mm256_cmpeq_epi64( one, two ),
+                             _mm256_cmpeq_epi64( one, _mm256_permute4x64_epi64( two, _MM_SHUFFLE(0,3,2,1) ) ) ),
+            _mm256_or_si256( _mm256_cmpeq_epi64( one, _mm256_permute4x64_epi64( two, _MM_SHUFFLE(1,0,3,2) ) ),
+                             _mm256_cmpeq_epi64( one, _mm256_permute4x64_epi64( two, _MM_SHUFFLE(2,1,0,3) ) ) ) );
+
+        ARRAY_SET_INTERSECT_BLOCK( base_one, idx_one, base_two, idx_two, out, count, _mm256_movemask_pd( _mm256_castsi256_pd( match ) ), 4 )
+    }
+    ARRAY_SET_INTERSECT_SCALAR( base_one, num_one, idx_one, base_two, num_two, idx_two, out, count )
+
+    return count;
+}
+
+#endif // ARRAY_SET_SIMD
+
+static inline size_t array_set_intersect_u32( const uint32_t * base_one, size_t num_one, const uint32_t * base_two, size_t num_two, uint32_t * out )
+{
+#if ARRAY_SET_SIMD
+    if( __builtin_cpu_supports( "avx2" ) ) return array_set_intersect_u32_avx2( base_one, num_one, base_two, num_two, out );
+    if( __builtin_cpu_supports( "sse2" ) ) return array_set_intersect_u32_sse2( base_one, num_one, base_two, num_two, out );
+#endif
+    return array_set_intersect_u32_scalar( base_one, num_one, base_two, num_two, out );
+}
+
+static inline size_t array_set_intersect_u64( const uint64_t * base_one, size_t num_one, const uint64_t * base_two, size_t num_two, uint64_t * out )
+{
+#if ARRAY_SET_SIMD
+    if( __builtin_cpu_supports( "avx2" ) ) return array_set_intersect_u64_avx2( base_one, num_one, base_two, num_two, out );
+    if( __builtin_cpu_supports( "sse4.1" ) ) return array_set_intersect_u64_sse41( base_one, num_one, base_two, num_two, out );
+#endif
+    return array_set_intersect_u64_scalar( base_one, num_one, base_two, num_two, out );
+}
+
+#endif // ARRAY_SET_SIMD_H
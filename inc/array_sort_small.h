@@ -0,0 +1,204 @@
+#ifndef ARRAY_SORT_SMALL_H
+#define ARRAY_SORT_SMALL_H
+
+#include <stdint.h>     // For int32_t, uint32_t, int64_t, uint64_t
+#include <stdlib.h>     // For qsort
+
+// Sorting networks for small arrays (up to ARRAY_SORT_SMALL_MAX elements). A sorting network is a fixed sequence of
+// "compare-exchange" steps (put the two elements at positions i and j in order) that sorts any input of a given length.
+// Since the sequence only depends on the length, never on the data:
+//     - for a length known at compile time, every step can be laid out in advance, with no loop and no branch;
+//     - each compare-exchange on a primitive type compiles to a min and a max (conditional moves), so the sort takes
+//       the same time for every input and never pays for a mispredicted branch.
+// For arrays of 4-32 elements this is several times faster than "qsort" (which makes a function call per comparison)
+// or an insertion sort (whose inner loop branches on the data).
+//
+// The networks are Batcher's merge-exchange networks (Knuth, TAOCP Vol. 3, Algorithm 5.2.2M), which work for any
+// length. The typed functions ("array_sort_small_u32", etc.) switch on "num" to a copy of the network specialized for
+// each length from 2 to 32, so that switch is the only branch taken at run time. Ex:
+//
+//     uint32_t scores[12] = { ... };
+//     array_sort_small_u32( scores, LEN_ARRAY(scores) );
+//
+// Use "ARRAY_SORT_SMALL_DEFINE" to generate the same functions for another type that supports "<". For any other
+// element type, "array_sort_small" runs the same networks through a "compare" function, in the same manner as
+// "qsort". In C++14 and later, "array_sort_small" is also a "constexpr" template over built-in arrays, so small tables
+// can be sorted at compile time.
+//
+// Arrays longer than ARRAY_SORT_SMALL_MAX are handed to "qsort". The networks are _not_ stable, which doesn't matter
+// for primitive keys (equal keys can't be told apart). Floating point arrays must not contain NaN.
+
+#define ARRAY_SORT_SMALL_MAX    32
+
+// The largest power of two that is less than "n" (for 2 <= n <= 32).
+//
+#define ARRAY_SORT_SMALL_TOP(n) ( (n) > 16 ? 16u : (n) > 8 ? 8u : (n) > 4 ? 4u : (n) > 2 ? 2u : 1u )
+
+// The merge-exchange network for "n" elements, expanded as calls to "exchange(context, i, j)". Algorithm M's loops over
+// "p" and "q" are written out here (every power of two up to 16) so that, when "n" is a constant, every loop bound is
+// too, and the compiler can unroll the whole network into straight-line code. Helper macros for
+// "ARRAY_SORT_SMALL_NETWORK".
+//
+#define ARRAY_SORT_SMALL_PASS(n, exchange, context, d, r, p)                                \
+    _Pragma("GCC unroll 32")                                                                \
+    for( size_t idx_ = 0; idx_ + (d) < (n); idx_++ )                                        \
+    {                                                                                       \
+        if( ( idx_ & (p) ) == (r) ) exchange( context, idx_, idx_ + (d) );                  \
+    }
+
+#define ARRAY_SORT_SMALL_MERGE(n, exchange, context, p, q)                                  \
+    if( (q) > (p) && (q) <= ARRAY_SORT_SMALL_TOP(n) )                                       \
+    {                                                                                       \
+        ARRAY_SORT_SMALL_PASS( n, exchange, context, (q) - (p), p, p )                      \
+    }
+
+#define ARRAY_SORT_SMALL_LEVEL(n, exchange, context, p)                                     \
+    if( (p) <= ARRAY_SORT_SMALL_TOP(n) )                                                    \
+    {                                                                                       \
+        ARRAY_SORT_SMALL_PASS( n, exchange, context, p, 0, p )                              \
+        ARRAY_SORT_SMALL_MERGE( n, exchange, context, p, 16 )                               \
+        ARRAY_SORT_SMALL_MERGE( n, exchange, context, p, 8 )                                \
+        ARRAY_SORT_SMALL_MERGE( n, exchange, context, p, 4 )                                \
+        ARRAY_SORT_SMALL_MERGE( n, exchange, context, p, 2 )                                \
+    }
+
+// Sorts "n" elements (2 <= n <= 32) by calling "exchange(context, i, j)" for each step of the network, where "exchange"
+// must put the elements at positions i and j (i < j) in order.
+//
+#define ARRAY_SORT_SMALL_NETWORK(n, exchange, context)                                      \
+    do                                                                                      \
+    {                                                                                       \
+        ARRAY_SORT_SMALL_LEVEL( n, exchange, context, 16 )                                  \
+        ARRAY_SORT_SMALL_LEVEL( n, exchange, context, 8 )                                   \
+        ARRAY_SORT_SMALL_LEVEL( n, exchange, context, 4 )                                   \
+        ARRAY_SORT_SMALL_LEVEL( n, exchange, context, 2 )                                   \
+        ARRAY_SORT_SMALL_LEVEL( n, exchange, context, 1 )                                   \
+    } while( 0 )
+
+// Expands to "case n: function( base, n ); break;" for every n from 2 to 32, so that "function" is inlined with a
+// constant length in each case.
+//
+#define ARRAY_SORT_SMALL_CASE(function, n)      case n: function( base, n ); break;
+#define ARRAY_SORT_SMALL_CASES(function)                                                                                        \
+    ARRAY_SORT_SMALL_CASE(function, 2)  ARRAY_SORT_SMALL_CASE(function, 3)  ARRAY_SORT_SMALL_CASE(function, 4)                  \
+    ARRAY_SORT_SMALL_CASE(function, 5)  ARRAY_SORT_SMALL_CASE(function, 6)  ARRAY_SORT_SMALL_CASE(function, 7)                  \
+    ARRAY_SORT_SMALL_CASE(function, 8)  ARRAY_SORT_SMALL_CASE(function, 9)  ARRAY_SORT_SMALL_CASE(function, 10)                 \
+    ARRAY_SORT_SMALL_CASE(function, 11) ARRAY_SORT_SMALL_CASE(function, 12) ARRAY_SORT_SMALL_CASE(function, 13)                 \
+    ARRAY_SORT_SMALL_CASE(function, 14) ARRAY_SORT_SMALL_CASE(function, 15) ARRAY_SORT_SMALL_CASE(function, 16)                 \
+    ARRAY_SORT_SMALL_CASE(function, 17) ARRAY_SORT_SMALL_CASE(function, 18) ARRAY_SORT_SMALL_CASE(function, 19)                 \
+    ARRAY_SORT_SMALL_CASE(function, 20) ARRAY_SORT_SMALL_CASE(function, 21) ARRAY_SORT_SMALL_CASE(function, 22)                 \
+    ARRAY_SORT_SMALL_CASE(function, 23) ARRAY_SORT_SMALL_CASE(function, 24) ARRAY_SORT_SMALL_CASE(function, 25)                 \
+    ARRAY_SORT_SMALL_CASE(function, 26) ARRAY_SORT_SMALL_CASE(function, 27) ARRAY_SORT_SMALL_CASE(function, 28)                 \
+    ARRAY_SORT_SMALL_CASE(function, 29) ARRAY_SORT_SMALL_CASE(function, 30) ARRAY_SORT_SMALL_CASE(function, 31)                 \
+    ARRAY_SORT_SMALL_CASE(function, 32)
+
+// Defines "array_sort_small_<suffix>( type * base, size_t num )" for a type that supports "<".
+//
+#define ARRAY_SORT_SMALL_DEFINE(suffix, type)                                                                                   \
+    static inline int array_sort_small_compare_##suffix( const void * item_one, const void * item_two )                         \
+    {                                                                                                                           \
+        type one = *(const type *)item_one, two = *(const type *)item_two;                                                      \
+        return ( two < one ) - ( one < two );                                                                                   \
+    }                                                                                                                           \
+                                                                                                                                \
+    static inline __attribute__((always_inline)) void array_sort_small_exchange_##suffix( type * base, size_t i, size_t j )     \
+    {                                                                                                                           \
+        type one = base[i], two = base[j];                                                                                      \
+        base[i] = two < one ? two : one;                                                                                        \
+        base[j] = two < one ? one : two;                                                                                        \
+    }                                                                                                                           \
+                                                                                                                                \
+    static inline __attribute__((always_inline)) void array_sort_small_network_##suffix( type * base, size_t num )              \
+    {                                                                                                                           \
+        ARRAY_SORT_SMALL_NETWORK( num, array_sort_small_exchange_##suffix, base );                                              \
+    }                                                                                                                           \
+                                                                                                                                \
+    static inline void array_sort_small_##suffix( type * base, size_t num )                                                     \
+    {                                                                                                                           \
+        switch( num )                                                                                                           \
+        {                                                                                                                       \
+            case 0: case 1: break;                                                                                              \
+            ARRAY_SORT_SMALL_CASES( array_sort_small_network_##suffix )                                                         \
+            default: qsort( base, num, sizeof(type), array_sort_small_compare_##suffix );                                       \
+        }                                                                                                                       \
+    }
+
+ARRAY_SORT_SMALL_DEFINE(i32, int32_t)
+ARRAY_SORT_SMALL_DEFINE(u32, uint32_t)
+ARRAY_SORT_SMALL_DEFINE(i64, int64_t)
+ARRAY_SORT_SMALL_DEFINE(u64, uint64_t)
+ARRAY_SORT_SMALL_DEFINE(float, float)
+ARRAY_SORT_SMALL_DEFINE(double, double)
+
+// State passed to "array_sort_small_exchange" by "array_sort_small".
+//
+typedef struct array_sort_small_context_t
+{
+    char *      base;
+    size_t      size;
+    int         (*compare)(const void * item_one, const void * item_two);
+} array_sort_small_context_t;
+
+static inline void array_sort_small_exchange( const array_sort_small_context_t * context, size_t i, size_t j )
+{
+    char * one = context->base + i * context->size, * two = context->base + j * context->size;
+
+    if( context->compare( one, two ) > 0 )
+    {
+        for( size_t idx = 0; idx < context->size; idx++ )
+        {
+            char temp = one[idx];
+            one[idx] = two[idx];
+            two[idx] = temp;
+        }
+    }
+}
+
+// Sorts an array of any element type with the same networks as the typed functions, using "compare" in the same manner
+// as "qsort". Calling "compare" costs a branch per step, so this is mostly useful as a base case for other sorts: the
+// number of comparisons is fixed for each length (191 for 32 elements, versus up to 496 for an insertion sort).
+//
+static inline void array_sort_small( void * base, size_t num, size_t size, int (*compare)(const void * item_one, const void * item_two) )
+{
+    array_sort_small_context_t context = { (char *)base, size, compare };
+
+    if( num < 2 ) return;
+    if( num > ARRAY_SORT_SMALL_MAX )
+    {
+        qsort( base, num, size, compare );
+        return;
+    }
+
+    ARRAY_SORT_SMALL_NETWORK( num, array_sort_small_exchange, &context );
+}
+
+#if defined(__cplusplus) && __cplusplus >= 201402L
+
+template <typename T>
+constexpr void array_sort_small_exchange( T * base, size_t i, size_t j )
+{
+    T one = base[i], two = base[j];
+    base[i] = two < one ? two : one;
+    base[j] = two < one ? one : two;
+}
+
+// Sorts a built-in array of up to 32 elements of a type that supports "<". Can be evaluated at compile time. Ex:
+//
+//     constexpr int median_of_five( int a, int b, int c, int d, int e )
+//     {
+//         int values[] = { a, b, c, d, e };
+//         array_sort_small( values );
+//         return values[2];
+//     }
+//     static_assert( median_of_five( 3, 1, 4, 1, 5 ) == 3, "" );
+//
+template <typename T, size_t N>
+constexpr void array_sort_small( T (&base)[N] )
+{
+    static_assert( N <= ARRAY_SORT_SMALL_MAX, "array_sort_small: more than ARRAY_SORT_SMALL_MAX elements" );
+    if( N >= 2 ) ARRAY_SORT_SMALL_NETWORK( N, array_sort_small_exchange<T>, base );
+}
+
+#endif // __cplusplus
+
+#endif // ARRAY_SORT_SMALL_H
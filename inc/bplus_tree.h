@@ -0,0 +1,794 @@
+#ifndef BPLUS_TREE_H
+#define BPLUS_TREE_H
+
+#include <stdint.h>     // For uint8_t
+#include <stdlib.h>     // For aligned_alloc, free
+#include <string.h>     // For memcpy, memmove
+#include <stdbool.h>    // For bool
+#include "array_methods.h"  // For array_lower_bound, array_upper_bound
+
+// An ordered set of fixed-size elements, kept in a B+ tree: every element lives in a leaf, the leaves are linked to
+// each other in order, and the nodes above them ("branches") hold only copies of the keys that route a search to the
+// right leaf. Inserting into a sorted array ("array_sorted_insert") or a sorted list ("linked_list_sorted_insert")
+// takes O(n) time; here, inserting, removing and finding an element each take O(log n), and so does finding where a
+// range starts, after which the range is read leaf by leaf, in order.
+//
+// Every node is "node_bytes" bytes (a multiple of 64, allocated on a 64-byte boundary), and holds as many elements (or
+// keys and child pointers) as fit, stored inline, so a search binary-searches one block of memory per level instead of
+// following a pointer per element like a binary tree does. Small nodes (a few cache lines) make each level cheap to
+// search; large ones (a page) make the tree shallower and range scans more sequential. Nodes are kept at least half
+// full: a node that overflows is split in two, and one that drops below half full borrows an element from a sibling,
+// or is merged with it.
+//
+// Elements are compared with "compare", which takes pointers to two elements (so the key passed to "bplus_tree_find"
+// and the other lookups is an element, with at least its key fields filled in). Each key can be in the tree only once.
+// Ex:
+//
+//     typedef struct order_t
+//     {
+//         uint64_t    id;
+//         uint32_t    quantity;
+//     } order_t;
+//
+//     bplus_tree_t orders;
+//     bplus_tree_init( &orders, sizeof(order_t), 0, compare_order_ids );
+//
+//     bplus_tree_insert( &orders, &(order_t){ .id = 42, .quantity = 7 } );
+//     order_t * found = bplus_tree_find( &orders, &(order_t){ .id = 42 } );
+//
+//     bplus_iter_t iter;
+//     for( order_t * order = bplus_tree_seek( &orders, &(order_t){ .id = 1000 }, &iter ); order && order->id < 2000;
+//          order = bplus_tree_next( &orders, &iter ) ) { ... }
+//
+//     bplus_tree_free( &orders, NULL );
+//
+// **WARNING**: Inserting or removing an element moves other elements around within (and between) nodes. Because of
+// this, it will break any variables that hold pointers to elements in the tree, or iterators.
+
+#ifndef BPLUS_TREE_NODE_BYTES
+#define BPLUS_TREE_NODE_BYTES   1024    // Default node size: 16 cache lines
+#endif
+#define BPLUS_TREE_MAX_DEPTH    64      // More levels than any tree that fits in memory can have
+
+typedef struct bplus_node_t
+{
+    struct bplus_node_t *   next;       // Next leaf, in order (leaves only)
+    struct bplus_node_t *   prev;       // Previous leaf (leaves only)
+    size_t                  num;        // Number of elements (leaf) or keys (branch, which has one more child)
+    uint8_t                 data[];     // Leaf: the elements. Branch: the child pointers, then the keys.
+} bplus_node_t;
+
+typedef struct bplus_tree_t
+{
+    bplus_node_t *  root;               // NULL when the tree is empty
+    bplus_node_t *  first;              // Leftmost leaf
+    bplus_node_t *  last;               // Rightmost leaf
+    size_t          count;              // Number of elements in the tree
+    size_t          height;             // Number of levels, counting the leaves (0 when the tree is empty)
+    size_t          size;               // Size of each element, in bytes
+    size_t          node_bytes;
+    size_t          leaf_capacity;      // Elements per leaf
+    size_t          branch_capacity;    // Keys per branch
+    int             (*compare)(const void * item_one, const void * item_two);
+} bplus_tree_t;
+
+// Position of an element in the tree, for reading elements in order with "bplus_tree_seek" and "bplus_tree_next".
+//
+typedef struct bplus_iter_t
+{
+    bplus_node_t *  leaf;
+    size_t          idx;
+} bplus_iter_t;
+
+// Loops over every element of the tree, in order. "elem" is set to a pointer to each element in turn.
+//
+#define bplus_tree_for_each(elem, iter, tree) \
+    for( elem = bplus_tree_seek( (tree), NULL, (iter) ); elem != NULL; elem = bplus_tree_next( (tree), (iter) ) )
+
+// Prepares an empty tree of elements "size" bytes each, with nodes of (at least) "node_bytes" bytes, or
+// BPLUS_TREE_NODE_BYTES if "node_bytes" is 0. Returns "false" if a node that size can't hold at least 4 elements, or
+// 4 keys. No memory is allocated until the first element is added.
+//
+static inline bool bplus_tree_init( bplus_tree_t * tree, size_t size, size_t node_bytes, int (*compare)(const void * item_one, const void * item_two) )
+{
+    if( node_bytes == 0 ) node_bytes = BPLUS_TREE_NODE_BYTES;
+    node_bytes = ( node_bytes + 63 ) & ~(size_t)63;
+
+    tree->root = tree->first = tree->last = NULL;
+    tree->count = 0;
+    tree->height = 0;
+    tree->size = size;
+    tree->node_bytes = node_bytes;
+    tree->leaf_capacity = ( node_bytes - sizeof(bplus_node_t) ) / size;
+    tree->branch_capacity = ( node_bytes - sizeof(bplus_node_t) - sizeof(bplus_node_t *) ) / ( size + sizeof(bplus_node_t *) );
+    tree->compare = compare;
+
+    return size > 0 && tree->leaf_capacity >= 4 && tree->branch_capacity >= 4;
+}
+
+// Returns a pointer to element "idx" of a leaf.
+//
+static inline void * bplus_tree_elem( const bplus_tree_t * tree, const bplus_node_t * leaf, size_t idx )
+{
+    return (void *)leaf->data + idx * tree->size;
+}
+
+// Returns the array of child pointers of a branch.
+//
+static inline bplus_node_t ** bplus_tree_children( const bplus_tree_t * tree, const bplus_node_t * branch )
+{
+    (void)tree;
+    return (bplus_node_t **)branch->data;
+}
+
+// Returns a pointer to key "idx" of a branch. Every element of child "idx + 1" is greater than or equal to the key, and
+// every element of child "idx" is less than it.
+//
+static inline void * bplus_tree_key( const bplus_tree_t * tree, const bplus_node_t * branch, size_t idx )
+{
+    return (void *)branch->data + ( tree->branch_capacity + 1 ) * sizeof(bplus_node_t *) + idx * tree->size;
+}
+
+// Allocates a node, taking it from "pool" (a list of unused nodes linked through "next") if there's one there.
+// Returns NULL if the memory couldn't be allocated.
+//
+static inline bplus_node_t * bplus_tree_alloc( const bplus_tree_t * tree, bplus_node_t ** pool )
+{
+    bplus_node_t * node = *pool;
+
+    if( node ) *pool = node->next;
+    else node = aligned_alloc( 64, tree->node_bytes );
+
+    if( node )
+    {
+        node->next = node->prev = NULL;
+        node->num = 0;
+    }
+
+    return node;
+}
+
+// Frees a list of nodes linked through "next".
+//
+static inline void bplus_tree_free_chain( bplus_node_t * node )
+{
+    while( node )
+    {
+        bplus_node_t * next = node->next;
+        free( node );
+        node = next;
+    }
+}
+
+// Moves every branch of the subtree under "node" ("levels" levels high, counting the leaves) onto "pool", leaving the
+// leaves alone. Helper function used by "bplus_tree_free" and "bplus_tree_filter".
+//
+static inline void bplus_tree_take_branches( const bplus_tree_t * tree, bplus_node_t * node, size_t levels, bplus_node_t ** pool )
+{
+    if( levels <= 1 ) return;
+
+    for( size_t idx = 0; idx <= node->num; idx++ ) bplus_tree_take_branches( tree, bplus_tree_children( tree, node )[idx], levels - 1, pool );
+    node->next = *pool;
+    *pool = node;
+}
+
+// Frees the memory held by the tree, calling "delete" (if not NULL) on each element first, and leaves the tree empty
+// (but still usable).
+//
+static inline void bplus_tree_free( bplus_tree_t * tree, void (*delete)(void * item) )
+{
+    bplus_node_t * branches = NULL;
+
+    if( tree->root == NULL ) return;
+
+    if( delete )
+    {
+        for( bplus_node_t * leaf = tree->first; leaf; leaf = leaf->next )
+        {
+            for( size_t idx = 0; idx < leaf->num; idx++ ) delete( bplus_tree_elem( tree, leaf, idx ) );
+        }
+    }
+    bplus_tree_take_branches( tree, tree->root, tree->height, &branches );
+    bplus_tree_free_chain( branches );
+    bplus_tree_free_chain( tree->first );
+
+    tree->root = tree->first = tree->last = NULL;
+    tree->count = 0;
+    tree->height = 0;
+}
+
+// Finds the leaf where "key" belongs, recording the branches on the way down (and which child of each was taken) in
+// "path" and "slots", if not NULL. Helper function used by the functions below.
+//
+static inline bplus_node_t * bplus_tree_descend( const bplus_tree_t * tree, const void * key, bplus_node_t ** path, size_t * slots )
+{
+    bplus_node_t * node = tree->root;
+
+    for( size_t depth = 0; depth + 1 < tree->height; depth++ )
+    {
+        size_t pos = array_upper_bound( key, bplus_tree_key( tree, node, 0 ), node->num, tree->size, tree->compare );
+
+        if( path )
+        {
+            path[depth] = node;
+            slots[depth] = pos;
+        }
+        node = bplus_tree_children( tree, node )[pos];
+    }
+
+    return node;
+}
+
+// Returns a pointer to the element that compares equal to "key", or NULL if there isn't one.
+//
+static inline void * bplus_tree_find( const bplus_tree_t * tree, const void * key )
+{
+    if( tree->root == NULL ) return NULL;
+
+    bplus_node_t * leaf = bplus_tree_descend( tree, key, NULL, NULL );
+    size_t pos = array_lower_bound( key, leaf->data, leaf->num, tree->size, tree->compare );
+
+    return ( pos < leaf->num && tree->compare( key, bplus_tree_elem( tree, leaf, pos ) ) == 0 ) ? bplus_tree_elem( tree, leaf, pos ) : NULL;
+}
+
+// Returns a pointer to the smallest element, or NULL if the tree is empty.
+//
+static inline void * bplus_tree_find_min( const bplus_tree_t * tree )
+{
+    return tree->root ? bplus_tree_elem( tree, tree->first, 0 ) : NULL;
+}
+
+// Returns a pointer to the largest element, or NULL if the tree is empty.
+//
+static inline void * bplus_tree_find_max( const bplus_tree_t * tree )
+{
+    return tree->root ? bplus_tree_elem( tree, tree->last, tree->last->num - 1 ) : NULL;
+}
+
+// Points "iter" at the first element that doesn't compare less than "key" (or at the first element of the tree, if
+// "key" is NULL) and returns a pointer to it, or NULL if there's no such element.
+//
+static inline void * bplus_tree_seek( const bplus_tree_t * tree, const void * key, bplus_iter_t * iter )
+{
+    iter->leaf = tree->first;
+    iter->idx = 0;
+    if( tree->root == NULL ) return NULL;
+
+    if( key )
+    {
+        iter->leaf = bplus_tree_descend( tree, key, NULL, NULL );
+        iter->idx = array_lower_bound( key, iter->leaf->data, iter->leaf->num, tree->size, tree->compare );
+        if( iter->idx == iter->leaf->num )
+        {
+            if( iter->leaf->next == NULL ) return NULL;
+            iter->leaf = iter->leaf->next;
+            iter->idx = 0;
+        }
+    }
+
+    return bplus_tree_elem( tree, iter->leaf, iter->idx );
+}
+
+// Moves "iter" on to the next element and returns a pointer to it, or NULL if there are no more elements.
+//
+static inline void * bplus_tree_next( const bplus_tree_t * tree, bplus_iter_t * iter )
+{
+    if( iter->leaf == NULL ) return NULL;
+
+    if( ++iter->idx >= iter->leaf->num )
+    {
+        if( iter->leaf->next == NULL )
+        {
+            iter->idx = iter->leaf->num;
+            return NULL;
+        }
+        iter->leaf = iter->leaf->next;
+        iter->idx = 0;
+    }
+
+    return bplus_tree_elem( tree, iter->leaf, iter->idx );
+}
+
+// Counts the elements between "lo" and "hi" (inclusive). A NULL "lo" or "hi" leaves that end of the range open. Only
+// the two leaves at the ends of the range are searched; the ones in between are counted from their headers.
+//
+static inline size_t bplus_tree_count_range( const bplus_tree_t * tree, const void * lo, const void * hi )
+{
+    bplus_iter_t start;
+    bplus_node_t * end_leaf;
+    size_t end_idx, count = 0;
+
+    if( tree->root == NULL || ( lo && hi && tree->compare( lo, hi ) > 0 ) ) return 0;
+    if( bplus_tree_seek( tree, lo, &start ) == NULL ) return 0;
+
+    if( hi )
+    {
+        end_leaf = bplus_tree_descend( tree, hi, NULL, NULL );
+        end_idx = array_upper_bound( hi, end_leaf->data, end_leaf->num, tree->size, tree->compare );
+    }
+    else
+    {
+        end_leaf = tree->last;
+        end_idx = end_leaf->num;
+    }
+
+    // "hi" is less than the element at "start", which can only be the first element of the leaf after "end_leaf"
+    if( start.leaf == end_leaf->next ) return 0;
+
+    for( bplus_node_t * leaf = start.leaf; leaf != end_leaf; leaf = leaf->next ) count += leaf->num;
+
+    return count + end_idx - start.idx;
+}
+
+// Counts the elements for which the function "count_this" returns "true".
+//
+static inline size_t bplus_tree_count( const bplus_tree_t * tree, bool (*count_this)(const void * elem) )
+{
+    size_t count = 0;
+
+    for( bplus_node_t * leaf = tree->root ? tree->first : NULL; leaf; leaf = leaf->next )
+    {
+        for( size_t idx = 0; idx < leaf->num; idx++ ) count += count_this( bplus_tree_elem( tree, leaf, idx ) );
+    }
+
+    return count;
+}
+
+// Inserts "key" and "child" into a branch that isn't full, at key index "pos" ("child" goes to the right of the key).
+//
+static inline void bplus_tree_branch_insert( const bplus_tree_t * tree, bplus_node_t * branch, size_t pos, const void * key, bplus_node_t * child )
+{
+    bplus_node_t ** children = bplus_tree_children( tree, branch );
+
+    memmove( bplus_tree_key( tree, branch, pos + 1 ), bplus_tree_key( tree, branch, pos ), ( branch->num - pos ) * tree->size );
+    memmove( &children[pos + 2], &children[pos + 1], ( branch->num - pos ) * sizeof(bplus_node_t *) );
+    memcpy( bplus_tree_key( tree, branch, pos ), key, tree->size );
+    children[pos + 1] = child;
+    branch->num++;
+}
+
+// Adds a copy of "elem" to the tree. Returns 1 if it was added, 0 if an element that compares equal was already in the
+// tree (which is left unchanged), or -1 if a node couldn't be allocated (in which case the tree is also unchanged).
+//
+static inline int bplus_tree_insert( bplus_tree_t * tree, const void * elem )
+{
+    bplus_node_t * path[BPLUS_TREE_MAX_DEPTH], * spare = NULL, * leaf, * sibling, * target;
+    size_t slots[BPLUS_TREE_MAX_DEPTH], pos, mid, depth, needed = 1;
+
+    if( tree->root == NULL )
+    {
+        tree->root = tree->first = tree->last = bplus_tree_alloc( tree, &spare );
+        if( tree->root == NULL ) return -1;
+        tree->height = 1;
+    }
+
+    leaf = bplus_tree_descend( tree, elem, path, slots );
+    pos = array_lower_bound( elem, leaf->data, leaf->num, tree->size, tree->compare );
+    if( pos < leaf->num && tree->compare( elem, bplus_tree_elem( tree, leaf, pos ) ) == 0 ) return 0;
+
+    if( leaf->num < tree->leaf_capacity )
+    {
+        memmove( bplus_tree_elem( tree, leaf, pos + 1 ), bplus_tree_elem( tree, leaf, pos ), ( leaf->num - pos ) * tree->size );
+        memcpy( bplus_tree_elem( tree, leaf, pos ), elem, tree->size );
+        leaf->num++;
+        tree->count++;
+        return 1;
+    }
+
+    // The leaf is full, so it will be split, and so will each full branch above it (and, if they're all full, a new
+    // root is needed). Allocate every node that will take before changing anything, so a failure leaves the tree as is.
+    //
+    for( depth = tree->height - 1; depth > 0 && path[depth - 1]->num == tree->branch_capacity; depth-- ) needed++;
+    if( depth == 0 ) needed++;
+    while( needed-- > 0 )
+    {
+        bplus_node_t * node = aligned_alloc( 64, tree->node_bytes );
+        if( node == NULL )
+        {
+            bplus_tree_free_chain( spare );
+            return -1;
+        }
+        node->next = spare;
+        spare = node;
+    }
+
+    // Split the leaf: the lower half of the elements (with "elem", if it goes there) stay, the rest move to "sibling".
+    //
+    sibling = bplus_tree_alloc( tree, &spare );
+    mid = ( tree->leaf_capacity + 1 ) / 2;
+    if( pos < mid )
+    {
+        mid--;
+        target = leaf;
+    }
+    else
+    {
+        target = sibling;
+        pos -= mid;
+    }
+    sibling->num = leaf->num - mid;
+    memcpy( sibling->data, bplus_tree_elem( tree, leaf, mid ), sibling->num * tree->size );
+    leaf->num = mid;
+    memmove( bplus_tree_elem( tree, target, pos + 1 ), bplus_tree_elem( tree, target, pos ), ( target->num - pos ) * tree->size );
+    memcpy( bplus_tree_elem( tree, target, pos ), elem, tree->size );
+    target->num++;
+    sibling->prev = leaf;
+    sibling->next = leaf->next;
+    if( leaf->next ) leaf->next->prev = sibling;
+    else tree->last = sibling;
+    leaf->next = sibling;
+    tree->count++;
+
+    // Pass the separator (the first element of "sibling") and "sibling" up to the parent, splitting full branches.
+    //
+    uint8_t separator[tree->size], keys[( tree->branch_capacity + 1 ) * tree->size];
+    bplus_node_t * children[tree->branch_capacity + 2];
+    bplus_node_t * right = sibling;
+
+    memcpy( separator, sibling->data, tree->size );
+    for( depth = tree->height - 1; depth-- > 0; )
+    {
+        bplus_node_t * branch = path[depth];
+        size_t num = branch->num, up;
+
+        if( num < tree->branch_capacity )
+        {
+            bplus_tree_branch_insert( tree, branch, slots[depth], separator, right );
+            return 1;
+        }
+
+        // Gather all the keys and children, with the new ones, then share them out between "branch" and a new node,
+        // passing the middle key up.
+        //
+        memcpy( keys, bplus_tree_key( tree, branch, 0 ), num * tree->size );
+        memcpy( children, bplus_tree_children( tree, branch ), ( num + 1 ) * sizeof(bplus_node_t *) );
+        memmove( keys + ( slots[depth] + 1 ) * tree->size, keys + slots[depth] * tree->size, ( num - slots[depth] ) * tree->size );
+        memcpy( keys + slots[depth] * tree->size, separator, tree->size );
+        memmove( &children[slots[depth] + 2], &children[slots[depth] + 1], ( num - slots[depth] ) * sizeof(bplus_node_t *) );
+        children[slots[depth] + 1] = right;
+
+        up = ( num + 1 ) / 2;
+        right = bplus_tree_alloc( tree, &spare );
+        branch->num = up;
+        memcpy( bplus_tree_key( tree, branch, 0 ), keys, up * tree->size );
+        memcpy( bplus_tree_children( tree, branch ), children, ( up + 1 ) * sizeof(bplus_node_t *) );
+        right->num = num - up;
+        memcpy( bplus_tree_key( tree, right, 0 ), keys + ( up + 1 ) * tree->size, right->num * tree->size );
+        memcpy( bplus_tree_children( tree, right ), &children[up + 1], ( right->num + 1 ) * sizeof(bplus_node_t *) );
+        memcpy( separator, keys + up * tree->size, tree->size );
+    }
+
+    // The root was split, too: add a new root above the two halves.
+    //
+    bplus_node_t * root = bplus_tree_alloc( tree, &spare );
+
+    root->num = 1;
+    bplus_tree_children( tree, root )[0] = tree->root;
+    bplus_tree_children( tree, root )[1] = right;
+    memcpy( bplus_tree_key( tree, root, 0 ), separator, tree->size );
+    tree->root = root;
+    tree->height++;
+
+    return 1;
+}
+
+// Brings child "idx" of "parent", which has dropped below half full, back up to half full: it borrows an element (or a
+// key and child) from a sibling that has one to spare, or, if neither does, is merged with a sibling, which removes a
+// key from "parent". "leaves" says whether the children of "parent" are leaves. Helper function used by
+// "bplus_tree_remove".
+//
+static inline void bplus_tree_rebalance( bplus_tree_t * tree, bplus_node_t * parent, size_t idx, bool leaves )
+{
+    bplus_node_t ** siblings = bplus_tree_children( tree, parent );
+    bplus_node_t * node = siblings[idx], * left = idx > 0 ? siblings[idx - 1] : NULL;
+    bplus_node_t * right = idx < parent->num ? siblings[idx + 1] : NULL;
+    size_t min = ( leaves ? tree->leaf_capacity : tree->branch_capacity ) / 2;
+    size_t size = tree->size;
+
+    if( left && left->num > min )
+    {
+        if( leaves )
+        {
+            memmove( bplus_tree_elem( tree, node, 1 ), node->data, node->num * size );
+            memcpy( node->data, bplus_tree_elem( tree, left, left->num - 1 ), size );
+            memcpy( bplus_tree_key( tree, parent, idx - 1 ), node->data, size );
+        }
+        else
+        {
+            bplus_node_t ** children = bplus_tree_children( tree, node );
+
+            memmove( bplus_tree_key( tree, node, 1 ), bplus_tree_key( tree, node, 0 ), node->num * size );
+            memmove( &children[1], &children[0], ( node->num + 1 ) * sizeof(bplus_node_t *) );
+            memcpy( bplus_tree_key( tree, node, 0 ), bplus_tree_key( tree, parent, idx - 1 ), size );
+            children[0] = bplus_tree_children( tree, left )[left->num];
+            memcpy( bplus_tree_key( tree, parent, idx - 1 ), bplus_tree_key( tree, left, left->num - 1 ), size );
+        }
+        left->num--;
+        node->num++;
+    }
+    else if( right && right->num > min )
+    {
+        if( leaves )
+        {
+            memcpy( bplus_tree_elem( tree, node, node->num ), right->data, size );
+            memmove( right->data, bplus_tree_elem( tree, right, 1 ), ( right->num - 1 ) * size );
+            memcpy( bplus_tree_key( tree, parent, idx ), right->data, size );
+        }
+        else
+        {
+            bplus_node_t ** children = bplus_tree_children( tree, right );
+
+            memcpy( bplus_tree_key( tree, node, node->num ), bplus_tree_key( tree, parent, idx ), size );
+            bplus_tree_children( tree, node )[node->num + 1] = children[0];
+            memcpy( bplus_tree_key( tree, parent, idx ), bplus_tree_key( tree, right, 0 ), size );
+            memmove( bplus_tree_key( tree, right, 0 ), bplus_tree_key( tree, right, 1 ), ( right->num - 1 ) * size );
+            memmove( &children[0], &children[1], right->num * sizeof(bplus_node_t *) );
+        }
+        right->num--;
+        node->num++;
+    }
+    else
+    {
+        // Merge the child to the right of key "idx" into the one to its left, and remove the key from "parent".
+        //
+        if( left )
+        {
+            right = node;
+            node = left;
+            idx--;
+        }
+
+        if( leaves )
+        {
+            memcpy( bplus_tree_elem( tree, node, node->num ), right->data, right->num * size );
+            node->num += right->num;
+            node->next = right->next;
+            if( right->next ) right->next->prev = node;
+            else tree->last = node;
+        }
+        else
+        {
+            memcpy( bplus_tree_key( tree, node, node->num ), bplus_tree_key( tree, parent, idx ), size );
+            memcpy( bplus_tree_key( tree, node, node->num + 1 ), bplus_tree_key( tree, right, 0 ), right->num * size );
+            memcpy( &bplus_tree_children( tree, node )[node->num + 1], bplus_tree_children( tree, right ), ( right->num + 1 ) * sizeof(bplus_node_t *) );
+            node->num += right->num + 1;
+        }
+        free( right );
+
+        memmove( bplus_tree_key( tree, parent, idx ), bplus_tree_key( tree, parent, idx + 1 ), ( parent->num - idx - 1 ) * size );
+        memmove( &siblings[idx + 1], &siblings[idx + 2], ( parent->num - idx - 1 ) * sizeof(bplus_node_t *) );
+        parent->num--;
+    }
+}
+
+// Removes the element that compares equal to "key", copying it to "removed" first (if not NULL). Returns "false" if
+// there's no such element.
+//
+static inline bool bplus_tree_remove( bplus_tree_t * tree, const void * key, void * removed )
+{
+    bplus_node_t * path[BPLUS_TREE_MAX_DEPTH], * node;
+    size_t slots[BPLUS_TREE_MAX_DEPTH], pos, depth;
+
+    if( tree->root == NULL ) return false;
+
+    node = bplus_tree_descend( tree, key, path, slots );
+    pos = array_lower_bound( key, node->data, node->num, tree->size, tree->compare );
+    if( pos == node->num || tree->compare( key, bplus_tree_elem( tree, node, pos ) ) != 0 ) return false;
+
+    if( removed ) memcpy( removed, bplus_tree_elem( tree, node, pos ), tree->size );
+    memmove( bplus_tree_elem( tree, node, pos ), bplus_tree_elem( tree, node, pos + 1 ), ( node->num - pos - 1 ) * tree->size );
+    node->num--;
+    tree->count--;
+
+    // Rebalance on the way back up, for as long as the node below is less than half full.
+    //
+    for( depth = tree->height - 1; depth > 0; depth-- )
+    {
+        bool leaf = depth == tree->height - 1;
+
+        if( node->num >= ( leaf ? tree->leaf_capacity : tree->branch_capacity ) / 2 ) break;
+        bplus_tree_rebalance( tree, path[depth - 1], slots[depth - 1], leaf );
+        node = path[depth - 1];
+    }
+
+    // A root with no keys left is replaced by its only child, and an empty root leaf by an empty tree.
+    //
+    if( tree->root->num == 0 )
+    {
+        node = tree->root;
+        if( tree->height > 1 ) tree->root = bplus_tree_children( tree, node )[0];
+        else tree->root = tree->first = tree->last = NULL;
+        tree->height--;
+        free( node );
+    }
+
+    return true;
+}
+
+// Returns the leftmost leaf of the subtree under "node", which is "levels" levels high (counting the leaves).
+//
+static inline bplus_node_t * bplus_tree_leftmost( const bplus_tree_t * tree, bplus_node_t * node, size_t levels )
+{
+    while( --levels > 0 ) node = bplus_tree_children( tree, node )[0];
+
+    return node;
+}
+
+// Builds the branches above the leaves that start at "tree->first" (linked through "next"), one level at a time, with
+// each level as few nodes as possible and the children shared out evenly between them, so every node is at least half
+// full. Nodes are taken from "pool" before any are allocated, and whatever is left of "pool" is freed. Returns "false"
+// if a node couldn't be allocated, in which case any branches it built are freed and the leaves are left alone. Helper
+// function used by "bplus_tree_bulk_load" and "bplus_tree_filter".
+//
+static inline bool bplus_tree_build_branches( bplus_tree_t * tree, bplus_node_t * pool )
+{
+    bplus_node_t * level = tree->first, * levels[BPLUS_TREE_MAX_DEPTH];
+    size_t num = 0, height = 1;
+
+    for( bplus_node_t * leaf = tree->first; leaf; leaf = leaf->next ) num++;
+
+    // Each level of branches is linked through "next", like the leaves, until the level above it has been built.
+    //
+    for( ; num > 1; height++ )
+    {
+        size_t num_parents = ( num + tree->branch_capacity ) / ( tree->branch_capacity + 1 );
+        bplus_node_t * child = level, * prev = NULL;
+
+        levels[height - 1] = NULL;
+        for( size_t parent_idx = 0; parent_idx < num_parents; parent_idx++ )
+        {
+            size_t num_children = num / num_parents + ( parent_idx < num % num_parents );
+            bplus_node_t * parent = bplus_tree_alloc( tree, &pool );
+
+            if( parent == NULL )
+            {
+                for( size_t idx = 0; idx < height; idx++ ) bplus_tree_free_chain( levels[idx] );
+                return false;
+            }
+            if( prev ) prev->next = parent;
+            else levels[height - 1] = parent;
+            prev = parent;
+
+            parent->num = num_children - 1;
+            for( size_t idx = 0; idx < num_children; idx++, child = child->next )
+            {
+                bplus_tree_children( tree, parent )[idx] = child;
+                if( idx > 0 ) memcpy( bplus_tree_key( tree, parent, idx - 1 ), bplus_tree_leftmost( tree, child, height )->data, tree->size );
+            }
+        }
+        level = levels[height - 1];
+        num = num_parents;
+    }
+    bplus_tree_free_chain( pool );
+
+    tree->root = level;
+    tree->height = height;
+
+    return true;
+}
+
+// Fills an empty tree with the "num" elements of "base", which must be sorted, with no two elements equal. The elements
+// are shared out evenly between as few leaves as possible and no element is compared, so this is much faster than
+// inserting the elements one at a time, and the tree ends up smaller (but the first inserts after it will split).
+// Returns "false" if the tree isn't empty, or if a node couldn't be allocated (in which case the tree is left empty).
+//
+static inline bool bplus_tree_bulk_load( bplus_tree_t * tree, const void * base, size_t num )
+{
+    bplus_node_t * prev = NULL, * pool = NULL;
+    size_t num_leaves = ( num + tree->leaf_capacity - 1 ) / tree->leaf_capacity;
+
+    if( tree->root ) return false;
+    if( num == 0 ) return true;
+
+    for( size_t leaf_idx = 0; leaf_idx < num_leaves; leaf_idx++ )
+    {
+        bplus_node_t * leaf = bplus_tree_alloc( tree, &pool );
+
+        if( leaf == NULL )
+        {
+            bplus_tree_free_chain( tree->first );
+            tree->first = tree->last = NULL;
+            return false;
+        }
+        leaf->num = num / num_leaves + ( leaf_idx < num % num_leaves );
+        memcpy( leaf->data, base, leaf->num * tree->size );
+        base += leaf->num * tree->size;
+
+        leaf->prev = prev;
+        if( prev ) prev->next = leaf;
+        else tree->first = leaf;
+        prev = leaf;
+    }
+    tree->last = prev;
+
+    if( !bplus_tree_build_branches( tree, NULL ) )
+    {
+        bplus_tree_free_chain( tree->first );
+        tree->first = tree->last = NULL;
+        return false;
+    }
+    tree->count = num;
+
+    return true;
+}
+
+// Removes every element for which the function "keep_this" returns "false", calling "delete" (if not NULL) on each one
+// first. Returns the number of elements left. The elements that are left are packed into as few leaves as possible, in
+// a single pass over the leaves, and the branches are then rebuilt on top of them (in the memory of the old branches,
+// so this never allocates), which takes O(n) time however many elements are removed, instead of O(log n) for each.
+//
+static inline size_t bplus_tree_filter( bplus_tree_t * tree, bool (*keep_this)(const void * elem), void (*delete)(void * item) )
+{
+    bplus_node_t * write = tree->first, * pool = NULL;
+    size_t write_idx = 0, kept = 0;
+
+    if( tree->root == NULL ) return 0;
+
+    for( bplus_node_t * leaf = tree->first; leaf; leaf = leaf->next )
+    {
+        size_t num = leaf->num;
+
+        for( size_t idx = 0; idx < num; idx++ )
+        {
+            void * elem = bplus_tree_elem( tree, leaf, idx );
+
+            if( keep_this( elem ) )
+            {
+                // The element goes in the next free spot of the leaves written so far, which is never past "elem"
+                if( write_idx == tree->leaf_capacity )
+                {
+                    write->num = write_idx;
+                    write = write->next;
+                    write_idx = 0;
+                }
+                if( elem != bplus_tree_elem( tree, write, write_idx ) ) memcpy( bplus_tree_elem( tree, write, write_idx ), elem, tree->size );
+                write_idx++;
+                kept++;
+            }
+            else if( delete ) delete( elem );
+        }
+    }
+    write->num = write_idx;
+    tree->count = kept;
+
+    // Free the leaves that are no longer needed, and even out the last two, so that the last one is at least half full.
+    //
+    bplus_tree_free_chain( write->next );
+    write->next = NULL;
+    tree->last = write;
+    if( write->prev && write->num < tree->leaf_capacity / 2 )
+    {
+        bplus_node_t * prev = write->prev;
+        size_t move = ( prev->num - write->num ) / 2;
+
+        memmove( bplus_tree_elem( tree, write, move ), write->data, write->num * tree->size );
+        memcpy( write->data, bplus_tree_elem( tree, prev, prev->num - move ), move * tree->size );
+        prev->num -= move;
+        write->num += move;
+    }
+
+    bplus_tree_take_branches( tree, tree->root, tree->height, &pool );
+    if( kept == 0 )
+    {
+        bplus_tree_free_chain( pool );
+        free( write );
+        tree->root = tree->first = tree->last = NULL;
+        tree->height = 0;
+        return 0;
+    }
+
+    // The old branches are always enough to build the new ones (no level needs more nodes than it had before), so this
+    // never allocates and can't fail. If it somehow did, empty the tree instead of leaving it with freed branches.
+    //
+    if( !bplus_tree_build_branches( tree, pool ) )
+    {
+        tree->root = tree->first;
+        tree->height = 1;
+        bplus_tree_free( tree, delete );
+        return 0;
+    }
+
+    return kept;
+}
+
+#endif // BPLUS_TREE_H
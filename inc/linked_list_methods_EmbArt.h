@@ -2,6 +2,7 @@
 #define LINKED_LIST_METHODS_EMBART_H
 
 #include "ll.h"
+#include "array_methods.h"  // For ARRAY_FOR_EACH, unique_set_t
 #include <stdlib.h>     // For qsort
 #include <stdbool.h>    // For bool
 
@@ -101,7 +102,201 @@ static inline void linked_list_insertion_sort( ll_t * head, int (*compare)(const
     }
 }
 
-//TODO: Add MergeSort (https://www.geeksforgeeks.org/iterative-merge-sort-for-linked-list/)
+// Insert a node into a sorted linked list, starting the search from "finger" (a node already in the list, usually the
+// one returned by the previous call) instead of from the front. The tail is checked first, so appending in order takes
+// one comparison; otherwise the list is walked from "finger" towards the front or the back, whichever way the new node
+// lies, so an insert near the previous one only walks as far as the distance between them. Equal nodes are inserted
+// after the existing ones, like "linked_list_sorted_insert". Returns the inserted node, to use as the next "finger". Ex:
+//
+//     ll_t * finger = NULL;
+//     for( ... ) finger = linked_list_sorted_insert_hint( &samples, &new_sample->node, finger, compare_timestamps );
+//
+// **WARNING**: "finger" must be NULL (to start from the front) or a node in "head". The comparison function takes
+// pointers to the nodes themselves, like "linked_list_sorted_insert".
+//
+static inline ll_t * linked_list_sorted_insert_hint( ll_t * head, ll_t * node_to_insert, ll_t * finger, int (*compare)(const void * key, const void * elem) )
+{
+    ll_t * node = ( finger == NULL || finger == head ) ? head->next : finger;
+
+    if( head->next == head || compare( head->prev, node_to_insert ) <= 0 )
+    {
+        list_add_tail( node_to_insert, head );
+    }
+    else if( compare( node, node_to_insert ) > 0 )
+    {
+        // Walk back to the last node that's not greater than the new one (or to the head)
+        do node = node->prev; while( node != head && compare( node, node_to_insert ) > 0 );
+        list_insert( node_to_insert, node, node->next );
+    }
+    else
+    {
+        // The tail is greater than the new node, so this stops before reaching the head
+        while( compare( node->next, node_to_insert ) <= 0 ) node = node->next;
+        list_insert( node_to_insert, node, node->next );
+    }
+
+    return node_to_insert;
+}
+
+// Insertion sort that reinserts each node with "linked_list_sorted_insert_hint", using the previously inserted node as
+// the finger. Each node costs as many comparisons as the distance from the node before it (in the original order) in
+// the sorted list, so lists that are already sorted or reverse-sorted take O(n), lists with only a few nodes out of
+// place take close to that, and random lists still take O(n^2). The sort is stable.
+//
+static inline void linked_list_adaptive_insertion_sort( ll_t * head, int (*compare)(const void * key, const void * elem) )
+{
+    LIST_INIT(unsorted);
+    ll_t *node, *copy, *finger = NULL;
+
+    list_splice( head, &unsorted );
+    list_for_each_safe( node, copy, &unsorted )
+    {
+        list_del( node );
+        finger = linked_list_sorted_insert_hint( head, node, finger, compare );
+    }
+}
+
+// Merges the sorted list "other" into the sorted list that starts with "head", so that "head" ends up sorted and
+// "other" ends up empty. When two nodes compare equal, the one already in "head" comes first (i.e. the merge is
+// stable). Rather than moving nodes one at a time, each run of consecutive nodes from "other" that belongs in front of
+// the same node of "head" is spliced in all at once, and whatever is left of "other" once the end of "head" is reached
+// is spliced onto the tail in a single step. Each node is compared at most once, so the merge takes a single pass.
+//
+static inline void linked_list_merge_sorted( ll_t * head, ll_t * other, int (*compare)(const void * item_one, const void * item_two) )
+{
+    ll_t * node = head->next;
+
+    while( !list_empty( other ) )
+    {
+        if( node == head )
+        {
+            list_splice_tail( other, head );
+            break;
+        }
+
+        if( compare( other->next, node ) < 0 )
+        {
+            // Find the end of the run of nodes from "other" that belong in front of "node"...
+            //
+            ll_t * first = other->next, * last = first;
+
+            while( last->next != other && compare( last->next, node ) < 0 ) last = last->next;
+
+            // ...then unlink the run from "other" and link it in just before "node".
+            //
+            list_join_nodes( other, last->next );
+            first->prev = node->prev;
+            node->prev->next = first;
+            last->next = node;
+            node->prev = last;
+        }
+
+        node = node->next;
+    }
+}
+
+// Moves the nodes from "first" to "last" (inclusive, in order) from whatever list they're in to the end of the list
+// "to", in O(1) time. If "to" is NULL, they're just unlinked. Helper function used by the set operations.
+//
+static inline void linked_list_move_range_tail( ll_t * first, ll_t * last, ll_t * to )
+{
+    list_join_nodes( first->prev, last->next );
+    if( to )
+    {
+        first->prev = to->prev;
+        to->prev->next = first;
+        last->next = to;
+        to->prev = last;
+    }
+}
+
+// Set operations on two sorted lists, done by relinking nodes rather than copying them. The result ends up in the list
+// that starts with "head", in sorted order. Nodes of "head" that aren't part of the result are moved to the end of
+// the list "removed_nodes" (if not NULL), as "linked_list_filter_in_place" does, and nodes of "other" that are part of
+// the result are moved out of "other" into "head"; the rest of "other" is left where it is. As with the array
+// versions, nodes that compare equal are matched up one to one.
+//
+// Each node is compared at most once. Once either list runs out, the rest of the other one is moved (or left) as a
+// single block. There's no galloping: a list can't be searched without walking it.
+//
+static inline void linked_list_set_operation( ll_t * head, ll_t * other, ll_t * removed_nodes, int keep, int (*compare)(const void * item_one, const void * item_two) )
+{
+    ll_t * node = head->next, * from = other->next, * next;
+
+    while( node != head && from != other )
+    {
+        int order = compare( node, from );
+
+        if( order > 0 )
+        {
+            next = from->next;
+            if( keep & ARRAY_SET_ONLY_TWO )
+            {
+                list_join_nodes( from->prev, next );
+                list_insert( from, node->prev, node );
+            }
+            from = next;
+            continue;
+        }
+
+        next = node->next;
+        if( !( keep & ( order < 0 ? ARRAY_SET_ONLY_ONE : ARRAY_SET_BOTH ) ) )
+        {
+            list_del( node );
+            if( removed_nodes ) list_add_tail( node, removed_nodes );
+        }
+        if( order == 0 ) from = from->next;
+        node = next;
+    }
+
+    if( node != head && !( keep & ARRAY_SET_ONLY_ONE ) ) linked_list_move_range_tail( node, head->prev, removed_nodes );
+    if( from != other && ( keep & ARRAY_SET_ONLY_TWO ) ) linked_list_move_range_tail( from, other->prev, head );
+}
+
+// Keeps in "head" only the nodes that have a match in "other".
+//
+static inline void linked_list_set_intersect( ll_t * head, ll_t * other, ll_t * removed_nodes, int (*compare)(const void * item_one, const void * item_two) )
+{
+    linked_list_set_operation( head, other, removed_nodes, ARRAY_SET_BOTH, compare );
+}
+
+// Moves into "head" the nodes of "other" that have no match in "head". Nothing is removed from "head".
+//
+static inline void linked_list_set_union( ll_t * head, ll_t * other, int (*compare)(const void * item_one, const void * item_two) )
+{
+    linked_list_set_operation( head, other, NULL, ARRAY_SET_ONLY_ONE | ARRAY_SET_ONLY_TWO | ARRAY_SET_BOTH, compare );
+}
+
+// Removes from "head" the nodes that have a match in "other".
+//
+static inline void linked_list_set_difference( ll_t * head, ll_t * other, ll_t * removed_nodes, int (*compare)(const void * item_one, const void * item_two) )
+{
+    linked_list_set_operation( head, other, removed_nodes, ARRAY_SET_ONLY_ONE, compare );
+}
+
+// Removes from "head" the nodes that have a match in "other", and moves into "head" the nodes of "other" that don't.
+//
+static inline void linked_list_set_symmetric_difference( ll_t * head, ll_t * other, ll_t * removed_nodes, int (*compare)(const void * item_one, const void * item_two) )
+{
+    linked_list_set_operation( head, other, removed_nodes, ARRAY_SET_ONLY_ONE | ARRAY_SET_ONLY_TWO, compare );
+}
+
+// Sorts the list with a merge sort: the list is split in half, each half is sorted, and the halves are merged back
+// together with "linked_list_merge_sorted". Unlike "linked_list_qsort", no array of node pointers is needed, so the
+// only extra memory used is O(log n) stack space, and the comparison function takes pointers to the nodes themselves
+// (like "linked_list_find_max"), not double-pointers. The sort is stable.
+//
+static inline void linked_list_merge_sort( ll_t * head, int (*compare)(const void * item_one, const void * item_two) )
+{
+    LIST_INIT(second);
+
+    if( head->next == head->prev ) return;     // Zero or one nodes
+
+    list_split_half( head, &second );
+    linked_list_merge_sort( head, compare );
+    linked_list_merge_sort( &second, compare );
+    linked_list_merge_sorted( head, &second, compare );
+}
 
 // Returns the address of the largest value in an unsorted linked list.
 //
@@ -133,6 +328,110 @@ static inline void * linked_list_find_min( const ll_t * head, int (*compare)(con
     return ret;
 }
 
+// Finds the addresses of both the smallest and the largest values in an unsorted linked list in a single pass,
+// storing them in "min" and "max" (or NULL if the list is empty). Nodes are taken in pairs so that only about 3n/2
+// comparisons are needed, instead of the 2n needed by calling "linked_list_find_min" and "linked_list_find_max"
+// separately. As with those two functions, ties resolve to the first occurrence.
+//
+static inline void linked_list_find_minmax( const ll_t * head, void ** min, void ** max, int (*compare)(const void * item_one, const void * item_two) )
+{
+    ll_t * node = head->next;
+    ll_t * node_min = node, * node_max = node;
+
+    if( node == head )
+    {
+        *min = *max = NULL;
+        return;
+    }
+
+    for( node = node->next; node != head && node->next != head; node = node->next->next )
+    {
+        ll_t * small = node, * large = node;
+        int order = compare( node, node->next );
+
+        if( order < 0 ) large = node->next;
+        else if( order > 0 ) small = node->next;
+
+        if( compare( small, node_min ) < 0 ) node_min = small;
+        if( compare( large, node_max ) > 0 ) node_max = large;
+    }
+
+    // With an even number of nodes, the last one is left over after pairing.
+    //
+    if( node != head )
+    {
+        if( compare( node, node_min ) < 0 ) node_min = node;
+        else if( compare( node, node_max ) > 0 ) node_max = node;
+    }
+
+    *min = node_min;
+    *max = node_max;
+}
+
+// Restores the min-heap property for the node pointer at position "pos" of an array-based binary heap of node
+// pointers. Helper function used by "linked_list_top_k".
+//
+static inline void linked_list_heap_sift_down( void ** heap, size_t num, size_t pos, int (*compare)(const void * item_one, const void * item_two) )
+{
+    for( size_t child = 2*pos + 1; child < num; pos = child, child = 2*pos + 1 )
+    {
+        if( child + 1 < num && compare( heap[child + 1], heap[child] ) < 0 ) child++;
+        if( compare( heap[child], heap[pos] ) >= 0 ) break;
+
+        void * temp = heap[pos];
+        heap[pos] = heap[child];
+        heap[child] = temp;
+    }
+}
+
+// Stores in "top" the addresses of the "k" largest values in the linked list, ordered from largest to smallest.
+// Does NOT modify the list. Returns the number of addresses stored, which is the smaller of "k" and the length of the
+// list. As with "array_top_k", only a single pass is made over the list while "top" is kept as a bounded min-heap,
+// so each node costs one comparison unless it belongs in the top "k". To get the "k" _smallest_ values instead,
+// reverse the order of the comparison function.
+//
+// **WARNING**: This function _assumes_ that "top" is large enough to hold "k" pointers.
+//
+static inline int linked_list_top_k( const ll_t * head, size_t k, void ** top, int (*compare)(const void * item_one, const void * item_two) )
+{
+    size_t count = 0;
+    ll_t * node;
+
+    if( k == 0 ) return 0;
+
+    list_for_each( node, head )
+    {
+        if( count < k )
+        {
+            top[count] = node;
+            if( ++count == k )
+            {
+                for( size_t idx = k / 2; idx-- > 0; ) linked_list_heap_sift_down( top, k, idx, compare );
+            }
+        }
+        else if( compare( node, top[0] ) > 0 )
+        {
+            top[0] = node;
+            linked_list_heap_sift_down( top, k, 0, compare );
+        }
+    }
+
+    if( count < k )
+    {
+        for( size_t idx = count / 2; idx-- > 0; ) linked_list_heap_sift_down( top, count, idx, compare );
+    }
+
+    for( size_t end = count; end-- > 1; )
+    {
+        void * temp = top[0];
+        top[0] = top[end];
+        top[end] = temp;
+        linked_list_heap_sift_down( top, end, 0, compare );
+    }
+
+    return count;
+}
+
 // Keeps only those elements in a list for which the function "keep_this" returns "true", removing every other
 // element and adding it to the list "removed_nodes" (if not NULL). Returns the number of elements that were
 // removed, for the purpose of allowing client code to iterate over the removed nodes to deinitialize and/or
@@ -156,6 +455,53 @@ static inline int linked_list_filter_in_place( ll_t * head, ll_t * removed_nodes
     return removed_count;
 }
 
+// Removes every element of a list that compares equal to an earlier element, keeping the first occurrence of each and
+// the order of the elements kept, and adds the removed elements to the list "removed_nodes" (if not NULL), as
+// "linked_list_filter_in_place" does. Returns the number of elements that were removed, or -1 if the hash table
+// couldn't be allocated (in which case nothing is removed).
+//
+// With a "hash" function (which must return the same value for any two elements that compare equal), the list can be
+// in any order: the list is counted, a hash table with room for every element is allocated, and the elements seen so
+// far are kept in it, so this takes O(n) expected time instead of a call to "linked_list_find" for every element. If
+// "hash" is NULL, the list must be sorted: each element is only compared with the last one kept, and nothing is
+// allocated.
+//
+static inline int linked_list_unique( ll_t * head, ll_t * removed_nodes, uint64_t (*hash)(const void * elem), int (*compare)(const void * item_one, const void * item_two) )
+{
+    int removed_count = 0;
+    ll_t * node, * copy, * last_kept = NULL;
+    unique_set_t set;
+    size_t num = 0;
+
+    if( hash )
+    {
+        list_for_each( node, head ) num++;
+        if( !unique_set_init( &set, num ) ) return -1;
+    }
+
+    list_for_each_safe( node, copy, head )
+    {
+        bool is_new;
+
+        if( hash ) is_new = unique_set_insert( &set, node, hash( node ), compare ) > 0;    // Never has to grow
+        else is_new = last_kept == NULL || compare( last_kept, node ) != 0;
+
+        if( is_new )
+        {
+            last_kept = node;
+            continue;
+        }
+
+        list_del( node );
+        if( removed_nodes ) list_add_tail( node, removed_nodes );
+        removed_count++;
+    }
+
+    if( hash ) unique_set_free( &set );
+
+    return removed_count;
+}
+
 // Adds to "filtered_list" only those elements in the list that starts with "head" for which the function "keep_this"
 // returns "true". Uses the function "copy_node" to create new nodes with the same data as the items to be kept and
 // adds them to "filtered_list". Does NOT modify the list that starts with "head". Returns the number of elements
@@ -0,0 +1,332 @@
+#ifndef LIST_SEGMENTS_H
+#define LIST_SEGMENTS_H
+
+#include <stdint.h>         // For SIZE_MAX
+#include <stdlib.h>         // For malloc, realloc, free
+#include <stdbool.h>        // For bool
+#include <stdatomic.h>      // For atomic_size_t
+#include "ll.h"
+#include "parallel.h"
+
+// Parallel versions of "linked_list_count", "linked_list_find", and "linked_list_filter_in_place". A thread can only
+// start working part way through a list if it knows where that part starts, and finding that out means walking the
+// list from "head", which costs as much as the serial operation. So the list is walked once, up front, to record a
+// "marker" (a pointer to a node) every "segment_length" nodes. The markers can then be reused for any number of
+// parallel operations: the segments are divided evenly between the threads, and each thread walks only its own.
+//
+//     list_segments_t segments;
+//     list_segments_build( &segments, &orders, 65536 );
+//
+//     long long num_open = linked_list_count_par( &segments, is_open, 0 );
+//     order_t * order = linked_list_find_par( &key, &segments, compare_order_id, 0 );
+//     linked_list_filter_in_place_par( &segments, &closed_orders, is_open, 0 );
+//
+//     list_segments_free( &segments );
+//
+// The markers stay valid as nodes are added to the list (a new node just makes the segment it lands in longer), and
+// "linked_list_filter_in_place_par" updates them itself. Removing or moving a marker node any other way (e.g. with
+// "list_del" or a sort) invalidates the markers; call "list_segments_build" again after doing so. Rebuilding now and
+// then is also worthwhile if the segments have become very uneven in length.
+//
+// "num_threads" is the number of threads to use, including the calling thread; pass 0 to use one per online CPU. The
+// callbacks are called from several threads at once, so they must be safe to call concurrently.
+
+typedef struct list_segments_t
+{
+    ll_t *      head;
+    ll_t **     first;              // First node of each segment
+    size_t      num_segments;
+} list_segments_t;
+
+// Walks the list once, recording the first node of every run of "segment_length" nodes. Returns "false" if the markers
+// couldn't be allocated.
+//
+static inline bool list_segments_build( list_segments_t * segments, ll_t * head, size_t segment_length )
+{
+    size_t capacity = 64, count = 0;
+    ll_t * node;
+
+    segments->head = head;
+    segments->num_segments = 0;
+    segments->first = malloc( capacity * sizeof(ll_t *) );
+    if( segments->first == NULL ) return false;
+
+    if( segment_length == 0 ) segment_length = 1;
+
+    list_for_each( node, head )
+    {
+        if( count++ % segment_length ) continue;
+
+        if( segments->num_segments == capacity )
+        {
+            ll_t ** bigger = realloc( segments->first, 2 * capacity * sizeof(ll_t *) );
+            if( bigger == NULL )
+            {
+                free( segments->first );
+                segments->first = NULL;
+                return false;
+            }
+            segments->first = bigger;
+            capacity *= 2;
+        }
+        segments->first[segments->num_segments++] = node;
+    }
+
+    return true;
+}
+
+static inline void list_segments_free( list_segments_t * segments )
+{
+    free( segments->first );
+    segments->first = NULL;
+    segments->num_segments = 0;
+}
+
+// Returns the first node of segment "idx". The first segment always starts at the front of the list, so that it picks
+// up any nodes that were added in front of its marker.
+//
+static inline ll_t * list_segments_start( const list_segments_t * segments, size_t idx )
+{
+    return idx == 0 ? segments->head->next : segments->first[idx];
+}
+
+// Returns the node just past the end of segment "idx": the first node of the next segment, or the head of the list.
+//
+static inline ll_t * list_segments_end( const list_segments_t * segments, size_t idx )
+{
+    return idx + 1 < segments->num_segments ? segments->first[idx + 1] : segments->head;
+}
+
+// The work given to one thread: segments "[first_segment, end_segment)", and the result of working on them.
+//
+typedef struct list_segments_task_t
+{
+    list_segments_t *   segments;
+    size_t              first_segment;
+    size_t              end_segment;
+    size_t              thread;
+    const void *        key;
+    int                 (*compare)(const void * key, const void * elem);
+    bool                (*predicate)(const void * elem);
+    atomic_size_t *     best_thread;        // Used by "linked_list_find_par"
+    long long           count;
+    void *              found;
+    ll_t *              part;               // Used by "linked_list_filter_in_place_par"
+    ll_t                removed;
+    bool                keep_removed;       // Whether to collect removed nodes in "removed", or just unlink them
+} list_segments_task_t;
+
+// Divides the segments evenly between "num_threads" tasks, which must be no more than the number of segments.
+//
+static inline void list_segments_divide( list_segments_t * segments, list_segments_task_t * tasks, size_t num_threads )
+{
+    for( size_t thread = 0; thread < num_threads; thread++ )
+    {
+        list_segments_task_t * task = &tasks[thread];
+
+        task->segments = segments;
+        task->first_segment = segments->num_segments * thread / num_threads;
+        task->end_segment = segments->num_segments * (thread + 1) / num_threads;
+        task->thread = thread;
+        task->count = 0;
+        task->found = NULL;
+    }
+}
+
+// Returns the number of threads to use: one per segment at most.
+//
+static inline size_t list_segments_threads( const list_segments_t * segments, size_t num_threads )
+{
+    num_threads = parallel_threads( num_threads );
+    if( num_threads > segments->num_segments ) num_threads = segments->num_segments;
+
+    return num_threads > 0 ? num_threads : 1;
+}
+
+static inline void * list_segments_count_task( void * arg )
+{
+    list_segments_task_t * task = arg;
+    ll_t * node = list_segments_start( task->segments, task->first_segment );
+    ll_t * end = list_segments_end( task->segments, task->end_segment - 1 );
+
+    for( ; node != end; node = node->next )
+    {
+        if( task->predicate( node ) ) task->count++;
+    }
+
+    return NULL;
+}
+
+// Counts the number of items in the list for which the function "count_this" returns "true". See "linked_list_count".
+//
+static inline long long linked_list_count_par( list_segments_t * segments, bool (*count_this)(const void * elem), size_t num_threads )
+{
+    num_threads = list_segments_threads( segments, num_threads );
+    list_segments_task_t tasks[num_threads];
+    long long count = 0;
+
+    if( segments->num_segments == 0 ) return 0;
+
+    list_segments_divide( segments, tasks, num_threads );
+    for( size_t thread = 0; thread < num_threads; thread++ ) tasks[thread].predicate = count_this;
+
+    parallel_run( list_segments_count_task, tasks, sizeof(tasks[0]), num_threads );
+
+    for( size_t thread = 0; thread < num_threads; thread++ ) count += tasks[thread].count;
+
+    return count;
+}
+
+static inline void * list_segments_find_task( void * arg )
+{
+    list_segments_task_t * task = arg;
+    ll_t * node = list_segments_start( task->segments, task->first_segment );
+    ll_t * end = list_segments_end( task->segments, task->end_segment - 1 );
+    size_t steps = 0;
+
+    for( ; node != end; node = node->next )
+    {
+        // Every so often, check whether a thread working on an earlier part of the list has already found a match, in
+        // which case nothing this thread finds can be the first one.
+        //
+        if( ( ++steps & 1023 ) == 0 && atomic_load_explicit( task->best_thread, memory_order_relaxed ) < task->thread ) break;
+
+        if( 0 == task->compare( task->key, node ) )
+        {
+            task->found = node;
+
+            size_t best = atomic_load( task->best_thread );
+            while( task->thread < best && !atomic_compare_exchange_weak( task->best_thread, &best, task->thread ) );
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+// Linear search. Returns a pointer to the _first_ matching node in list order, as "linked_list_find" would, or NULL if
+// not found. Threads searching later parts of the list stop early once an earlier part has a match.
+//
+static inline void * linked_list_find_par( const void * key, list_segments_t * segments, int (*compare)(const void * key, const void * elem), size_t num_threads )
+{
+    num_threads = list_segments_threads( segments, num_threads );
+    list_segments_task_t tasks[num_threads];
+    atomic_size_t best_thread = SIZE_MAX;
+
+    if( segments->num_segments == 0 ) return NULL;
+
+    list_segments_divide( segments, tasks, num_threads );
+    for( size_t thread = 0; thread < num_threads; thread++ )
+    {
+        tasks[thread].key = key;
+        tasks[thread].compare = compare;
+        tasks[thread].best_thread = &best_thread;
+    }
+
+    parallel_run( list_segments_find_task, tasks, sizeof(tasks[0]), num_threads );
+
+    for( size_t thread = 0; thread < num_threads; thread++ )
+    {
+        if( tasks[thread].found ) return tasks[thread].found;
+    }
+
+    return NULL;
+}
+
+// Filters one thread's part of the list, which has been cut out into its own list "part", recording the first kept node
+// of each segment (or NULL if none were kept).
+//
+static inline void * list_segments_filter_task( void * arg )
+{
+    list_segments_task_t * task = arg;
+    ll_t * head = task->part, * node = head->next;
+
+    for( size_t idx = task->first_segment; idx < task->end_segment; idx++ )
+    {
+        ll_t * end = idx + 1 < task->end_segment ? task->segments->first[idx + 1] : head;
+
+        task->segments->first[idx] = NULL;
+        while( node != end )
+        {
+            ll_t * next = node->next;
+
+            if( task->predicate( node ) )
+            {
+                if( task->segments->first[idx] == NULL ) task->segments->first[idx] = node;
+            }
+            else
+            {
+                list_del( node );
+                if( task->keep_removed ) list_add_tail( node, &task->removed );
+                task->count++;
+            }
+            node = next;
+        }
+    }
+
+    return NULL;
+}
+
+// Keeps only those elements in the list for which the function "keep_this" returns "true", moving every other element
+// to the end of the list "removed_nodes" (if not NULL), in list order. Returns the number of elements that were
+// removed. If "removed_nodes" is NULL, the removed nodes are left with NULL links, as "linked_list_filter_in_place"
+// leaves them. See "linked_list_filter_in_place". Each thread's part of the list is cut out into a separate list while it's
+// filtered, so that no two threads ever touch the same node, and the parts are joined back together afterward. The
+// markers are updated to point at the first kept node of each segment, and segments with no kept nodes are dropped.
+//
+static inline long long linked_list_filter_in_place_par( list_segments_t * segments, ll_t * removed_nodes, bool (*keep_this)(const void * elem), size_t num_threads )
+{
+    num_threads = list_segments_threads( segments, num_threads );
+    list_segments_task_t tasks[num_threads];
+    ll_t parts[num_threads];
+    ll_t * head = segments->head;
+    long long removed_count = 0;
+
+    if( segments->num_segments == 0 ) return 0;
+
+    // (1) Cut the list into one part per thread. The parts are cut from the back, so that "head->prev" is always the
+    // last node of the part being cut.
+    //
+    list_segments_divide( segments, tasks, num_threads );
+    for( size_t thread = num_threads; thread-- > 0; )
+    {
+        list_segments_task_t * task = &tasks[thread];
+        ll_t * first = list_segments_start( segments, task->first_segment ), * last = head->prev;
+
+        parts[thread].next = first;
+        parts[thread].prev = last;
+        head->prev = first->prev;
+        first->prev->next = head;
+        first->prev = &parts[thread];
+        last->next = &parts[thread];
+
+        task->predicate = keep_this;
+        task->part = &parts[thread];
+        task->removed.next = task->removed.prev = &task->removed;
+        task->keep_removed = removed_nodes != NULL;
+    }
+
+    // (2) Filter the parts.
+    //
+    parallel_run( list_segments_filter_task, tasks, sizeof(tasks[0]), num_threads );
+
+    // (3) Join the parts back together, collect the removed nodes, and drop the markers of segments that ended up
+    // empty.
+    //
+    size_t num_segments = 0;
+    for( size_t thread = 0; thread < num_threads; thread++ )
+    {
+        list_splice_tail( &parts[thread], head );
+        if( removed_nodes ) list_splice_tail( &tasks[thread].removed, removed_nodes );
+        removed_count += tasks[thread].count;
+    }
+    for( size_t idx = 0; idx < segments->num_segments; idx++ )
+    {
+        if( segments->first[idx] ) segments->first[num_segments++] = segments->first[idx];
+    }
+    segments->num_segments = num_segments;
+
+    return removed_count;
+}
+
+#endif // LIST_SEGMENTS_H
@@ -0,0 +1,361 @@
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+#include <stdint.h>     // For uint64_t
+#include <stdlib.h>     // For calloc, free
+#include <stdbool.h>    // For bool
+#include <pthread.h>    // For pthread_mutex_t
+#include "ll.h"
+
+// A least-recently-used cache of intrusive nodes. Each cached object embeds an "lru_node_t", which holds the object's
+// 64-bit key and the "ll_t" that links it into the cache's recency list (most recently used first). Finding a key
+// doesn't walk that list: a separate open-addressing hash table maps each key to its node, so "lru_cache_get",
+// "lru_cache_put" and eviction each take O(1) time, and a lookup usually touches just one cache line of the table plus
+// the node it finds.
+//
+// The table stores each key next to its node pointer, so probing never has to follow a pointer to compare keys. It
+// uses linear probing, is kept at most half full, and deletes by shifting later entries back (no tombstones), so
+// lookups stay short no matter how many keys have come and gone.
+//
+// The cache never allocates or frees nodes. When it's full, "lru_cache_put" removes the least recently used node and
+// passes it to the "evict" callback, which would typically free the object (or return it to a pool). Ex:
+//
+//     typedef struct session_t
+//     {
+//         lru_node_t  lru;
+//         char        user[32];
+//     } session_t;
+//
+//     void free_session( lru_node_t * node, void * context )
+//     {
+//         free( list_entry( node, session_t, lru ) );
+//     }
+//
+//     lru_cache_t sessions;
+//     lru_cache_init( &sessions, 10000, free_session, NULL );
+//
+//     session_t * session = malloc( sizeof(session_t) );
+//     session->lru.key = session_id;
+//     lru_cache_put( &sessions, &session->lru );
+//
+//     lru_node_t * found = lru_cache_get( &sessions, session_id );
+//     if( found ) session = list_entry( found, session_t, lru );
+//
+// An "lru_cache_t" is not thread-safe. For use from several threads, "lru_sharded_t" splits the keys over several
+// independent caches, each with its own lock.
+
+typedef struct lru_node_t
+{
+    ll_t        list;
+    uint64_t    key;
+} lru_node_t;
+
+typedef struct lru_slot_t
+{
+    uint64_t        key;
+    lru_node_t *    node;       // NULL for an empty slot
+} lru_slot_t;
+
+typedef struct lru_cache_t
+{
+    ll_t            recency;    // Most recently used node first
+    lru_slot_t *    slots;
+    size_t          mask;       // Number of slots minus one (the number of slots is a power of two)
+    int             shift;      // 64 minus log2 of the number of slots
+    size_t          count;
+    size_t          capacity;
+    void            (*evict)(lru_node_t * node, void * context);
+    void *          context;
+} lru_cache_t;
+
+// Mixes all the bits of the key (the finalizer from MurmurHash3), so that keys which differ only in a few bits, such
+// as sequential IDs, still spread over the whole table.
+//
+static inline uint64_t lru_hash( uint64_t key )
+{
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+    key *= 0xC4CEB9FE1A85EC53ULL;
+    key ^= key >> 33;
+
+    return key;
+}
+
+// Home slot of "key": the top bits of its hash ("lru_sharded_t" picks a shard with the bottom bits).
+//
+static inline size_t lru_cache_home( const lru_cache_t * cache, uint64_t key )
+{
+    return lru_hash( key ) >> cache->shift;
+}
+
+// Prepares an empty cache that holds up to "capacity" nodes. "evict" (if not NULL) is called with each node that the
+// cache drops to make room, or that "lru_cache_put" replaces, along with "context". Returns "false" if "capacity" is 0
+// or the table couldn't be allocated.
+//
+static inline bool lru_cache_init( lru_cache_t * cache, size_t capacity, void (*evict)(lru_node_t * node, void * context), void * context )
+{
+    size_t num_slots = 2;
+    int bits = 1;
+
+    if( capacity == 0 ) return false;
+    while( num_slots < 2 * capacity )
+    {
+        num_slots *= 2;
+        bits++;
+    }
+
+    cache->slots = calloc( num_slots, sizeof(lru_slot_t) );
+    if( cache->slots == NULL ) return false;
+
+    cache->recency.next = cache->recency.prev = &cache->recency;
+    cache->mask = num_slots - 1;
+    cache->shift = 64 - bits;
+    cache->count = 0;
+    cache->capacity = capacity;
+    cache->evict = evict;
+    cache->context = context;
+
+    return true;
+}
+
+// Frees the table, first passing every node still in the cache to the "evict" callback (least recently used first).
+//
+static inline void lru_cache_free( lru_cache_t * cache )
+{
+    ll_t * node, * copy;
+
+    if( cache->evict )
+    {
+        for( node = cache->recency.prev, copy = node->prev; node != &cache->recency; node = copy, copy = node->prev )
+        {
+            cache->evict( (lru_node_t *)node, cache->context );
+        }
+    }
+    free( cache->slots );
+    cache->slots = NULL;
+    cache->count = 0;
+    cache->recency.next = cache->recency.prev = &cache->recency;
+}
+
+// Returns the slot that holds "key", or the empty slot where it would go.
+//
+static inline size_t lru_cache_probe( const lru_cache_t * cache, uint64_t key )
+{
+    size_t pos = lru_cache_home( cache, key );
+
+    while( cache->slots[pos].node && cache->slots[pos].key != key ) pos = ( pos + 1 ) & cache->mask;
+
+    return pos;
+}
+
+// Empties slot "pos", moving back any later entries of the same probe sequence that can no longer be reached without
+// it. An entry at "next" can fill the hole at "pos" unless its home slot lies cyclically in (pos, next].
+//
+static inline void lru_cache_remove_slot( lru_cache_t * cache, size_t pos )
+{
+    size_t next = pos;
+
+    for( ;; )
+    {
+        next = ( next + 1 ) & cache->mask;
+        if( cache->slots[next].node == NULL ) break;
+
+        size_t home = lru_cache_home( cache, cache->slots[next].key );
+        if( ( ( next - home ) & cache->mask ) >= ( ( next - pos ) & cache->mask ) )
+        {
+            cache->slots[pos] = cache->slots[next];
+            pos = next;
+        }
+    }
+    cache->slots[pos].node = NULL;
+}
+
+// Returns the node with "key" without changing the order of recency, or NULL if it isn't cached.
+//
+static inline lru_node_t * lru_cache_peek( const lru_cache_t * cache, uint64_t key )
+{
+    return cache->slots[lru_cache_probe( cache, key )].node;
+}
+
+// Returns the node with "key" and marks it as the most recently used, or returns NULL if it isn't cached.
+//
+static inline lru_node_t * lru_cache_get( lru_cache_t * cache, uint64_t key )
+{
+    lru_node_t * node = lru_cache_peek( cache, key );
+
+    if( node && cache->recency.next != &node->list )
+    {
+        list_del( &node->list );
+        list_add( &node->list, &cache->recency );
+    }
+
+    return node;
+}
+
+// Removes the node with "key" from the cache and returns it (without calling "evict"), or returns NULL if it isn't
+// cached.
+//
+static inline lru_node_t * lru_cache_remove( lru_cache_t * cache, uint64_t key )
+{
+    size_t pos = lru_cache_probe( cache, key );
+    lru_node_t * node = cache->slots[pos].node;
+
+    if( node )
+    {
+        lru_cache_remove_slot( cache, pos );
+        list_del( &node->list );
+        cache->count--;
+    }
+
+    return node;
+}
+
+// Removes the least recently used node and passes it to "evict". Returns "false" if the cache was empty.
+//
+static inline bool lru_cache_evict( lru_cache_t * cache )
+{
+    if( cache->count == 0 ) return false;
+
+    lru_node_t * node = lru_cache_remove( cache, ((lru_node_t *)cache->recency.prev)->key );
+    if( cache->evict ) cache->evict( node, cache->context );
+
+    return true;
+}
+
+// Adds "node" to the cache under "node->key", as the most recently used. If another node already has the same key,
+// it's replaced and passed to "evict"; otherwise, if the cache is full, the least recently used node is evicted to
+// make room. "node" must not already be in the cache.
+//
+static inline void lru_cache_put( lru_cache_t * cache, lru_node_t * node )
+{
+    size_t pos = lru_cache_probe( cache, node->key );
+    lru_node_t * old = cache->slots[pos].node;
+
+    if( old )
+    {
+        cache->slots[pos].node = node;
+        list_del( &old->list );
+        list_add( &node->list, &cache->recency );
+        if( cache->evict ) cache->evict( old, cache->context );
+        return;
+    }
+
+    if( cache->count == cache->capacity )
+    {
+        lru_cache_evict( cache );
+        pos = lru_cache_probe( cache, node->key );     // Eviction may have shifted entries into "pos"
+    }
+
+    cache->slots[pos].key = node->key;
+    cache->slots[pos].node = node;
+    list_add( &node->list, &cache->recency );
+    cache->count++;
+}
+
+// A cache for use by several threads at once: the keys are divided over "num_shards" independent caches (by the
+// bottom bits of their hash), each protected by its own mutex, so threads only contend when they use the same shard.
+//
+// Another thread may evict a node as soon as its shard is unlocked, so the sharded functions never return a cached
+// node. "lru_sharded_get" instead calls "visit" on the node while the shard is still locked, to copy out whatever the
+// caller needs. "evict" is also called with the shard locked, so it must not call back into the cache.
+
+typedef struct lru_shard_t
+{
+    pthread_mutex_t lock;
+    lru_cache_t     cache;
+} __attribute__((aligned(64))) lru_shard_t;     // One cache line (or more) per shard, so that locks don't share one
+
+typedef struct lru_sharded_t
+{
+    lru_shard_t *   shards;
+    size_t          num_shards;     // A power of two
+} lru_sharded_t;
+
+// Frees every shard (evicting the nodes still in them, as "lru_cache_free" does).
+//
+static inline void lru_sharded_free( lru_sharded_t * sharded )
+{
+    for( size_t idx = 0; idx < sharded->num_shards; idx++ )
+    {
+        lru_cache_free( &sharded->shards[idx].cache );
+        pthread_mutex_destroy( &sharded->shards[idx].lock );
+    }
+    free( sharded->shards );
+    sharded->shards = NULL;
+    sharded->num_shards = 0;
+}
+
+// Prepares "num_shards" caches (rounded up to a power of two) that together hold up to "capacity" nodes. Each shard
+// evicts on its own, so when the keys aren't spread evenly, a shard may evict while there is room in others. Returns
+// "false" if memory couldn't be allocated.
+//
+static inline bool lru_sharded_init( lru_sharded_t * sharded, size_t num_shards, size_t capacity, void (*evict)(lru_node_t * node, void * context), void * context )
+{
+    size_t shards = 1;
+
+    while( shards < num_shards ) shards *= 2;
+
+    sharded->shards = aligned_alloc( 64, shards * sizeof(lru_shard_t) );
+    sharded->num_shards = 0;
+    if( sharded->shards == NULL ) return false;
+
+    for( size_t idx = 0; idx < shards; idx++ )
+    {
+        if( !lru_cache_init( &sharded->shards[idx].cache, ( capacity + shards - 1 ) / shards, evict, context ) )
+        {
+            lru_sharded_free( sharded );
+            return false;
+        }
+        pthread_mutex_init( &sharded->shards[idx].lock, NULL );
+        sharded->num_shards++;
+    }
+
+    return true;
+}
+
+static inline lru_shard_t * lru_sharded_shard( const lru_sharded_t * sharded, uint64_t key )
+{
+    return &sharded->shards[lru_hash( key ) & ( sharded->num_shards - 1 )];
+}
+
+// Looks up "key" and, if it's cached, marks it as the most recently used in its shard and calls "visit( node,
+// context )" before unlocking the shard. Returns "false" if the key isn't cached.
+//
+static inline bool lru_sharded_get( lru_sharded_t * sharded, uint64_t key, void (*visit)(lru_node_t * node, void * context), void * context )
+{
+    lru_shard_t * shard = lru_sharded_shard( sharded, key );
+
+    pthread_mutex_lock( &shard->lock );
+    lru_node_t * node = lru_cache_get( &shard->cache, key );
+    if( node && visit ) visit( node, context );
+    pthread_mutex_unlock( &shard->lock );
+
+    return node != NULL;
+}
+
+// Same as "lru_cache_put", on the shard for "node->key".
+//
+static inline void lru_sharded_put( lru_sharded_t * sharded, lru_node_t * node )
+{
+    lru_shard_t * shard = lru_sharded_shard( sharded, node->key );
+
+    pthread_mutex_lock( &shard->lock );
+    lru_cache_put( &shard->cache, node );
+    pthread_mutex_unlock( &shard->lock );
+}
+
+// Same as "lru_cache_remove": the node that's returned no longer belongs to the cache.
+//
+static inline lru_node_t * lru_sharded_remove( lru_sharded_t * sharded, uint64_t key )
+{
+    lru_shard_t * shard = lru_sharded_shard( sharded, key );
+
+    pthread_mutex_lock( &shard->lock );
+    lru_node_t * node = lru_cache_remove( &shard->cache, key );
+    pthread_mutex_unlock( &shard->lock );
+
+    return node;
+}
+
+#endif // LRU_CACHE_H
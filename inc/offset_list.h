@@ -0,0 +1,295 @@
+#ifndef OFFSET_LIST_H
+#define OFFSET_LIST_H
+
+#include <stddef.h>     // For ptrdiff_t
+#include <stdbool.h>    // For bool
+
+// A position-independent version of the circular, doubly-linked "ll_t" list from "ll.h". Instead of holding the
+// _addresses_ of the next and previous nodes, each node holds the _distance_ (in bytes) from itself to those nodes:
+//
+//     ll_t:   node->next == address of next node
+//     oll_t:  (char *)node + node->next == address of next node
+//
+// Since only the distances between nodes are stored, a list keeps working when the block of memory holding it is
+// mapped at a different address: a shared-memory segment that each process maps wherever it likes, or a file that is
+// saved and later reopened with "mmap". The head of the list and all of its nodes must be in the same block of memory
+// for this to work (e.g. put the head in a header at the start of the shared segment).
+//
+// A distance of 0 means a node points at itself, so an empty list (a head that points at itself in both directions) is
+// just a head with both fields set to 0. This means zero-filled memory (such as a freshly created shared-memory
+// segment) already holds a valid, empty list.
+//
+// The functions below mirror the ones in "ll.h" (with an "oll_" prefix) and "linked_list_methods_EmbArt.h" (with an
+// "offset_list_" prefix). As with those, the "oll_t" node is meant to be the first member of a container struct, and
+// the callbacks are passed a pointer to the node, which can be cast to the container type. Ex:
+//
+//     typedef struct
+//     {
+//         oll_t       node;
+//         uint32_t    data;
+//     } job_t;
+//
+//     typedef struct
+//     {
+//         oll_t       queue;              // Head of the list
+//         job_t       jobs[1024];         // Storage for the nodes
+//     } shared_region_t;
+//
+//     shared_region_t * region = mmap( NULL, sizeof(shared_region_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+//
+//     oll_add_tail( &region->jobs[0].node, &region->queue );
+//     int num_odd = offset_list_count( &region->queue, is_odd_job );
+//
+// **WARNING**: Never link a node into a list in a different block of memory (e.g. a head on the stack and nodes in a
+// shared segment). It will work in the process that did the linking, but the list will be broken everywhere else.
+
+typedef struct oll_head
+{
+    /// Distance in bytes from this node to the next element in the list.
+    ptrdiff_t next;
+    /// Distance in bytes from this node to the previous element in the list.
+    ptrdiff_t prev;
+} oll_t;
+
+// Initialize a list so it points to itself.
+//
+#define oll_head_INIT { 0, 0 }
+#define OLL_INIT(name) struct oll_head name = oll_head_INIT
+
+// Get the next and previous nodes.
+//
+static inline oll_t * oll_next( const oll_t * node )
+{
+    return (oll_t *)( (char *)node + node->next );
+}
+
+static inline oll_t * oll_prev( const oll_t * node )
+{
+    return (oll_t *)( (char *)node + node->prev );
+}
+
+// Set the next and previous nodes.
+//
+static inline void oll_set_next( oll_t * node, const oll_t * next )
+{
+    node->next = (char *)next - (char *)node;
+}
+
+static inline void oll_set_prev( oll_t * node, const oll_t * prev )
+{
+    node->prev = (char *)prev - (char *)node;
+}
+
+// Iterate over a list, in the same manner as "list_for_each" and "list_for_each_safe".
+//
+#define oll_for_each(pos, head) for(pos = oll_next(head); pos != (head); pos = oll_next(pos))
+
+#define oll_for_each_safe(pos, n, head) \
+	for(pos = oll_next(head), n = oll_next(pos); pos != (head); pos = n, n = oll_next(pos))
+
+static inline void oll_init( oll_t * head )
+{
+    head->next = head->prev = 0;
+}
+
+static inline bool oll_empty( const oll_t * head )
+{
+    return head->next == 0;
+}
+
+// Insert a new element between two existing elements.
+//
+static inline void oll_insert( oll_t * n, oll_t * prev, oll_t * next )
+{
+    oll_set_prev( next, n );
+    oll_set_next( n, next );
+    oll_set_prev( n, prev );
+    oll_set_next( prev, n );
+}
+
+// Add a node to the front of the list.
+//
+static inline void oll_add( oll_t * n, oll_t * head )
+{
+    oll_insert( n, head, oll_next( head ) );
+}
+
+// Add a node to the end of the list.
+//
+static inline void oll_add_tail( oll_t * n, oll_t * head )
+{
+    oll_insert( n, oll_prev( head ), head );
+}
+
+// Join the "prev" and "next" elements together, removing whatever was between them.
+//
+static inline void oll_join_nodes( oll_t * prev, oll_t * next )
+{
+    oll_set_prev( next, prev );
+    oll_set_next( prev, next );
+}
+
+// Remove an entry from the list. The removed entry is left pointing to itself.
+//
+static inline void oll_del( oll_t * entry )
+{
+    oll_join_nodes( oll_prev( entry ), oll_next( entry ) );
+    entry->next = entry->prev = 0;
+}
+
+// Linear search. Returns a pointer to the value, if found, or NULL if not found.
+//
+static inline void * offset_list_find( const void * key, const oll_t * head, int (*compare)(const void * key, const void * elem) )
+{
+    oll_t * node;
+
+    oll_for_each( node, head )
+    {
+        if( 0 == compare( key, node ) ) return node;
+    }
+
+    return NULL;
+}
+
+// Counts the number of items in the list for which the function "count_this" returns "true".
+//
+static inline int offset_list_count( const oll_t * head, bool (*count_this)(const void * elem) )
+{
+    int count = 0;
+    oll_t * node;
+
+    oll_for_each( node, head )
+    {
+        if( count_this( node ) ) count++;
+    }
+
+    return count;
+}
+
+// Keeps only those elements in a list for which the function "keep_this" returns "true", removing every other
+// element and adding it to the list "removed_nodes" (if not NULL). Returns the number of elements that were removed.
+// See "linked_list_filter_in_place".
+//
+static inline int offset_list_filter_in_place( oll_t * head, oll_t * removed_nodes, bool (*keep_this)(const void * elem) )
+{
+    int removed_count = 0;
+    oll_t * node, * copy;
+
+    oll_for_each_safe( node, copy, head )
+    {
+        if( !keep_this( node ) )
+        {
+            oll_del( node );
+            if( removed_nodes ) oll_add_tail( node, removed_nodes );
+            removed_count++;
+        }
+    }
+
+    return removed_count;
+}
+
+// Insert a node at the correct position in a sorted list (after any nodes that compare equal to it).
+//
+static inline void offset_list_sorted_insert( oll_t * head, oll_t * node_to_insert, int (*compare)(const void * key, const void * elem) )
+{
+    oll_t * node = oll_prev( head );
+
+    // Search from the back, so that inserting nodes that are already in order only takes one comparison each.
+    //
+    while( node != head && compare( node, node_to_insert ) > 0 ) node = oll_prev( node );
+
+    oll_insert( node_to_insert, node, oll_next( node ) );
+}
+
+// Merges two sorted chains of nodes that are linked only through "next", where the last node of each chain points to
+// itself (a "next" of 0) and an empty chain is NULL. Stable: when two elements compare equal, the one from "one" comes
+// first. Returns the first node of the merged chain. Helper function used by "offset_list_sort".
+//
+static inline oll_t * offset_list_merge_chains( oll_t * one, oll_t * two, int (*compare)(const void * item_one, const void * item_two) )
+{
+    oll_t * first = NULL, * tail = NULL;
+
+    while( one && two )
+    {
+        oll_t ** from = compare( two, one ) < 0 ? &two : &one, * node = *from;
+
+        *from = node->next ? oll_next( node ) : NULL;
+        if( tail ) oll_set_next( tail, node );
+        else first = node;
+        tail = node;
+    }
+    if( !tail ) return one ? one : two;
+    oll_set_next( tail, one ? one : two );
+
+    return first;
+}
+
+// Sorts the list with a bottom-up merge sort, which needs no memory beyond a small fixed array on the stack. The sort
+// is stable. See "pool_list_sort".
+//
+// Nodes are taken off the list one at a time and merged into "bins", where bin "k" holds a sorted chain of 2^k nodes
+// (or nothing). The chains are self-contained (their ends point to themselves, not to a temporary head), so no node is
+// ever linked to anything outside the list's block of memory. At the end, all of the bins are merged together and the
+// "prev" links are rebuilt in a single pass.
+//
+static inline void offset_list_sort( oll_t * head, int (*compare)(const void * item_one, const void * item_two) )
+{
+    oll_t * bins[sizeof(size_t) * 8] = { NULL };
+    oll_t * node = oll_next( head );
+
+    if( node == oll_prev( head ) ) return;      // Zero or one nodes
+
+    while( node != head )
+    {
+        oll_t * carry = node;
+        int bin = 0;
+
+        node = oll_next( node );
+        carry->next = 0;
+
+        // Bins hold nodes that came _earlier_ in the list, so they go first in each merge to keep the sort stable.
+        //
+        for( ; bins[bin]; bin++ )
+        {
+            carry = offset_list_merge_chains( bins[bin], carry, compare );
+            bins[bin] = NULL;
+        }
+        bins[bin] = carry;
+    }
+
+    oll_t * sorted = NULL;
+    for( size_t bin = 0; bin < sizeof(bins) / sizeof(bins[0]); bin++ )
+    {
+        if( bins[bin] ) sorted = offset_list_merge_chains( bins[bin], sorted, compare );
+    }
+
+    // Relink the "prev" distances and close the circle through the head.
+    //
+    oll_t * prev = head;
+    for( node = sorted; ; prev = node, node = oll_next( node ) )
+    {
+        bool last = node->next == 0;
+
+        oll_join_nodes( prev, node );
+        if( last ) break;
+    }
+    oll_join_nodes( node, head );
+}
+
+// Reverses the list. Because every link is relative, this only requires swapping the "next" and "prev" distances of
+// each node (including the head).
+//
+static inline void offset_list_reverse( oll_t * head )
+{
+    oll_t * node = head;
+
+    do
+    {
+        ptrdiff_t temp = node->next;
+        node->next = node->prev;
+        node->prev = temp;
+        node = oll_next( node );    // The old "prev", i.e. we walk the list backward, which visits every node once
+    } while( node != head );
+}
+
+#endif // OFFSET_LIST_H
@@ -0,0 +1,214 @@
+#ifndef PAIRING_HEAP_H
+#define PAIRING_HEAP_H
+
+#include <stdlib.h>     // For size_t, NULL
+#include <stdbool.h>    // For bool
+#include "ll.h"
+
+// An intrusive pairing heap: a priority queue of nodes embedded in the caller's own structures, in the same manner as
+// "ll_t". It's a tree in which every node compares less than or equal to its children, stored as "first child, next
+// sibling" links. Pushing a node, melding two heaps and moving a node earlier ("pairing_heap_decrease") each take O(1)
+// time, since they only link two trees together; popping the smallest node takes O(log n) amortized time, since that's
+// when its children are merged back into one tree (in pairs, left to right, and then right to left).
+//
+// Each node is a "pairing_node_t", whose "ll_t" links it to its siblings ("next" is the next sibling, "prev" is the
+// previous sibling, or the parent for a first child; both are NULL for the root), plus a pointer to its first child.
+// Nothing is allocated, so a node can be moved between heaps, or between a heap and a list, freely. As with the
+// functions in "linked_list_methods_EmbArt.h", the comparison function is passed pointers to the nodes, so the node
+// should be the first member of the structure that contains it. Ex:
+//
+//     typedef struct timer_t
+//     {
+//         pairing_node_t  node;
+//         uint64_t        deadline;
+//     } timer_t;
+//
+//     pairing_heap_t timers;
+//     pairing_heap_init( &timers );
+//     pairing_heap_push( &timers, &timer->node, compare_deadlines );
+//     ...
+//     timer_t * next = (timer_t *)pairing_heap_pop( &timers, compare_deadlines );
+
+typedef struct pairing_node_t
+{
+    ll_t                        link;       // Siblings (see above)
+    struct pairing_node_t *     child;      // First child, or NULL
+} pairing_node_t;
+
+typedef struct pairing_heap_t
+{
+    pairing_node_t *    root;
+    size_t              count;
+} pairing_heap_t;
+
+static inline void pairing_heap_init( pairing_heap_t * heap )
+{
+    heap->root = NULL;
+    heap->count = 0;
+}
+
+static inline bool pairing_heap_empty( const pairing_heap_t * heap )
+{
+    return heap->root == NULL;
+}
+
+// Returns the smallest node, without removing it, or NULL if the heap is empty.
+//
+static inline pairing_node_t * pairing_heap_top( const pairing_heap_t * heap )
+{
+    return heap->root;
+}
+
+// Makes the larger of the two roots "one" and "two" the first child of the other, and returns the new root. If they
+// compare equal, "one" stays the root. Leaves the sibling links of the returned root for the caller to set.
+//
+static inline pairing_node_t * pairing_heap_link( pairing_node_t * one, pairing_node_t * two, int (*compare)(const void * item_one, const void * item_two) )
+{
+    if( compare( two, one ) < 0 )
+    {
+        pairing_node_t * temp = one;
+        one = two;
+        two = temp;
+    }
+
+    two->link.prev = &one->link;
+    two->link.next = one->child ? &one->child->link : NULL;
+    if( one->child ) one->child->link.prev = &two->link;
+    one->child = two;
+
+    return one;
+}
+
+// Merges the list of siblings that starts with "first" into a single tree and returns its root, which has no siblings.
+// The first pass links siblings in pairs, from left to right; the second links the results, from right to left. This
+// is what keeps the tree shallow over a sequence of pops.
+//
+static inline pairing_node_t * pairing_heap_merge_pairs( pairing_node_t * first, int (*compare)(const void * item_one, const void * item_two) )
+{
+    pairing_node_t * pairs = NULL, * root;
+
+    if( first == NULL ) return NULL;
+
+    // (1) Left to right, each pair becomes one tree. The trees are collected in reverse order, through "link.next".
+    //
+    while( first )
+    {
+        pairing_node_t * second = (pairing_node_t *)first->link.next, * tree = first;
+
+        if( second )
+        {
+            first = (pairing_node_t *)second->link.next;
+            tree = pairing_heap_link( tree, second, compare );
+        }
+        else
+        {
+            first = NULL;
+        }
+
+        tree->link.next = pairs ? &pairs->link : NULL;
+        pairs = tree;
+    }
+
+    // (2) Right to left, each tree is linked into the one accumulated so far.
+    //
+    root = pairs;
+    pairs = (pairing_node_t *)pairs->link.next;
+    while( pairs )
+    {
+        pairing_node_t * next = (pairing_node_t *)pairs->link.next;
+        root = pairing_heap_link( pairs, root, compare );
+        pairs = next;
+    }
+
+    root->link.next = root->link.prev = NULL;
+
+    return root;
+}
+
+// Adds "node" to the heap.
+//
+static inline void pairing_heap_push( pairing_heap_t * heap, pairing_node_t * node, int (*compare)(const void * item_one, const void * item_two) )
+{
+    node->child = NULL;
+    node->link.next = node->link.prev = NULL;
+    heap->root = heap->root ? pairing_heap_link( heap->root, node, compare ) : node;
+    heap->root->link.next = heap->root->link.prev = NULL;
+    heap->count++;
+}
+
+// Removes the smallest node from the heap and returns it, or returns NULL if the heap is empty.
+//
+static inline pairing_node_t * pairing_heap_pop( pairing_heap_t * heap, int (*compare)(const void * item_one, const void * item_two) )
+{
+    pairing_node_t * root = heap->root;
+
+    if( root == NULL ) return NULL;
+
+    heap->root = pairing_heap_merge_pairs( root->child, compare );
+    heap->count--;
+    root->child = NULL;
+
+    return root;
+}
+
+// Moves every node of "other" into "heap", leaving "other" empty.
+//
+static inline void pairing_heap_meld( pairing_heap_t * heap, pairing_heap_t * other, int (*compare)(const void * item_one, const void * item_two) )
+{
+    if( other->root )
+    {
+        heap->root = heap->root ? pairing_heap_link( heap->root, other->root, compare ) : other->root;
+        heap->root->link.next = heap->root->link.prev = NULL;
+        heap->count += other->count;
+    }
+    pairing_heap_init( other );
+}
+
+// Detaches the subtree rooted at "node" (which must not be the root) from its parent and siblings.
+//
+static inline void pairing_heap_cut( pairing_node_t * node )
+{
+    pairing_node_t * prev = (pairing_node_t *)node->link.prev;
+
+    if( prev->child == node ) prev->child = (pairing_node_t *)node->link.next;     // "prev" is the parent
+    else prev->link.next = node->link.next;
+    if( node->link.next ) node->link.next->prev = &prev->link;
+
+    node->link.next = node->link.prev = NULL;
+}
+
+// Restores the heap after "node" has been changed so that it compares _less_ than before (e.g. a timer's deadline was
+// moved earlier). To move a node later, use "pairing_heap_remove" and "pairing_heap_push" instead.
+//
+static inline void pairing_heap_decrease( pairing_heap_t * heap, pairing_node_t * node, int (*compare)(const void * item_one, const void * item_two) )
+{
+    if( node == heap->root ) return;
+
+    pairing_heap_cut( node );
+    heap->root = pairing_heap_link( heap->root, node, compare );
+    heap->root->link.next = heap->root->link.prev = NULL;
+}
+
+// Removes "node", which can be anywhere in the heap.
+//
+static inline void pairing_heap_remove( pairing_heap_t * heap, pairing_node_t * node, int (*compare)(const void * item_one, const void * item_two) )
+{
+    if( node == heap->root )
+    {
+        pairing_heap_pop( heap, compare );
+        return;
+    }
+
+    pairing_heap_cut( node );
+    heap->count--;
+
+    pairing_node_t * children = pairing_heap_merge_pairs( node->child, compare );
+    node->child = NULL;
+    if( children )
+    {
+        heap->root = pairing_heap_link( heap->root, children, compare );
+        heap->root->link.next = heap->root->link.prev = NULL;
+    }
+}
+
+#endif // PAIRING_HEAP_H
@@ -0,0 +1,49 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stdlib.h>     // For size_t
+#include <stdbool.h>    // For bool
+#include <unistd.h>     // For sysconf
+#include <pthread.h>    // For pthread_create, pthread_join
+
+// Minimal fork/join helpers shared by the multi-threaded functions in "parallel_sort.h" and "list_segments.h".
+
+// Returns "num_threads", or the number of online CPUs if "num_threads" is 0.
+//
+static inline size_t parallel_threads( size_t num_threads )
+{
+    if( num_threads == 0 )
+    {
+        long cpus = sysconf( _SC_NPROCESSORS_ONLN );
+        num_threads = cpus > 0 ? cpus : 1;
+    }
+
+    return num_threads;
+}
+
+// Runs "task( tasks + idx * task_size )" for every "idx" below "num_tasks", one per thread, and waits for all of them
+// to finish. Task 0 (and any task whose thread can't be started) runs on the calling thread, so this never fails.
+//
+static inline void parallel_run( void * (*task)(void * arg), void * tasks, size_t task_size, size_t num_tasks )
+{
+    pthread_t threads[num_tasks];
+    bool started[num_tasks];
+
+    for( size_t idx = 1; idx < num_tasks; idx++ )
+    {
+        started[idx] = pthread_create( &threads[idx], NULL, task, tasks + idx * task_size ) == 0;
+    }
+
+    task( tasks );
+    for( size_t idx = 1; idx < num_tasks; idx++ )
+    {
+        if( !started[idx] ) task( tasks + idx * task_size );
+    }
+
+    for( size_t idx = 1; idx < num_tasks; idx++ )
+    {
+        if( started[idx] ) pthread_join( threads[idx], NULL );
+    }
+}
+
+#endif // PARALLEL_H
@@ -0,0 +1,335 @@
+#ifndef PARALLEL_SORT_H
+#define PARALLEL_SORT_H
+
+#include <stdlib.h>     // For malloc, free
+#include <string.h>     // For memcpy
+#include <stdbool.h>    // For bool
+#include "array_methods.h"
+#include "parallel.h"
+#include "linked_list_methods_EmbArt.h"
+
+// Multi-threaded versions of "array_stable_sort" and "linked_list_merge_sort", for inputs large enough that one core
+// is the bottleneck. Both split the input into one chunk per thread and sort the chunks concurrently; they differ in
+// how the sorted chunks are combined:
+//
+//     - "array_sort_par" picks splitters from a regular sample of every sorted chunk ("parallel sorting by regular
+//       sampling"), binary searches each chunk for them, and then has each thread merge its share of every chunk (a
+//       multiway merge) straight into its own part of the output. Every thread does roughly n/T work in both phases.
+//     - "linked_list_sort_par" can't binary search a list, so it merges the sorted sublists in pairs, in parallel,
+//       until one is left (a merge tree). The last merge is done by a single thread.
+//
+// Both sorts are stable. "num_threads" is the number of threads to use, including the calling thread; pass 0 to use
+// one per online CPU. Fewer threads are used for small inputs, where starting them would cost more than they save. If
+// a thread can't be started, its share of the work is done by the calling thread. Ex:
+//
+//     array_sort_par( records, num_records, sizeof(record_t), compare_records, 0 );
+
+// Inputs are only split into chunks of at least this many elements.
+//
+#define SORT_PAR_MIN_CHUNK  16384
+
+// Upper limit on the number of threads. The splitter tables grow with the square of the number of threads, and this
+// keeps them small enough for the stack.
+//
+#define SORT_PAR_MAX_THREADS    128
+
+// Returns the number of threads to use for "num" elements. Helper function used by "array_sort_par" and
+// "linked_list_sort_par".
+//
+static inline size_t sort_par_threads( size_t num, size_t num_threads )
+{
+    num_threads = parallel_threads( num_threads );
+    if( num_threads > num / SORT_PAR_MIN_CHUNK ) num_threads = num / SORT_PAR_MIN_CHUNK;
+    if( num_threads > SORT_PAR_MAX_THREADS ) num_threads = SORT_PAR_MAX_THREADS;
+
+    return num_threads > 0 ? num_threads : 1;
+}
+
+// State shared by the threads of "array_sort_par". Chunk "c" is "[start[c], start[c + 1])". Once the splitters are
+// found, "bounds[c * (num_chunks + 1) + k]" is where the part of chunk "c" that belongs to output segment "k" begins,
+// and output segment "k" is "[offset[k], offset[k + 1])".
+//
+typedef struct sort_par_t
+{
+    void *      base;
+    void *      temp;
+    size_t      size;
+    size_t      num_chunks;
+    size_t *    start;
+    size_t *    bounds;
+    size_t *    offset;
+    int         (*compare)(const void * item_one, const void * item_two);
+} sort_par_t;
+
+typedef struct sort_par_task_t
+{
+    sort_par_t *    sort;
+    size_t          idx;
+} sort_par_task_t;
+
+// Phase 1 of "array_sort_par": sort one chunk, using the matching part of the merge buffer as scratch.
+//
+static inline void * sort_par_sort_chunk( void * arg )
+{
+    sort_par_task_t * task = arg;
+    sort_par_t * sort = task->sort;
+    size_t first = sort->start[task->idx], num = sort->start[task->idx + 1] - first;
+
+    array_stable_sort_with_scratch( sort->base + first * sort->size, num, sort->size, sort->temp + first * sort->size, sort->compare );
+
+    return NULL;
+}
+
+// Returns true if the next element of chunk "one" should come before the next element of chunk "two" in the output
+// (ties go to the earlier chunk, which keeps the sort stable). Helper function used by "sort_par_merge_segment".
+//
+static inline bool sort_par_before( const sort_par_t * sort, const size_t * cursor, size_t one, size_t two )
+{
+    int order = sort->compare( sort->base + cursor[one] * sort->size, sort->base + cursor[two] * sort->size );
+
+    return order < 0 || ( order == 0 && one < two );
+}
+
+// Phase 2 of "array_sort_par": merge segment "k" of every chunk into the merge buffer. The chunks with elements left
+// are kept in a binary min-heap ordered by their next element.
+//
+static inline void * sort_par_merge_segment( void * arg )
+{
+    sort_par_task_t * task = arg;
+    sort_par_t * sort = task->sort;
+    size_t num_chunks = sort->num_chunks, k = task->idx, size = sort->size;
+    size_t cursor[num_chunks], end[num_chunks], heap[num_chunks];
+    size_t heap_size = 0, out = sort->offset[k];
+
+    for( size_t c = 0; c < num_chunks; c++ )
+    {
+        cursor[c] = sort->start[c] + sort->bounds[c * (num_chunks + 1) + k];
+        end[c] = sort->start[c] + sort->bounds[c * (num_chunks + 1) + k + 1];
+        if( cursor[c] < end[c] ) heap[heap_size++] = c;
+    }
+
+    for( size_t idx = heap_size / 2; idx-- > 0; )
+    {
+        for( size_t pos = idx, child; ( child = 2*pos + 1 ) < heap_size; pos = child )
+        {
+            if( child + 1 < heap_size && sort_par_before( sort, cursor, heap[child + 1], heap[child] ) ) child++;
+            if( !sort_par_before( sort, cursor, heap[child], heap[pos] ) ) break;
+            size_t swap = heap[pos];
+            heap[pos] = heap[child];
+            heap[child] = swap;
+        }
+    }
+
+    while( heap_size > 0 )
+    {
+        size_t c = heap[0];
+
+        memcpy( sort->temp + out * size, sort->base + cursor[c] * size, size );
+        out++;
+        if( ++cursor[c] == end[c] ) heap[0] = heap[--heap_size];
+
+        for( size_t pos = 0, child; ( child = 2*pos + 1 ) < heap_size; pos = child )
+        {
+            if( child + 1 < heap_size && sort_par_before( sort, cursor, heap[child + 1], heap[child] ) ) child++;
+            if( !sort_par_before( sort, cursor, heap[child], heap[pos] ) ) break;
+            size_t swap = heap[pos];
+            heap[pos] = heap[child];
+            heap[child] = swap;
+        }
+    }
+
+    return NULL;
+}
+
+// Phase 3 of "array_sort_par": copy segment "k" back from the merge buffer. This can't be done as part of phase 2,
+// since other threads may still be reading that part of the array.
+//
+static inline void * sort_par_copy_segment( void * arg )
+{
+    sort_par_task_t * task = arg;
+    sort_par_t * sort = task->sort;
+    size_t first = sort->offset[task->idx], num = sort->offset[task->idx + 1] - first;
+
+    memcpy( sort->base + first * sort->size, sort->temp + first * sort->size, num * sort->size );
+
+    return NULL;
+}
+
+// Sorts the array with "num_threads" threads. Uses an extra "num * size" bytes, which it allocates, returning "false",
+// without changing the array, if that fails.
+//
+// **WARNING**: This function copies array elements to different locations in memory. Because of this, it will
+// break any variables that hold pointers to any array elements, since those pointers will point to different
+// pieces of data.
+//
+static inline bool array_sort_par( void * base, size_t num, size_t size, int (*compare)(const void * item_one, const void * item_two), size_t num_threads )
+{
+    size_t num_chunks = sort_par_threads( num, num_threads );
+
+    if( num_chunks == 1 ) return array_stable_sort( base, num, size, compare );
+
+    // Each sample is a copy of an element followed by the chunk and position it came from, padded so that the copies
+    // stay aligned.
+    //
+    size_t sample_size = ( size + 15 ) / 16 * 16 + 2 * sizeof(size_t);
+    size_t start[num_chunks + 1], bounds[num_chunks * (num_chunks + 1)], offset[num_chunks + 1];
+    sort_par_task_t tasks[num_chunks];
+    void * temp = malloc( num * size );
+    void * samples = malloc( num_chunks * num_chunks * sample_size );
+
+    if( temp == NULL || samples == NULL )
+    {
+        free( temp );
+        free( samples );
+        return false;
+    }
+
+    sort_par_t sort = { base, temp, size, num_chunks, start, bounds, offset, compare };
+
+    for( size_t c = 0; c <= num_chunks; c++ ) start[c] = num * c / num_chunks;
+    for( size_t c = 0; c < num_chunks; c++ )
+    {
+        tasks[c].sort = &sort;
+        tasks[c].idx = c;
+    }
+
+    // (1) Sort every chunk.
+    //
+    parallel_run( sort_par_sort_chunk, tasks, sizeof(tasks[0]), num_chunks );
+
+    // (2) Take one evenly spaced sample per thread from every sorted chunk, and sort them. The samples are gathered in
+    // chunk order and the sort is stable, so equal samples end up ordered by chunk and then by position, which is the
+    // order the merge puts equal elements in.
+    //
+    for( size_t c = 0; c < num_chunks; c++ )
+    {
+        for( size_t idx = 0; idx < num_chunks; idx++ )
+        {
+            void * sample = samples + ( c * num_chunks + idx ) * sample_size;
+            size_t position[2] = { c, ( start[c + 1] - start[c] ) * idx / num_chunks };
+            memcpy( sample, base + ( start[c] + position[1] ) * size, size );
+            memcpy( sample + sample_size - sizeof(position), position, sizeof(position) );
+        }
+    }
+    array_stable_sort_with_scratch( samples, num_chunks * num_chunks, sample_size, temp, compare );
+
+    // (3) Of the sorted samples, every one whose index is a multiple of the number of chunks is a splitter. Find where
+    // each splitter falls in each chunk: in chunks before the one the splitter came from, after any elements equal to
+    // it; in chunks after it, before them.
+    //
+    for( size_t c = 0; c < num_chunks; c++ )
+    {
+        bounds[c * (num_chunks + 1)] = 0;
+        bounds[c * (num_chunks + 1) + num_chunks] = start[c + 1] - start[c];
+    }
+    for( size_t k = 1; k < num_chunks; k++ )
+    {
+        void * splitter = samples + k * num_chunks * sample_size;
+        size_t position[2];
+        memcpy( position, splitter + sample_size - sizeof(position), sizeof(position) );
+
+        for( size_t c = 0; c < num_chunks; c++ )
+        {
+            void * chunk = base + start[c] * size;
+            size_t len = start[c + 1] - start[c];
+
+            if( c < position[0] ) bounds[c * (num_chunks + 1) + k] = array_upper_bound( splitter, chunk, len, size, compare );
+            else if( c > position[0] ) bounds[c * (num_chunks + 1) + k] = array_lower_bound( splitter, chunk, len, size, compare );
+            else bounds[c * (num_chunks + 1) + k] = position[1];
+        }
+    }
+
+    // (4) Merge each segment into the merge buffer, then copy them all back.
+    //
+    offset[0] = 0;
+    for( size_t k = 1; k <= num_chunks; k++ )
+    {
+        offset[k] = offset[k - 1];
+        for( size_t c = 0; c < num_chunks; c++ )
+        {
+            offset[k] += bounds[c * (num_chunks + 1) + k] - bounds[c * (num_chunks + 1) + k - 1];
+        }
+    }
+
+    parallel_run( sort_par_merge_segment, tasks, sizeof(tasks[0]), num_chunks );
+    parallel_run( sort_par_copy_segment, tasks, sizeof(tasks[0]), num_chunks );
+
+    free( samples );
+    free( temp );
+
+    return true;
+}
+
+typedef struct sort_par_list_task_t
+{
+    ll_t *      head;
+    ll_t *      other;
+    int         (*compare)(const void * item_one, const void * item_two);
+} sort_par_list_task_t;
+
+static inline void * sort_par_list_sort( void * arg )
+{
+    sort_par_list_task_t * task = arg;
+    linked_list_merge_sort( task->head, task->compare );
+    return NULL;
+}
+
+static inline void * sort_par_list_merge( void * arg )
+{
+    sort_par_list_task_t * task = arg;
+    linked_list_merge_sorted( task->head, task->other, task->compare );
+    return NULL;
+}
+
+// Sorts the list with "num_threads" threads, relinking the nodes into "head". "compare" is passed pointers to the
+// nodes, as with "linked_list_merge_sort". Doesn't allocate any memory.
+//
+static inline void linked_list_sort_par( ll_t * head, int (*compare)(const void * item_one, const void * item_two), size_t num_threads )
+{
+    size_t num = 0;
+    ll_t * node;
+
+    list_for_each( node, head ) num++;
+
+    size_t num_chunks = sort_par_threads( num, num_threads );
+    ll_t sublists[num_chunks];
+    sort_par_list_task_t tasks[num_chunks];
+
+    // (1) Cut the list into num_chunks sublists of (nearly) equal length, and sort them.
+    //
+    for( size_t c = 0; c < num_chunks; c++ )
+    {
+        size_t len = num * (c + 1) / num_chunks - num * c / num_chunks;
+
+        node = head;
+        for( size_t idx = 0; idx < len; idx++ ) node = node->next;
+        list_cut_position( &sublists[c], head, node );
+
+        tasks[c].head = &sublists[c];
+        tasks[c].compare = compare;
+    }
+
+    parallel_run( sort_par_list_sort, tasks, sizeof(tasks[0]), num_chunks );
+
+    // (2) Merge neighboring sublists in pairs until only one is left. Merging "c + step" into "c" keeps equal nodes in
+    // their original order.
+    //
+    for( size_t step = 1; step < num_chunks; step *= 2 )
+    {
+        size_t num_tasks = 0;
+
+        for( size_t c = 0; c + step < num_chunks; c += 2 * step )
+        {
+            tasks[num_tasks].head = &sublists[c];
+            tasks[num_tasks].other = &sublists[c + step];
+            tasks[num_tasks].compare = compare;
+            num_tasks++;
+        }
+
+        parallel_run( sort_par_list_merge, tasks, sizeof(tasks[0]), num_tasks );
+    }
+
+    list_splice( &sublists[0], head );
+}
+
+#endif // PARALLEL_SORT_H
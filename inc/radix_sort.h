@@ -0,0 +1,209 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include <stdint.h>     // For uint64_t, uintptr_t
+#include <stdlib.h>     // For malloc, free
+#include <string.h>     // For memcpy
+#include <stdbool.h>    // For bool
+#include "ll.h"
+
+// Sorting by an integer key instead of by a comparison function. "linked_list_qsort" and "qsort" call "compare" about
+// n log n times, and for a large list each of those calls has to follow two node pointers to wherever the nodes happen
+// to be in memory, so nearly every comparison is a cache miss. The functions here instead call "key_of" exactly once
+// per element, store the keys next to a reference to their element in a contiguous buffer of "radix_entry_t", and sort
+// that buffer with an LSD radix sort: one sequential pass to build histograms of each byte of the keys, then one
+// scatter pass per byte. Only then are the elements touched again, to relink the list or permute the array.
+//
+// "key_of" must return an unsigned 64-bit key whose natural order is the order wanted for the elements. The helpers
+// "radix_key_from_int64" and "radix_key_from_double" map signed and floating point values to such keys. Passes for
+// bytes that are the same in every key are skipped, so keys that only use the low 32 bits take 4 passes, not 8. Ex:
+//
+//     uint64_t key_of_node( const void * elem )
+//     {
+//         return ((myStruct_t *)elem)->data;
+//     }
+//
+//     linked_list_radix_sort( &myList, key_of_node );
+//
+// Both sorts are stable. Each needs an extra 32 bytes per element (two buffers of "radix_entry_t"), which they
+// allocate, returning "false", without changing the input, if that fails.
+
+typedef struct radix_entry_t
+{
+    uint64_t    key;
+    uintptr_t   value;      // A node pointer (lists) or an index (arrays)
+} radix_entry_t;
+
+// Maps a signed integer to a key that sorts in the same order.
+//
+static inline uint64_t radix_key_from_int64( int64_t value )
+{
+    return (uint64_t)value ^ ( (uint64_t)1 << 63 );
+}
+
+// Maps a double to a key that sorts in the same order (with -0.0 before +0.0). Not meaningful for NaN.
+//
+static inline uint64_t radix_key_from_double( double value )
+{
+    uint64_t bits;
+    memcpy( &bits, &value, sizeof(bits) );
+
+    return ( bits >> 63 ) ? ~bits : bits | ( (uint64_t)1 << 63 );
+}
+
+// Sorts "num" entries by key with an LSD radix sort, one byte at a time, using "temp" (which must also hold "num"
+// entries) as the other half of each scatter pass. Returns whichever of the two buffers holds the sorted entries.
+//
+static inline radix_entry_t * radix_sort_entries( radix_entry_t * entries, radix_entry_t * temp, size_t num )
+{
+    size_t counts[8][256] = {{0}};
+
+    if( num == 0 ) return entries;
+
+    // (1) Build the histograms for every byte in a single pass.
+    //
+    for( size_t idx = 0; idx < num; idx++ )
+    {
+        uint64_t key = entries[idx].key;
+        for( int byte = 0; byte < 8; byte++ ) counts[byte][( key >> ( 8 * byte ) ) & 0xFF]++;
+    }
+
+    // (2) Scatter by each byte, from least to most significant, skipping bytes that are the same in every key.
+    //
+    for( int byte = 0; byte < 8; byte++ )
+    {
+        size_t * count = counts[byte];
+        int shift = 8 * byte;
+
+        if( count[( entries[0].key >> shift ) & 0xFF] == num ) continue;
+
+        size_t offset = 0;
+        for( int digit = 0; digit < 256; digit++ )
+        {
+            size_t this_count = count[digit];
+            count[digit] = offset;
+            offset += this_count;
+        }
+
+        for( size_t idx = 0; idx < num; idx++ ) temp[count[( entries[idx].key >> shift ) & 0xFF]++] = entries[idx];
+
+        radix_entry_t * swap = entries;
+        entries = temp;
+        temp = swap;
+    }
+
+    return entries;
+}
+
+// Sorts the array by the key that "key_of" returns for each element. Once the keys are sorted, the elements are moved
+// into place by following the cycles of the permutation, so each element is copied once and the only extra space
+// needed for elements is one temporary.
+//
+// **WARNING**: This function copies array elements to different locations in memory. Because of this, it will
+// break any variables that hold pointers to any array elements, since those pointers will point to different
+// pieces of data.
+//
+static inline bool array_radix_sort( void * base, size_t num, size_t size, uint64_t (*key_of)(const void * elem) )
+{
+    radix_entry_t * entries = malloc( 2 * num * sizeof(radix_entry_t) + 1 );
+    char temp[size];
+
+    if( entries == NULL ) return false;
+
+    for( size_t idx = 0; idx < num; idx++ )
+    {
+        entries[idx].key = key_of( base + idx * size );
+        entries[idx].value = idx;
+    }
+
+    radix_entry_t * sorted = radix_sort_entries( entries, entries + num, num );
+
+    // "sorted[pos].value" is the index of the element that belongs at "pos". Each element is moved once; "value" is set
+    // to "pos" once position "pos" has been filled.
+    //
+    for( size_t start = 0; start < num; start++ )
+    {
+        if( sorted[start].value == start ) continue;
+
+        memcpy( temp, base + start * size, size );
+
+        size_t pos = start;
+        while( sorted[pos].value != start )
+        {
+            size_t from = sorted[pos].value;
+            memcpy( base + pos * size, base + from * size, size );
+            sorted[pos].value = pos;
+            pos = from;
+        }
+        memcpy( base + pos * size, temp, size );
+        sorted[pos].value = pos;
+    }
+
+    free( entries );
+
+    return true;
+}
+
+// Sorts the list by the key that "key_of" returns for each node. The nodes themselves are not moved, only relinked in
+// sorted order.
+//
+static inline bool linked_list_radix_sort( ll_t * head, uint64_t (*key_of)(const void * elem) )
+{
+    size_t num = 0, capacity = 1024;
+    radix_entry_t * entries = malloc( capacity * sizeof(radix_entry_t) );
+    ll_t * node;
+
+    if( entries == NULL ) return false;
+
+    // Walking a large list is a cache miss per node, so the keys are collected in the same pass that counts the nodes,
+    // growing the buffer as needed, instead of walking the list once to count and again to collect.
+    //
+    list_for_each( node, head )
+    {
+        if( num == capacity )
+        {
+            radix_entry_t * bigger = realloc( entries, 2 * capacity * sizeof(radix_entry_t) );
+            if( bigger == NULL )
+            {
+                free( entries );
+                return false;
+            }
+            entries = bigger;
+            capacity *= 2;
+        }
+        entries[num].key = key_of( node );
+        entries[num].value = (uintptr_t)node;
+        num++;
+    }
+
+    radix_entry_t * temp = malloc( num * sizeof(radix_entry_t) + 1 );
+    if( temp == NULL )
+    {
+        free( entries );
+        return false;
+    }
+
+    radix_entry_t * sorted = radix_sort_entries( entries, temp, num );
+
+    // Relink every node in order. Unlike a list walk, the addresses of the next nodes are already known, so they can be
+    // prefetched well before they're written to.
+    //
+    ll_t * prev = head;
+    for( size_t idx = 0; idx < num; idx++ )
+    {
+        if( idx + 8 < num ) __builtin_prefetch( (void *)sorted[idx + 8].value, 1 );
+        node = (ll_t *)sorted[idx].value;
+        prev->next = node;
+        node->prev = prev;
+        prev = node;
+    }
+    prev->next = head;
+    head->prev = prev;
+
+    free( entries );
+    free( temp );
+
+    return true;
+}
+
+#endif // RADIX_SORT_H
@@ -0,0 +1,249 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <stddef.h>     // For size_t
+#include <string.h>     // For memcpy
+#include <stdbool.h>    // For bool
+#include <stdatomic.h>  // For atomic_size_t
+
+// A ring buffer (or "circular buffer") is a FIFO queue stored in a single, contiguous array. Unlike a queue built from
+// a linked list, there is no per-item node to allocate or link in, and consecutive items sit next to each other in
+// memory. The array is described the same way as the arrays in "array_methods.h": a pointer to its base, the number of
+// elements it can hold ("capacity"), and the size of each element in bytes.
+//
+// The capacity must be a power of two. This lets "head" (the position of the next item to pop) and "tail" (the
+// position of the next item to push) be kept as free-running counters that are only ever incremented, with the array
+// index found by masking off the high bits instead of with a division or a wrap-around check. The number of items in
+// the buffer is always "tail - head", even after the counters overflow. Ex:
+//
+//     uint32_t storage[64];
+//     ring_buffer_t rb;
+//
+//     ring_buffer_init( &rb, storage, LEN_ARRAY(storage), sizeof(storage[0]) );
+//
+//     uint32_t in[] = {1,2,3}, out[3];
+//     ring_buffer_push_n( &rb, in, LEN_ARRAY(in) );
+//     ring_buffer_pop_n( &rb, out, LEN_ARRAY(out) );   // out is now [1,2,3]
+//
+// Bulk pushes and pops copy a whole batch with at most two "memcpy" calls: one up to the end of the array and, if the
+// batch wraps around, one more from the start of the array.
+//
+// The "ring_buffer_spsc_*" functions are safe to call without a lock as long as exactly one thread pushes (the
+// "producer") and exactly one thread pops (the "consumer"). The producer only ever writes "tail" and the consumer
+// only ever writes "head"; each is published to the other thread with release/acquire ordering so that the copied
+// data is visible before the counter that covers it. The two counters are kept on separate cache lines, along with
+// each thread's last-seen copy of the other thread's counter, so that the producer and consumer don't invalidate each
+// other's cache line on every operation. The plain "ring_buffer_*" functions skip the memory barriers and are meant for
+// use from a single thread (or under a caller-held lock). Don't mix the two modes on the same buffer while it is being
+// shared between threads.
+
+#ifndef CACHE_LINE_SIZE
+#define CACHE_LINE_SIZE 64
+#endif
+
+typedef struct ring_buffer_t
+{
+    void *      base;
+    size_t      capacity;
+    size_t      size;
+    size_t      mask;
+
+    // Written by the producer only.
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t tail;
+    size_t      cached_head;
+
+    // Written by the consumer only.
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t head;
+    size_t      cached_tail;
+} ring_buffer_t;
+
+// Initializes "rb" to use the array at "base", which holds up to "capacity" elements of "size" bytes each. Returns
+// "false" (and leaves "rb" untouched) if "capacity" is not a power of two.
+//
+static inline bool ring_buffer_init( ring_buffer_t * rb, void * base, size_t capacity, size_t size )
+{
+    if( capacity == 0 || ( capacity & (capacity - 1) ) != 0 ) return false;
+
+    rb->base = base;
+    rb->capacity = capacity;
+    rb->size = size;
+    rb->mask = capacity - 1;
+    atomic_init( &rb->tail, 0 );
+    atomic_init( &rb->head, 0 );
+    rb->cached_head = 0;
+    rb->cached_tail = 0;
+
+    return true;
+}
+
+// Returns the number of items currently in the buffer.
+//
+static inline size_t ring_buffer_count( const ring_buffer_t * rb )
+{
+    return atomic_load_explicit( &((ring_buffer_t *)rb)->tail, memory_order_relaxed ) - atomic_load_explicit( &((ring_buffer_t *)rb)->head, memory_order_relaxed );
+}
+
+static inline bool ring_buffer_is_empty( const ring_buffer_t * rb )
+{
+    return ring_buffer_count( rb ) == 0;
+}
+
+static inline bool ring_buffer_is_full( const ring_buffer_t * rb )
+{
+    return ring_buffer_count( rb ) == rb->capacity;
+}
+
+// Copies "num" elements from "elems" into the buffer starting at counter value "pos", wrapping around to the start
+// of the array if needed. Helper function used by the push functions.
+//
+static inline void ring_buffer_copy_in( ring_buffer_t * rb, size_t pos, const void * elems, size_t num )
+{
+    size_t offset = pos & rb->mask;
+    size_t first = rb->capacity - offset;
+
+    if( first > num ) first = num;
+    memcpy( rb->base + offset * rb->size, elems, first * rb->size );
+    if( num > first ) memcpy( rb->base, elems + first * rb->size, (num - first) * rb->size );
+}
+
+// Copies "num" elements out of the buffer starting at counter value "pos" into "elems", wrapping around to the
+// start of the array if needed. Helper function used by the pop and peek functions.
+//
+static inline void ring_buffer_copy_out( const ring_buffer_t * rb, size_t pos, void * elems, size_t num )
+{
+    size_t offset = pos & rb->mask;
+    size_t first = rb->capacity - offset;
+
+    if( first > num ) first = num;
+    memcpy( elems, rb->base + offset * rb->size, first * rb->size );
+    if( num > first ) memcpy( elems + first * rb->size, rb->base, (num - first) * rb->size );
+}
+
+// Pushes up to "num" elements from the array "elems" onto the back of the buffer. Returns the number of elements
+// actually pushed, which is less than "num" only if the buffer filled up.
+//
+static inline size_t ring_buffer_push_n( ring_buffer_t * rb, const void * elems, size_t num )
+{
+    size_t tail = atomic_load_explicit( &rb->tail, memory_order_relaxed );
+    size_t space = rb->capacity - ( tail - atomic_load_explicit( &rb->head, memory_order_relaxed ) );
+
+    if( num > space ) num = space;
+    ring_buffer_copy_in( rb, tail, elems, num );
+    atomic_store_explicit( &rb->tail, tail + num, memory_order_relaxed );
+
+    return num;
+}
+
+// Pops up to "num" elements from the front of the buffer into the array "elems". Returns the number of elements
+// actually popped, which is less than "num" only if the buffer ran out of items.
+//
+static inline size_t ring_buffer_pop_n( ring_buffer_t * rb, void * elems, size_t num )
+{
+    size_t head = atomic_load_explicit( &rb->head, memory_order_relaxed );
+    size_t available = atomic_load_explicit( &rb->tail, memory_order_relaxed ) - head;
+
+    if( num > available ) num = available;
+    ring_buffer_copy_out( rb, head, elems, num );
+    atomic_store_explicit( &rb->head, head + num, memory_order_relaxed );
+
+    return num;
+}
+
+// Copies up to "num" elements from the front of the buffer into "elems" without removing them. Returns the number
+// of elements copied.
+//
+static inline size_t ring_buffer_peek_n( const ring_buffer_t * rb, void * elems, size_t num )
+{
+    size_t head = atomic_load_explicit( &((ring_buffer_t *)rb)->head, memory_order_relaxed );
+    size_t available = atomic_load_explicit( &((ring_buffer_t *)rb)->tail, memory_order_relaxed ) - head;
+
+    if( num > available ) num = available;
+    ring_buffer_copy_out( rb, head, elems, num );
+
+    return num;
+}
+
+// Pushes a single element onto the back of the buffer. Returns "false" if the buffer is full.
+//
+static inline bool ring_buffer_push( ring_buffer_t * rb, const void * elem )
+{
+    size_t tail = atomic_load_explicit( &rb->tail, memory_order_relaxed );
+
+    // A single element can never wrap around, so it only ever needs the one copy.
+    //
+    if( tail - atomic_load_explicit( &rb->head, memory_order_relaxed ) == rb->capacity ) return false;
+    memcpy( rb->base + (tail & rb->mask) * rb->size, elem, rb->size );
+    atomic_store_explicit( &rb->tail, tail + 1, memory_order_relaxed );
+
+    return true;
+}
+
+// Pops a single element from the front of the buffer into "elem". Returns "false" if the buffer is empty.
+//
+static inline bool ring_buffer_pop( ring_buffer_t * rb, void * elem )
+{
+    size_t head = atomic_load_explicit( &rb->head, memory_order_relaxed );
+
+    if( atomic_load_explicit( &rb->tail, memory_order_relaxed ) == head ) return false;
+    memcpy( elem, rb->base + (head & rb->mask) * rb->size, rb->size );
+    atomic_store_explicit( &rb->head, head + 1, memory_order_relaxed );
+
+    return true;
+}
+
+// Producer side of the single-producer/single-consumer mode. Same as "ring_buffer_push_n", except that it may be
+// called from one thread while another thread calls "ring_buffer_spsc_pop_n" on the same buffer.
+//
+static inline size_t ring_buffer_spsc_push_n( ring_buffer_t * rb, const void * elems, size_t num )
+{
+    size_t tail = atomic_load_explicit( &rb->tail, memory_order_relaxed );
+
+    // Only re-read the consumer's counter (and pull in its cache line) if the last value we saw doesn't leave
+    // enough room.
+    //
+    if( rb->capacity - ( tail - rb->cached_head ) < num )
+    {
+        rb->cached_head = atomic_load_explicit( &rb->head, memory_order_acquire );
+    }
+
+    size_t space = rb->capacity - ( tail - rb->cached_head );
+
+    if( num > space ) num = space;
+    ring_buffer_copy_in( rb, tail, elems, num );
+    atomic_store_explicit( &rb->tail, tail + num, memory_order_release );
+
+    return num;
+}
+
+// Consumer side of the single-producer/single-consumer mode. Same as "ring_buffer_pop_n", except that it may be
+// called from one thread while another thread calls "ring_buffer_spsc_push_n" on the same buffer.
+//
+static inline size_t ring_buffer_spsc_pop_n( ring_buffer_t * rb, void * elems, size_t num )
+{
+    size_t head = atomic_load_explicit( &rb->head, memory_order_relaxed );
+
+    if( rb->cached_tail - head < num )
+    {
+        rb->cached_tail = atomic_load_explicit( &rb->tail, memory_order_acquire );
+    }
+
+    size_t available = rb->cached_tail - head;
+
+    if( num > available ) num = available;
+    ring_buffer_copy_out( rb, head, elems, num );
+    atomic_store_explicit( &rb->head, head + num, memory_order_release );
+
+    return num;
+}
+
+static inline bool ring_buffer_spsc_push( ring_buffer_t * rb, const void * elem )
+{
+    return ring_buffer_spsc_push_n( rb, elem, 1 ) == 1;
+}
+
+static inline bool ring_buffer_spsc_pop( ring_buffer_t * rb, void * elem )
+{
+    return ring_buffer_spsc_pop_n( rb, elem, 1 ) == 1;
+}
+
+#endif // RING_BUFFER_H
@@ -0,0 +1,404 @@
+#ifndef STREAM_METHODS_H
+#define STREAM_METHODS_H
+
+#include <stdint.h>     // For uint8_t
+#include <stdlib.h>     // For malloc, free
+#include <string.h>     // For memcpy
+#include <stdbool.h>    // For bool
+#include <errno.h>      // For errno
+#include <unistd.h>     // For read, write, ssize_t
+#include <pthread.h>    // For pthread_create, pthread_mutex_t, pthread_cond_t
+#include "array_methods.h"
+
+// Versions of "array_count", "array_find", and "array_filter_pure" for arrays that are too big to hold in memory,
+// such as a multi-GB file of fixed-size records. Instead of "base" and "num", these functions take a "stream_reader_t",
+// which describes where to read the records from, and they read and process the records one chunk at a time. The same
+// "count_this", "compare", and "keep_this" callbacks used with arrays can be used here.
+//
+// Memory use is fixed no matter how big the input is: two chunk-sized input buffers (plus one output buffer for
+// "stream_filter"). Nothing requires the chunk size to be a multiple of the record size, or the reader to return
+// whole records; a record that is split across two reads is stitched back together before it's passed to a callback.
+//
+// If "overlap" is set, the next chunk is read on a background thread while the current chunk is being processed
+// (i.e. "double buffering"), so that for a compute-heavy callback the total time is closer to the larger of the I/O
+// time and the compute time than to their sum. Ex:
+//
+//     int fd = open( "records.bin", O_RDONLY );
+//     stream_reader_t reader = { stream_read_fd, &fd, 1 << 20, true };
+//
+//     long long num_odd = stream_count( &reader, sizeof(record_t), is_odd_record );
+//
+// The reader and writer callbacks follow the conventions of POSIX "read" and "write": they return the number of
+// bytes transferred (a reader returns 0 at the end of the input), or -1 with "errno" set on an error.
+
+typedef ssize_t (*stream_read_t)( void * context, void * buffer, size_t count );
+typedef ssize_t (*stream_write_t)( void * context, const void * buffer, size_t count );
+
+typedef struct stream_reader_t
+{
+    stream_read_t   read;
+    void *          context;
+    size_t          chunk_size;     // Number of bytes to read at a time (also the size of each buffer)
+    bool            overlap;        // Read the next chunk on a background thread while the current one is processed
+} stream_reader_t;
+
+// Reader and writer for a file descriptor. "context" must point to an "int" holding the file descriptor.
+//
+static inline ssize_t stream_read_fd( void * context, void * buffer, size_t count )
+{
+    ssize_t ret;
+
+    do ret = read( *(int *)context, buffer, count );
+    while( ret < 0 && errno == EINTR );
+
+    return ret;
+}
+
+static inline ssize_t stream_write_fd( void * context, const void * buffer, size_t count )
+{
+    ssize_t ret;
+
+    do ret = write( *(int *)context, buffer, count );
+    while( ret < 0 && errno == EINTR );
+
+    return ret;
+}
+
+// State shared between the thread processing records and (if "overlap" is set) the thread reading them. Each buffer
+// has "size" bytes of space at the front, ahead of where the chunk is read into, so the end of a record that was split
+// between two chunks can be stitched to its beginning without moving the new chunk.
+//
+typedef struct stream_state_t
+{
+    const stream_reader_t * reader;
+    size_t                  size;
+    uint8_t *               buffers[2];
+    ssize_t                 lengths[2];     // Bytes read into each buffer; 0 at the end of the input; -1 on an error
+    int                     errors[2];
+    bool                    filled[2];
+    bool                    stop;
+    pthread_mutex_t         lock;
+    pthread_cond_t          changed;
+} stream_state_t;
+
+// Reads until the buffer is full or the input ends. Helper function used by "stream_read_thread" and
+// "stream_for_each_block".
+//
+static inline void stream_fill( stream_state_t * state, int idx )
+{
+    uint8_t * buffer = state->buffers[idx] + state->size;
+    size_t length = 0;
+
+    while( length < state->reader->chunk_size )
+    {
+        ssize_t count = state->reader->read( state->reader->context, buffer + length, state->reader->chunk_size - length );
+        if( count < 0 )
+        {
+            state->lengths[idx] = -1;
+            state->errors[idx] = errno;
+            return;
+        }
+        if( count == 0 ) break;
+        length += count;
+    }
+
+    state->lengths[idx] = length;
+}
+
+// Background thread used when "overlap" is set: keeps both buffers full until the input ends, an error occurs, or the
+// processing thread asks it to stop.
+//
+static inline void * stream_read_thread( void * arg )
+{
+    stream_state_t * state = arg;
+
+    for( int idx = 0; ; idx ^= 1 )
+    {
+        pthread_mutex_lock( &state->lock );
+        while( state->filled[idx] && !state->stop ) pthread_cond_wait( &state->changed, &state->lock );
+        bool stop = state->stop;
+        pthread_mutex_unlock( &state->lock );
+        if( stop ) break;
+
+        stream_fill( state, idx );
+
+        pthread_mutex_lock( &state->lock );
+        state->filled[idx] = true;
+        pthread_cond_broadcast( &state->changed );
+        pthread_mutex_unlock( &state->lock );
+
+        if( state->lengths[idx] <= 0 ) break;
+    }
+
+    return NULL;
+}
+
+// Reads the whole input and calls "process" with each block of whole records, in order. "process" returns "false" to
+// stop early. Returns 0 on success (including stopping early) or -1 with "errno" set if a read failed, if the input
+// ended part way through a record (EINVAL), or if memory couldn't be allocated. Helper function used by the other
+// stream functions.
+//
+static inline int stream_for_each_block( const stream_reader_t * reader, size_t size, bool (*process)(void * context, const void * records, size_t num), void * context )
+{
+    stream_state_t state = { .reader = reader, .size = size };
+    pthread_t thread;
+    size_t carry = 0;
+    int error = 0;
+
+    if( size == 0 || reader->chunk_size == 0 )
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    state.buffers[0] = malloc( size + reader->chunk_size );
+    state.buffers[1] = malloc( size + reader->chunk_size );
+    if( !state.buffers[0] || !state.buffers[1] )
+    {
+        free( state.buffers[0] );
+        free( state.buffers[1] );
+        errno = ENOMEM;
+        return -1;
+    }
+
+    bool threaded = reader->overlap;
+    if( threaded )
+    {
+        pthread_mutex_init( &state.lock, NULL );
+        pthread_cond_init( &state.changed, NULL );
+        if( pthread_create( &thread, NULL, stream_read_thread, &state ) != 0 )
+        {
+            pthread_mutex_destroy( &state.lock );
+            pthread_cond_destroy( &state.changed );
+            threaded = false;
+        }
+    }
+
+    for( int idx = 0, first = 1; ; idx ^= 1, first = 0 )
+    {
+        // (1) Wait for the next chunk (or just read it, if there's no background thread).
+        //
+        if( threaded )
+        {
+            pthread_mutex_lock( &state.lock );
+            while( !state.filled[idx] ) pthread_cond_wait( &state.changed, &state.lock );
+            pthread_mutex_unlock( &state.lock );
+        }
+        else
+        {
+            stream_fill( &state, idx );
+        }
+
+        ssize_t length = state.lengths[idx];
+        if( length < 0 )
+        {
+            error = state.errors[idx];
+            break;
+        }
+        if( length == 0 )
+        {
+            if( carry > 0 ) error = EINVAL;
+            break;
+        }
+
+        // (2) Stitch the start of a split record from the end of the previous chunk onto the front of this one.
+        //
+        uint8_t * start = state.buffers[idx] + size - carry;
+        if( carry > 0 ) memcpy( start, state.buffers[idx ^ 1] + size + state.lengths[idx ^ 1] - carry, carry );
+
+        size_t num = ( carry + length ) / size;
+        carry = ( carry + length ) % size;
+
+        // (3) The previous buffer is no longer needed, so hand it back to the reader.
+        //
+        if( threaded && !first )
+        {
+            pthread_mutex_lock( &state.lock );
+            state.filled[idx ^ 1] = false;
+            pthread_cond_broadcast( &state.changed );
+            pthread_mutex_unlock( &state.lock );
+        }
+
+        if( num > 0 && !process( context, start, num ) ) break;
+    }
+
+    if( threaded )
+    {
+        pthread_mutex_lock( &state.lock );
+        state.stop = true;
+        pthread_cond_broadcast( &state.changed );
+        pthread_mutex_unlock( &state.lock );
+        pthread_join( thread, NULL );
+        pthread_mutex_destroy( &state.lock );
+        pthread_cond_destroy( &state.changed );
+    }
+
+    free( state.buffers[0] );
+    free( state.buffers[1] );
+
+    if( error )
+    {
+        errno = error;
+        return -1;
+    }
+
+    return 0;
+}
+
+typedef struct stream_count_state_t
+{
+    size_t          size;
+    bool            (*count_this)(const void * elem);
+    long long       count;
+} stream_count_state_t;
+
+static inline bool stream_count_block( void * context, const void * records, size_t num )
+{
+    stream_count_state_t * state = context;
+    const void * end = records + num * state->size;
+
+    for( const void * this_item = records; this_item < end; this_item += state->size )
+    {
+        if( state->count_this( this_item ) ) state->count++;
+    }
+
+    return true;
+}
+
+// Counts the number of records in the stream for which the function "count_this" returns "true". Returns -1 (with
+// "errno" set) on an error.
+//
+static inline long long stream_count( const stream_reader_t * reader, size_t size, bool (*count_this)(const void * elem) )
+{
+    stream_count_state_t state = { size, count_this, 0 };
+
+    if( stream_for_each_block( reader, size, stream_count_block, &state ) != 0 ) return -1;
+
+    return state.count;
+}
+
+typedef struct stream_find_state_t
+{
+    const void *    key;
+    size_t          size;
+    int             (*compare)(const void * key, const void * elem);
+    void *          found;
+    long long       index;
+    long long       ret;
+} stream_find_state_t;
+
+static inline bool stream_find_block( void * context, const void * records, size_t num )
+{
+    stream_find_state_t * state = context;
+    int idx = array_find( state->key, records, num, state->size, state->compare );
+
+    if( idx < 0 )
+    {
+        state->index += num;
+        return true;
+    }
+
+    state->ret = state->index + idx;
+    if( state->found ) memcpy( state->found, records + idx * state->size, state->size );
+
+    return false;
+}
+
+// Linear search through the stream, stopping at the first match. Returns the index of the matching record (counting
+// from the start of the stream) and copies it to "found" (if not NULL), or returns -1 if no record matches. Returns -2
+// (with "errno" set) on an error.
+//
+static inline long long stream_find( const void * key, const stream_reader_t * reader, size_t size, void * found, int (*compare)(const void * key, const void * elem) )
+{
+    stream_find_state_t state = { key, size, compare, found, 0, -1 };
+
+    if( stream_for_each_block( reader, size, stream_find_block, &state ) != 0 ) return -2;
+
+    return state.ret;
+}
+
+typedef struct stream_filter_state_t
+{
+    size_t          size;
+    bool            (*keep_this)(const void * elem);
+    stream_write_t  write;
+    void *          write_context;
+    uint8_t *       output;
+    size_t          output_capacity;
+    size_t          output_length;
+    long long       count;
+    int             error;
+} stream_filter_state_t;
+
+// Writes out everything in the output buffer. Helper function used by "stream_filter".
+//
+static inline bool stream_filter_flush( stream_filter_state_t * state )
+{
+    size_t written = 0;
+
+    while( written < state->output_length )
+    {
+        ssize_t count = state->write( state->write_context, state->output + written, state->output_length - written );
+        if( count < 0 )
+        {
+            state->error = errno;
+            return false;
+        }
+        written += count;
+    }
+    state->output_length = 0;
+
+    return true;
+}
+
+static inline bool stream_filter_block( void * context, const void * records, size_t num )
+{
+    stream_filter_state_t * state = context;
+    const void * end = records + num * state->size;
+
+    for( const void * this_item = records; this_item < end; this_item += state->size )
+    {
+        if( state->keep_this( this_item ) )
+        {
+            if( state->output_length + state->size > state->output_capacity && !stream_filter_flush( state ) ) return false;
+            memcpy( state->output + state->output_length, this_item, state->size );
+            state->output_length += state->size;
+            state->count++;
+        }
+    }
+
+    return true;
+}
+
+// Writes to "write" only those records in the stream for which the function "keep_this" returns "true", in order.
+// Kept records are gathered into an output buffer (the same size as a chunk, rounded up to hold at least one record)
+// so that "write" is called with large blocks. Returns the number of records kept, or -1 (with "errno" set) on an
+// error reading or writing.
+//
+static inline long long stream_filter( const stream_reader_t * reader, size_t size, bool (*keep_this)(const void * elem), stream_write_t write, void * write_context )
+{
+    size_t capacity = reader->chunk_size < size ? size : reader->chunk_size;
+    stream_filter_state_t state = { size, keep_this, write, write_context, malloc( capacity ), capacity, 0, 0, 0 };
+
+    if( state.output == NULL )
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    int ret = stream_for_each_block( reader, size, stream_filter_block, &state );
+    int error = ret != 0 ? errno : state.error;
+
+    if( error == 0 && !stream_filter_flush( &state ) ) error = state.error;
+    free( state.output );
+
+    if( error )
+    {
+        errno = error;
+        return -1;
+    }
+
+    return state.count;
+}
+
+#endif // STREAM_METHODS_H
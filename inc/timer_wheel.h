@@ -0,0 +1,185 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdint.h>     // For uint64_t
+#include <stdbool.h>    // For bool
+#include "ll.h"
+
+// A hierarchical timer wheel: a set of timers, each due at some tick, that can be armed and cancelled in O(1) time and
+// whose expired timers are handed back a whole bucket at a time. It replaces the usual list of timers kept in order
+// with "linked_list_sorted_insert", where arming a timer walks the list.
+//
+// The wheel has TIMER_WHEEL_LEVELS levels of TIMER_WHEEL_SLOTS buckets each. A timer due within TIMER_WHEEL_SLOTS
+// ticks goes in the level 0 bucket for its exact tick; one due later goes in a bucket of a higher level, which covers
+// TIMER_WHEEL_SLOTS times as many ticks per bucket as the level below. When the wheel reaches the start of a higher
+// level bucket, its timers "cascade": each is moved down into the level that now fits it. So a timer is only ever
+// moved a few times, no matter how far ahead it was armed. Timers due further ahead than the whole wheel covers are
+// kept in its last level and moved again each time it comes round, until they fit.
+//
+// Buckets are "ll_t" lists and each timer embeds an "ll_t" node, so the wheel never allocates: the caller owns the
+// timers, which can be on the wheel, in a list of expired timers, or neither. Ex:
+//
+//     typedef struct connection_t
+//     {
+//         timer_node_t    idle;
+//         int             fd;
+//     } connection_t;
+//
+//     timer_wheel_t timers;
+//     timer_wheel_init( &timers, now );
+//
+//     timer_init( &conn->idle );
+//     timer_wheel_arm( &timers, &conn->idle, now + IDLE_TICKS );
+//     ...
+//     LIST_INIT(expired);
+//     ll_t * node, * copy;
+//     timer_wheel_advance( &timers, now, &expired );
+//     list_for_each_safe( node, copy, &expired )
+//     {
+//         list_del( node );
+//         close_connection( list_entry( node, connection_t, idle ) );
+//     }
+//
+// A "timer_wheel_t" is not thread-safe.
+
+#ifndef TIMER_WHEEL_BITS
+#define TIMER_WHEEL_BITS    6       // log2 of the number of buckets per level
+#endif
+#ifndef TIMER_WHEEL_LEVELS
+#define TIMER_WHEEL_LEVELS  4       // With 64 buckets per level, covers 2^24 ticks
+#endif
+#define TIMER_WHEEL_SLOTS   ( 1u << TIMER_WHEEL_BITS )
+#define TIMER_WHEEL_MASK    ( TIMER_WHEEL_SLOTS - 1 )
+
+typedef struct timer_node_t
+{
+    ll_t        list;       // Both links are NULL while the timer isn't on a wheel or a list
+    uint64_t    expires;    // The tick the timer is due at
+} timer_node_t;
+
+typedef struct timer_wheel_t
+{
+    uint64_t    next;       // The next tick to be processed by "timer_wheel_advance"
+    ll_t        buckets[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+} timer_wheel_t;
+
+// Starts an empty wheel whose first tick to process is "now".
+//
+static inline void timer_wheel_init( timer_wheel_t * wheel, uint64_t now )
+{
+    wheel->next = now;
+    for( int level = 0; level < TIMER_WHEEL_LEVELS; level++ )
+    {
+        for( unsigned slot = 0; slot < TIMER_WHEEL_SLOTS; slot++ )
+        {
+            wheel->buckets[level][slot].next = wheel->buckets[level][slot].prev = &wheel->buckets[level][slot];
+        }
+    }
+}
+
+// Marks a timer as not armed. Must be called once before the timer is first used.
+//
+static inline void timer_init( timer_node_t * timer )
+{
+    timer->list.next = timer->list.prev = NULL;
+}
+
+// Returns true if the timer is on a wheel (or on a list of expired timers that hasn't been taken apart yet).
+//
+static inline bool timer_pending( const timer_node_t * timer )
+{
+    return timer->list.next != NULL;
+}
+
+// Returns the bucket for a timer due at "expires", given that the wheel's next tick to process is "next".
+//
+static inline ll_t * timer_wheel_bucket( timer_wheel_t * wheel, uint64_t expires )
+{
+    uint64_t delta = expires - wheel->next;
+    int level = 0;
+
+    if( (int64_t)delta < 0 ) return &wheel->buckets[0][wheel->next & TIMER_WHEEL_MASK];    // Already due
+
+    while( level < TIMER_WHEEL_LEVELS - 1 && delta >> ( TIMER_WHEEL_BITS * ( level + 1 ) ) ) level++;
+    if( delta >> ( TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS ) )
+    {
+        expires = wheel->next + ( ( 1ULL << ( TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS ) ) - 1 );   // Beyond the last level
+    }
+
+    return &wheel->buckets[level][( expires >> ( TIMER_WHEEL_BITS * level ) ) & TIMER_WHEEL_MASK];
+}
+
+// Arms "timer" to be due at tick "expires", cancelling it first if it was already armed. A timer whose tick has
+// already been processed is due at the next one.
+//
+static inline void timer_wheel_arm( timer_wheel_t * wheel, timer_node_t * timer, uint64_t expires )
+{
+    if( timer_pending( timer ) ) list_del( &timer->list );
+
+    timer->expires = expires;
+    list_add_tail( &timer->list, timer_wheel_bucket( wheel, expires ) );
+}
+
+// Disarms "timer". Returns true if it was armed. Does nothing for a timer that isn't armed.
+//
+// **WARNING**: A timer that has expired is on the caller's list of expired timers until the caller removes it, and
+// cancelling it then removes it from that list.
+//
+static inline bool timer_wheel_cancel( timer_node_t * timer )
+{
+    if( !timer_pending( timer ) ) return false;
+
+    list_del( &timer->list );
+
+    return true;
+}
+
+// Moves every timer in the current bucket of "level" down into the bucket that now fits it. Returns the index of that
+// bucket, which is 0 when the level below has come round too.
+//
+static inline int timer_wheel_cascade( timer_wheel_t * wheel, int level )
+{
+    int slot = ( wheel->next >> ( TIMER_WHEEL_BITS * level ) ) & TIMER_WHEEL_MASK;
+    LIST_INIT(moving);
+    ll_t * node, * copy;
+
+    list_splice( &wheel->buckets[level][slot], &moving );
+    list_for_each_safe( node, copy, &moving )
+    {
+        timer_node_t * timer = (timer_node_t *)node;
+        list_add_tail( node, timer_wheel_bucket( wheel, timer->expires ) );
+    }
+
+    return slot;
+}
+
+// Processes every tick from the wheel's next tick up to and including "now", moving the timers due at each one to the
+// end of "expired" (in the order they're due). Each tick's bucket is moved with a single splice, so this takes O(1)
+// time per tick plus the time to cascade the timers that move between levels. Returns true if any timers expired.
+//
+// The expired timers are still linked together in "expired", so they count as pending; use "list_del" on each one
+// as it's handled (or "timer_wheel_arm" to re-arm it, which does so as well).
+//
+static inline bool timer_wheel_advance( timer_wheel_t * wheel, uint64_t now, ll_t * expired )
+{
+    ll_t * last = expired->prev;
+
+    while( (int64_t)( now - wheel->next ) >= 0 )
+    {
+        int slot = wheel->next & TIMER_WHEEL_MASK;
+
+        // At the start of each round of level 0, bring down the next bucket of level 1, and so on up the levels.
+        //
+        for( int level = 1; slot == 0 && level < TIMER_WHEEL_LEVELS; level++ )
+        {
+            if( timer_wheel_cascade( wheel, level ) != 0 ) break;
+        }
+
+        list_splice_tail( &wheel->buckets[0][slot], expired );
+        wheel->next++;
+    }
+
+    return expired->prev != last;
+}
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,272 @@
+#ifndef VECTOR_H
+#define VECTOR_H
+
+#include <stdlib.h>     // For realloc, free
+#include <string.h>     // For memcpy, memmove
+#include <stdbool.h>    // For bool
+#include "array_methods.h"
+
+// A "vector" is a growable array that keeps track of how many of its elements are actually in use. The functions in
+// "array_methods.h" only know the total number of elements in an array, so an array of capacity N holding M < N
+// elements has to be tracked by hand, "array_insert" has to drop the last element to make room, and
+// "array_filter_in_place" has to zero out the elements it's no longer using. A vector stores the length ("len")
+// separately from the capacity, so none of that is necessary: inserting past the capacity just grows the array.
+//
+// Each time the vector runs out of room, its capacity is doubled (as opposed to grown by a fixed amount), so that
+// appending N elements one at a time only copies the existing elements O(log N) times, or O(1) copies per element
+// on average. Ex:
+//
+//     vector_t vec = VECTOR_INIT(sizeof(uint32_t));
+//
+//     for( uint32_t idx = 0; idx < 1000; idx++ ) vector_push_back( &vec, &idx );
+//     int odd = vector_count( &vec, is_odd );          // 500
+//     vector_filter( &vec, is_odd, NULL );             // vec.len is now 500
+//
+//     uint32_t * values = vec.data;                    // Elements can be accessed directly through "data"...
+//     uint32_t first = *(uint32_t *)vector_at( &vec, 0 );  // ...or with "vector_at"
+//
+//     vector_free( &vec, NULL );
+//
+// Elements past "len" (but below "capacity") are never read or written by these functions, and their contents are
+// unspecified.
+//
+// **WARNING**: Any function that can grow the vector may move its data to a new location in memory. Because of this,
+// it will break any variables that hold pointers to any vector elements, since those pointers will point to memory
+// that has been freed.
+
+typedef struct vector_t
+{
+    void *  data;
+    size_t  len;
+    size_t  capacity;
+    size_t  size;
+} vector_t;
+
+// Static initializer for an empty vector whose elements are "elem_size" bytes each. No memory is allocated until the
+// first element is added.
+//
+#define VECTOR_INIT(elem_size) { NULL, 0, 0, (elem_size) }
+
+static inline void vector_init( vector_t * vec, size_t size )
+{
+    vec->data = NULL;
+    vec->len = 0;
+    vec->capacity = 0;
+    vec->size = size;
+}
+
+// Frees the memory held by the vector, calling "delete" (if not NULL) on each element first, and leaves the vector
+// empty (but still usable).
+//
+static inline void vector_free( vector_t * vec, void (*delete)(void * item) )
+{
+    if( delete )
+    {
+        for( size_t idx = 0; idx < vec->len; idx++ ) delete( vec->data + idx * vec->size );
+    }
+    free( vec->data );
+    vec->data = NULL;
+    vec->len = 0;
+    vec->capacity = 0;
+}
+
+// Returns a pointer to the element at position "pos", or NULL if "pos" is out of range.
+//
+static inline void * vector_at( const vector_t * vec, size_t pos )
+{
+    return pos < vec->len ? vec->data + pos * vec->size : NULL;
+}
+
+// Makes sure the vector can hold at least "capacity" elements without having to grow. Returns "false" if the memory
+// couldn't be allocated, in which case the vector is left unchanged.
+//
+static inline bool vector_reserve( vector_t * vec, size_t capacity )
+{
+    if( capacity <= vec->capacity ) return true;
+
+    void * data = realloc( vec->data, capacity * vec->size );
+    if( data == NULL ) return false;
+
+    vec->data = data;
+    vec->capacity = capacity;
+
+    return true;
+}
+
+// Grows the vector (geometrically) until it can hold at least "len" elements. Helper function used by the functions
+// that add elements.
+//
+static inline bool vector_grow( vector_t * vec, size_t len )
+{
+    if( len <= vec->capacity ) return true;
+
+    size_t capacity = vec->capacity ? vec->capacity * 2 : 4;
+    if( capacity < len ) capacity = len;
+
+    return vector_reserve( vec, capacity );
+}
+
+// Reduces the capacity of the vector to match its length, returning any unused memory. Returns "false" if the memory
+// couldn't be reallocated, in which case the vector is left unchanged.
+//
+static inline bool vector_shrink_to_fit( vector_t * vec )
+{
+    if( vec->len == vec->capacity ) return true;
+
+    if( vec->len == 0 )
+    {
+        free( vec->data );
+        vec->data = NULL;
+        vec->capacity = 0;
+        return true;
+    }
+
+    void * data = realloc( vec->data, vec->len * vec->size );
+    if( data == NULL ) return false;
+
+    vec->data = data;
+    vec->capacity = vec->len;
+
+    return true;
+}
+
+// Copies "elem" onto the end of the vector. Returns "false" if the vector needed to grow and the memory couldn't be
+// allocated.
+//
+static inline bool vector_push_back( vector_t * vec, const void * elem )
+{
+    if( !vector_grow( vec, vec->len + 1 ) ) return false;
+
+    memcpy( vec->data + vec->len * vec->size, elem, vec->size );
+    vec->len++;
+
+    return true;
+}
+
+// Copies the "num" elements in the array "elems" onto the end of the vector with a single block copy. Returns "false"
+// if the vector needed to grow and the memory couldn't be allocated, in which case nothing is appended.
+//
+static inline bool vector_append_n( vector_t * vec, const void * elems, size_t num )
+{
+    if( !vector_grow( vec, vec->len + num ) ) return false;
+
+    memcpy( vec->data + vec->len * vec->size, elems, num * vec->size );
+    vec->len += num;
+
+    return true;
+}
+
+// Removes the last element of the vector, copying it to "elem" (if not NULL). Returns "false" if the vector is empty.
+//
+static inline bool vector_pop_back( vector_t * vec, void * elem )
+{
+    if( vec->len == 0 ) return false;
+
+    vec->len--;
+    if( elem ) memcpy( elem, vec->data + vec->len * vec->size, vec->size );
+
+    return true;
+}
+
+// Insert an element into the vector at position "pos", shifting "pos" and all remaining elements to the right with a
+// single block move. Unlike "array_insert", no element is lost; the vector grows instead. Returns "false" if "pos" is
+// past the end of the vector or if the vector needed to grow and the memory couldn't be allocated.
+//
+static inline bool vector_insert( vector_t * vec, size_t pos, const void * elem )
+{
+    if( pos > vec->len || !vector_grow( vec, vec->len + 1 ) ) return false;
+
+    void * this_item = vec->data + pos * vec->size;
+
+    memmove( this_item + vec->size, this_item, (vec->len - pos) * vec->size );
+    memcpy( this_item, elem, vec->size );
+    vec->len++;
+
+    return true;
+}
+
+// Inserts "elem" into a sorted vector, keeping it sorted (see "array_sorted_insert"). Returns the index at which
+// "elem" was inserted, or -1 if the vector needed to grow and the memory couldn't be allocated.
+//
+static inline int vector_sorted_insert( vector_t * vec, const void * elem, int (*compare)(const void * key, const void * elem) )
+{
+    if( !vector_grow( vec, vec->len + 1 ) ) return -1;
+
+    int pos = array_sorted_insert( vec->data, vec->len, vec->size, elem, compare );
+    vec->len++;
+
+    return pos;
+}
+
+// Remove the element at position "pos", calling "delete" on it (if not NULL) and shifting all remaining elements to
+// the left with a single block move.
+//
+static inline void vector_remove( vector_t * vec, size_t pos, void (*delete)(void * item) )
+{
+    if( pos >= vec->len ) return;
+
+    void * this_item = vec->data + pos * vec->size;
+
+    if( delete ) delete( this_item );
+    memmove( this_item, this_item + vec->size, (vec->len - pos - 1) * vec->size );
+    vec->len--;
+}
+
+// Linear search over the elements in the vector. Returns the index of the value, if found, or -1 if not found.
+//
+static inline int vector_find( const void * key, const vector_t * vec, int (*compare)(const void * key, const void * elem) )
+{
+    return array_find( key, vec->data, vec->len, vec->size, compare );
+}
+
+// Counts the number of elements in the vector for which the function "count_this" returns "true".
+//
+static inline int vector_count( const vector_t * vec, bool (*count_this)(const void * elem) )
+{
+    return array_count( vec->data, vec->len, vec->size, count_this );
+}
+
+// Keeps only those elements in the vector for which the function "keep_this" returns "true", calling "delete" (if
+// not NULL) on every other element. Returns the new length of the vector. Unlike "array_filter_in_place", the
+// elements left over at the end aren't zeroed out; they're simply no longer counted in "len". Consecutive elements
+// that are kept are moved together with a single block move.
+//
+static inline int vector_filter( vector_t * vec, bool (*keep_this)(const void * elem), void (*delete)(void * item) )
+{
+    size_t kept = 0, run_start = 0;
+
+    for( size_t idx = 0; idx <= vec->len; idx++ )
+    {
+        void * this_item = vec->data + idx * vec->size;
+
+        if( idx < vec->len && keep_this( this_item ) ) continue;
+
+        // "this_item" ends a run of elements to keep (or is one past the end of the vector), so move that run to the
+        // end of the filtered part of the vector.
+        //
+        size_t run_length = idx - run_start;
+        if( run_length > 0 && kept != run_start )
+        {
+            memmove( vec->data + kept * vec->size, vec->data + run_start * vec->size, run_length * vec->size );
+        }
+        kept += run_length;
+        run_start = idx + 1;
+
+        if( idx < vec->len && delete ) delete( this_item );
+    }
+
+    vec->len = kept;
+
+    return kept;
+}
+
+// **WARNING**: This function copies vector elements to different locations in memory. Because of this, it will
+// break any variables that hold pointers to any vector elements, since those pointers will point to different
+// pieces of data.
+//
+static inline void vector_reverse( vector_t * vec )
+{
+    array_reverse( vec->data, vec->len, vec->size );
+}
+
+#endif // VECTOR_H
@@ -359,6 +359,135 @@ static inline void list_del(struct ll_head* entry)
 
 /// @}
 
+#pragma mark - Splice -
+
+/// @name Splicing
+/// Operations which move a whole range of nodes between lists at once. Each of these only
+/// relinks the nodes at the ends of the range, so they take the same time regardless of how
+/// many nodes are moved (except for list_split_half(), which has to find the middle).
+/// @{
+
+/// Check whether a list is empty
+/// @param[in] head The head of the list.
+/// @returns 1 if the list contains no nodes other than `head`, 0 otherwise.
+static inline int list_empty(const struct ll_head* head)
+{
+	return head->next == head;
+}
+
+/// Move all of the nodes of one list between two existing elements of another.
+/// Helper function used by list_splice() and list_splice_tail().
+/// @param[in] list The list whose nodes will be moved. Must not be empty.
+/// @param[in] prev The node after which the moved nodes will be placed.
+/// @param[in] next The node before which the moved nodes will be placed.
+static inline void list_splice_between(struct ll_head* list, struct ll_head* prev,
+									   struct ll_head* next)
+{
+	struct ll_head* first = list->next;
+	struct ll_head* last = list->prev;
+
+	first->prev = prev;
+	prev->next = first;
+	last->next = next;
+	next->prev = last;
+}
+
+/// Move all of the nodes of one list to the front of another
+///
+/// The nodes keep their order, and `list` is left empty.
+///
+/// @param[in] list The list whose nodes will be moved.
+/// @param[in] head The head of the list to move them to.
+static inline void list_splice(struct ll_head* list, struct ll_head* head)
+{
+	if(!list_empty(list))
+	{
+		list_splice_between(list, head, head->next);
+		list->next = list->prev = list;
+	}
+}
+
+/// Move all of the nodes of one list to the end of another
+///
+/// The nodes keep their order, and `list` is left empty.
+///
+/// @param[in] list The list whose nodes will be moved.
+/// @param[in] head The head of the list to move them to.
+static inline void list_splice_tail(struct ll_head* list, struct ll_head* head)
+{
+	if(!list_empty(list))
+	{
+		list_splice_between(list, head->prev, head);
+		list->next = list->prev = list;
+	}
+}
+
+/// Move the front of a list, up to and including a given node, into another list
+///
+/// Any nodes already in `list` are discarded (not freed), so `list` should normally be empty.
+///
+/// @param[in] list The list which will receive the nodes from the front of `head`.
+/// @param[in] head The list to cut the nodes from.
+/// @param[in] entry The last node to move. Must be a node of `head`. If `entry` is `head` itself,
+///	`list` is simply emptied.
+static inline void list_cut_position(struct ll_head* list, struct ll_head* head,
+									 struct ll_head* entry)
+{
+	if(entry == head)
+	{
+		list->next = list->prev = list;
+		return;
+	}
+
+	struct ll_head* first = head->next;
+
+	head->next = entry->next;
+	entry->next->prev = head;
+
+	list->next = first;
+	first->prev = list;
+	list->prev = entry;
+	entry->next = list;
+}
+
+/// Split a list into two halves
+///
+/// The front half (including the middle node, if the list has an odd length) stays in `head`
+/// and the back half is moved to `second`. The middle is found by walking inwards from both ends
+/// of the list at once, so this takes about n/2 steps.
+///
+/// Any nodes already in `second` are discarded (not freed), so `second` should normally be empty.
+///
+/// @param[in] head The list to split.
+/// @param[in] second The list which will receive the back half of `head`.
+static inline void list_split_half(struct ll_head* head, struct ll_head* second)
+{
+	struct ll_head* front = head->next;
+	struct ll_head* back = head->prev;
+
+	second->next = second->prev = second;
+	if(front == head || front == back)
+	{
+		return;
+	}
+
+	while(front->next != back && front != back)
+	{
+		front = front->next;
+		back = back->prev;
+	}
+
+	// "front" is now the last node of the front half.
+	second->next = front->next;
+	front->next->prev = second;
+	second->prev = head->prev;
+	head->prev->next = second;
+	front->next = head;
+	head->prev = front;
+}
+
+/// @}
+
 /// @}
 // end group
 
@@ -0,0 +1,444 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>       // For clock_gettime
+#include "perf_counters.h"
+#include "array_methods.h"
+#include "linked_list_methods_EmbArt.h"
+
+// Runs each function in "array_methods.h" and "linked_list_methods_EmbArt.h" under the hardware performance counters
+// (see "perf_counters.h") and reports, per element of input: time, cycles, instructions, L1D / LLC / dTLB read misses
+// and branch misses. Where timing alone only says that something is slow, these say why: a list walk that is bound by
+// cache misses shows ~1 LLC miss per element once the nodes are shuffled, while a filter that is bound by branch
+// mispredictions shows ~0.5 branch misses per element on random data.
+//
+// Every kernel runs on 1K, 64K and 1M elements (from fitting in L1 to well past the LLC). Arrays hold random 64-bit
+// values; lists are run twice, once with their nodes in memory in list order ("list-seq") and once with the same nodes
+// linked in a random order ("list-shuffl"), which is what a long-lived list looks like after many insertions and
+// deletions. The input is rebuilt, outside of the measurement, before each repetition.
+//
+// Built and run with "make profile", which prints the table and writes the same rows as CSV to
+// "build/results/Profilecollection_methods.csv" (or to the file named by the first argument). When the counters can't
+// be opened (most containers and VMs, or "/proc/sys/kernel/perf_event_paranoid" > 2), only the time is reported.
+
+#define MAX_NUM             (1u << 20)
+#define ELEMENTS_PER_RUN    (1u << 22)      // Small inputs are repeated until at least this many elements are processed
+#define TOP_K               16
+
+typedef struct profile_node_t
+{
+    ll_t        list;
+    int64_t     data;
+} profile_node_t;
+
+static int64_t values[MAX_NUM];             // The random input, shared by every kernel
+static int64_t work[MAX_NUM], other[MAX_NUM], scratch[MAX_NUM];
+static profile_node_t nodes[MAX_NUM], copies[MAX_NUM];
+static size_t order[MAX_NUM];               // order[idx] = which node holds the idx-th element of the list
+static size_t num_copies;
+static LIST_INIT(list);
+static LIST_INIT(other_list);
+static volatile uint64_t sink;
+
+static int64_t absent_key = -1;             // Random values are never negative, so every search scans the whole input
+static int64_t threshold = INT64_MAX / 2;   // Half of the random values are below this
+
+/* -------------------------------------------------- Callbacks --------------------------------------------------- */
+
+static int compare_values( const void * item_one, const void * item_two )
+{
+    int64_t one = *(const int64_t *)item_one, two = *(const int64_t *)item_two;
+    return ( two < one ) - ( one < two );
+}
+
+static bool is_small_value( const void * elem )
+{
+    return *(const int64_t *)elem < threshold;
+}
+
+static int compare_nodes( const void * item_one, const void * item_two )
+{
+    int64_t one = ((const profile_node_t *)item_one)->data, two = ((const profile_node_t *)item_two)->data;
+    return ( two < one ) - ( one < two );
+}
+
+static int compare_node_pointers( const void * item_one, const void * item_two )
+{
+    return compare_nodes( *(void * const *)item_one, *(void * const *)item_two );
+}
+
+static int compare_key_to_node( const void * key, const void * elem )
+{
+    int64_t one = *(const int64_t *)key, two = ((const profile_node_t *)elem)->data;
+    return ( two < one ) - ( one < two );
+}
+
+static bool is_small_node( const void * elem )
+{
+    return ((const profile_node_t *)elem)->data < threshold;
+}
+
+static void * copy_node( const void * elem )
+{
+    profile_node_t * copy = &copies[num_copies++];
+    copy->data = ((const profile_node_t *)elem)->data;
+    return copy;
+}
+
+/* ------------------------------------------------ Input builders ------------------------------------------------ */
+
+static uint64_t rand_state = 88172645463325252ULL;
+
+static uint64_t profile_rand( void )
+{
+    uint64_t x = rand_state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    rand_state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+static void setup_array( size_t num )
+{
+    memcpy( work, values, num * sizeof(values[0]) );
+}
+
+static void setup_sorted_array( size_t num )
+{
+    setup_array( num );
+    qsort( work, num, sizeof(work[0]), compare_values );
+}
+
+// Two sorted halves, for the merges.
+//
+static void setup_sorted_halves( size_t num )
+{
+    setup_array( num );
+    qsort( work, num / 2, sizeof(work[0]), compare_values );
+    qsort( work + num / 2, num - num / 2, sizeof(work[0]), compare_values );
+}
+
+// Links the first "num" nodes into "head" in the order given by "order", with the values from "source".
+//
+static void build_list( ll_t * head, size_t first, size_t num, const int64_t * source )
+{
+    head->next = head->prev = head;
+    for( size_t idx = first; idx < first + num; idx++ )
+    {
+        profile_node_t * node = &nodes[order[idx]];
+        node->data = source[idx];
+        list_add_tail( &node->list, head );
+    }
+}
+
+static void setup_list( size_t num )
+{
+    build_list( &list, 0, num, values );
+    other_list.next = other_list.prev = &other_list;
+    num_copies = 0;
+}
+
+static void setup_sorted_list( size_t num )
+{
+    setup_sorted_array( num );
+    build_list( &list, 0, num, work );
+}
+
+static void setup_sorted_lists( size_t num )
+{
+    setup_sorted_halves( num );
+    build_list( &list, 0, num / 2, work );
+    build_list( &other_list, num / 2, num - num / 2, work );
+}
+
+// Fills "order" for the current layout: the identity for "list-seq", a random permutation for "list-shuffl". Only the
+// first "num" entries are shuffled, so that a small list doesn't spread its nodes over the whole pool.
+//
+static void set_layout( size_t num, bool shuffle )
+{
+    for( size_t idx = 0; idx < num; idx++ ) order[idx] = idx;
+    if( shuffle )
+    {
+        for( size_t idx = num - 1; idx > 0; idx-- )
+        {
+            size_t pick = profile_rand() % ( idx + 1 ), temp = order[idx];
+            order[idx] = order[pick];
+            order[pick] = temp;
+        }
+    }
+}
+
+/* -------------------------------------------------- Array kernels ----------------------------------------------- */
+
+static void run_array_find( size_t num )            { sink += array_find( &absent_key, work, num, sizeof(work[0]), compare_values ); }
+static void run_array_find_max( size_t num )        { sink += array_find_max( work, num, sizeof(work[0]), compare_values ); }
+static void run_array_find_min( size_t num )        { sink += array_find_min( work, num, sizeof(work[0]), compare_values ); }
+static void run_array_count( size_t num )           { sink += array_count( work, num, sizeof(work[0]), is_small_value ); }
+static void run_array_filter_in_place( size_t num ) { sink += array_filter_in_place( work, num, sizeof(work[0]), is_small_value, NULL ); }
+static void run_array_filter_pure( size_t num )     { sink += array_filter_pure( work, num, sizeof(work[0]), other, is_small_value ); }
+static void run_array_reverse( size_t num )         { array_reverse( work, num, sizeof(work[0]) ); sink += work[0]; }
+static void run_array_nth_element( size_t num )     { array_nth_element( work, num, sizeof(work[0]), num / 2, compare_values ); sink += work[num / 2]; }
+static void run_array_top_k( size_t num )           { sink += array_top_k( work, num, sizeof(work[0]), TOP_K, other, compare_values ); }
+static void run_array_stable_sort( size_t num )     { array_stable_sort_with_scratch( work, num, sizeof(work[0]), scratch, compare_values ); sink += work[0]; }
+
+static void run_array_find_minmax( size_t num )
+{
+    int min, max;
+    array_find_minmax( work, num, sizeof(work[0]), &min, &max, compare_values );
+    sink += min + max;
+}
+
+// One lookup per element, of random keys, so the per-element numbers are per lookup.
+//
+static void run_array_lower_bound( size_t num )
+{
+    for( size_t idx = 0; idx < num; idx++ ) sink += array_lower_bound( &values[idx], work, num, sizeof(work[0]), compare_values );
+}
+
+static void run_array_upper_bound( size_t num )
+{
+    for( size_t idx = 0; idx < num; idx++ ) sink += array_upper_bound( &values[idx], work, num, sizeof(work[0]), compare_values );
+}
+
+// Insertion and removal at the front, which moves every element.
+//
+static void run_array_insert( size_t num )          { array_insert( work, num, sizeof(work[0]), 0, &absent_key, NULL ); sink += work[0]; }
+static void run_array_remove( size_t num )          { array_remove( work, num, sizeof(work[0]), 0, NULL ); sink += work[0]; }
+
+static void run_array_sorted_insert( size_t num )
+{
+    sink += array_sorted_insert( work, num - 1, sizeof(work[0]), &values[num - 1], compare_values );
+}
+
+static void run_array_merge_sorted( size_t num )
+{
+    sink += array_merge_sorted( work, num / 2, work + num / 2, num - num / 2, sizeof(work[0]), other, compare_values );
+}
+
+static void run_array_merge_sorted_in_place( size_t num )
+{
+    array_merge_sorted_in_place( work, num / 2, num, sizeof(work[0]), scratch, compare_values );
+    sink += work[0];
+}
+
+/* -------------------------------------------------- List kernels ------------------------------------------------ */
+
+static void run_list_find( size_t num )             { (void)num; sink += (uintptr_t)linked_list_find( &absent_key, &list, compare_key_to_node ); }
+static void run_list_find_max( size_t num )         { (void)num; sink += (uintptr_t)linked_list_find_max( &list, compare_nodes ); }
+static void run_list_find_min( size_t num )         { (void)num; sink += (uintptr_t)linked_list_find_min( &list, compare_nodes ); }
+static void run_list_top_k( size_t num )            { (void)num; sink += linked_list_top_k( &list, TOP_K, (void **)other, compare_nodes ); }
+static void run_list_count( size_t num )            { (void)num; sink += linked_list_count( &list, is_small_node ); }
+static void run_list_filter_in_place( size_t num )  { (void)num; sink += linked_list_filter_in_place( &list, &other_list, is_small_node ); }
+static void run_list_filter_pure( size_t num )      { (void)num; sink += linked_list_filter_pure( &list, &other_list, is_small_node, copy_node ); }
+static void run_list_reverse( size_t num )          { (void)num; linked_list_reverse( &list ); sink += (uintptr_t)list.next; }
+static void run_list_qsort( size_t num )            { (void)num; linked_list_qsort( &list, compare_node_pointers ); sink += (uintptr_t)list.next; }
+static void run_list_merge_sort( size_t num )       { (void)num; linked_list_merge_sort( &list, compare_nodes ); sink += (uintptr_t)list.next; }
+static void run_list_insertion_sort( size_t num )   { (void)num; linked_list_insertion_sort( &list, compare_nodes ); sink += (uintptr_t)list.next; }
+static void run_list_merge_sorted( size_t num )     { (void)num; linked_list_merge_sorted( &list, &other_list, compare_nodes ); sink += (uintptr_t)list.next; }
+
+static void run_list_find_minmax( size_t num )
+{
+    void * min, * max;
+    (void)num;
+    linked_list_find_minmax( &list, &min, &max, compare_nodes );
+    sink += (uintptr_t)min ^ (uintptr_t)max;
+}
+
+// Takes the last node off the sorted list, then puts it back where it belongs.
+//
+static void run_list_sorted_insert( size_t num )
+{
+    ll_t * node = list.prev;
+    (void)num;
+    list_del( node );
+    linked_list_sorted_insert( &list, node, compare_nodes );
+    sink += (uintptr_t)list.prev;
+}
+
+/* ---------------------------------------------------- Harness --------------------------------------------------- */
+
+typedef struct profile_kernel_t
+{
+    const char *    name;
+    bool            is_list;
+    size_t          max_num;        // Largest input to run on (quadratic kernels, and "linked_list_qsort" puts an
+                                    // array of node pointers on the stack), or 0 for no limit
+    void            (*setup)(size_t num);
+    void            (*run)(size_t num);
+} profile_kernel_t;
+
+static const profile_kernel_t kernels[] =
+{
+    { "array_find",                     false, 0,       setup_array,            run_array_find },
+    { "array_lower_bound",              false, 0,       setup_sorted_array,     run_array_lower_bound },
+    { "array_upper_bound",              false, 0,       setup_sorted_array,     run_array_upper_bound },
+    { "array_find_max",                 false, 0,       setup_array,            run_array_find_max },
+    { "array_find_min",                 false, 0,       setup_array,            run_array_find_min },
+    { "array_find_minmax",              false, 0,       setup_array,            run_array_find_minmax },
+    { "array_filter_in_place",          false, 0,       setup_array,            run_array_filter_in_place },
+    { "array_filter_pure",              false, 0,       setup_array,            run_array_filter_pure },
+    { "array_count",                    false, 0,       setup_array,            run_array_count },
+    { "array_insert",                   false, 0,       setup_array,            run_array_insert },
+    { "array_remove",                   false, 0,       setup_array,            run_array_remove },
+    { "array_sorted_insert",            false, 0,       setup_sorted_array,     run_array_sorted_insert },
+    { "array_merge_sorted",             false, 0,       setup_sorted_halves,    run_array_merge_sorted },
+    { "array_merge_sorted_in_place",    false, 0,       setup_sorted_halves,    run_array_merge_sorted_in_place },
+    { "array_reverse",                  false, 0,       setup_array,            run_array_reverse },
+    { "array_nth_element",              false, 0,       setup_array,            run_array_nth_element },
+    { "array_top_k",                    false, 0,       setup_array,            run_array_top_k },
+    { "array_stable_sort",              false, 0,       setup_array,            run_array_stable_sort },
+    { "linked_list_find",               true,  0,       setup_list,             run_list_find },
+    { "linked_list_find_max",           true,  0,       setup_list,             run_list_find_max },
+    { "linked_list_find_min",           true,  0,       setup_list,             run_list_find_min },
+    { "linked_list_find_minmax",        true,  0,       setup_list,             run_list_find_minmax },
+    { "linked_list_top_k",              true,  0,       setup_list,             run_list_top_k },
+    { "linked_list_filter_in_place",    true,  0,       setup_list,             run_list_filter_in_place },
+    { "linked_list_filter_pure",        true,  0,       setup_list,             run_list_filter_pure },
+    { "linked_list_count",              true,  0,       setup_list,             run_list_count },
+    { "linked_list_reverse",            true,  0,       setup_list,             run_list_reverse },
+    { "linked_list_sorted_insert",      true,  0,       setup_sorted_list,      run_list_sorted_insert },
+    { "linked_list_merge_sorted",       true,  0,       setup_sorted_lists,     run_list_merge_sorted },
+    { "linked_list_qsort",              true,  1u << 18, setup_list,            run_list_qsort },
+    { "linked_list_merge_sort",         true,  0,       setup_list,             run_list_merge_sort },
+    { "linked_list_insertion_sort",     true,  1u << 12, setup_list,            run_list_insertion_sort },
+};
+
+static const size_t sizes[] = { 1u << 10, 1u << 16, 1u << 20 };
+
+static double profile_now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Runs one kernel on one size and layout, and prints its row of the table and of the CSV.
+//
+static void profile_kernel( const profile_kernel_t * kernel, size_t num, const char * layout, perf_counters_t * counters, FILE * csv )
+{
+    size_t reps = num < ELEMENTS_PER_RUN ? ELEMENTS_PER_RUN / num : 1;
+    double totals[PERF_COUNTER_COUNT] = { 0 }, seconds = 0;
+    bool available[PERF_COUNTER_COUNT];
+
+    // Very slow kernels (sorts on large inputs) get fewer repetitions.
+    //
+    if( kernel->run == run_list_insertion_sort || kernel->run == run_list_qsort ) reps = reps > 64 ? 64 : reps;
+
+    for( int idx = 0; idx < PERF_COUNTER_COUNT; idx++ ) available[idx] = counters->fd[idx] >= 0;
+
+    for( size_t rep = 0; rep < reps; rep++ )
+    {
+        kernel->setup( num );
+
+        double start = profile_now();
+        perf_counters_start( counters );
+        kernel->run( num );
+        perf_counters_stop( counters );
+        seconds += profile_now() - start;
+
+        for( int idx = 0; idx < PERF_COUNTER_COUNT; idx++ )
+        {
+            if( counters->value[idx] < 0 ) available[idx] = false;
+            else totals[idx] += counters->value[idx];
+        }
+    }
+
+    double elements = (double)num * reps;
+
+    printf( "%-30s %-11s %8zu %9.2f", kernel->name, layout, num, seconds * 1e9 / elements );
+    fprintf( csv, "%s,%s,%zu,%zu,%.4f", kernel->name, layout, num, reps, seconds * 1e9 / elements );
+
+    for( int idx = 0; idx < PERF_COUNTER_COUNT; idx++ )
+    {
+        if( available[idx] )
+        {
+            printf( " %10.3f", totals[idx] / elements );
+            fprintf( csv, ",%.4f", totals[idx] / elements );
+        }
+        else
+        {
+            printf( " %10s", "n/a" );
+            fprintf( csv, "," );
+        }
+    }
+
+    if( available[PERF_COUNTER_CYCLES] && available[PERF_COUNTER_INSTRUCTIONS] && totals[PERF_COUNTER_CYCLES] > 0 )
+    {
+        printf( " %6.2f\n", totals[PERF_COUNTER_INSTRUCTIONS] / totals[PERF_COUNTER_CYCLES] );
+        fprintf( csv, ",%.4f\n", totals[PERF_COUNTER_INSTRUCTIONS] / totals[PERF_COUNTER_CYCLES] );
+    }
+    else
+    {
+        printf( " %6s\n", "n/a" );
+        fprintf( csv, ",\n" );
+    }
+}
+
+int main( int argc, char * argv[] )
+{
+    const char * csv_path = argc > 1 ? argv[1] : "Profilecollection_methods.csv";
+    FILE * csv = fopen( csv_path, "w" );
+    perf_counters_t counters;
+
+    if( csv == NULL )
+    {
+        perror( csv_path );
+        return 1;
+    }
+
+    for( size_t idx = 0; idx < MAX_NUM; idx++ ) values[idx] = profile_rand() >> 1;
+
+    int opened = perf_counters_open( &counters );
+    if( opened < PERF_COUNTER_COUNT )
+    {
+        FILE * paranoid_file = fopen( "/proc/sys/kernel/perf_event_paranoid", "r" );
+        int paranoid = 0;
+
+        if( paranoid_file == NULL || fscanf( paranoid_file, "%d", &paranoid ) != 1 ) paranoid = -99;
+        if( paranoid_file ) fclose( paranoid_file );
+
+        printf( "# Only %d of %d hardware counters could be opened (perf_event_paranoid = %d); the others are reported as n/a.\n",
+                opened, PERF_COUNTER_COUNT, paranoid );
+        if( opened == 0 ) printf( "# Reporting time only. Counters need a PMU (not virtualized away) and perf_event_paranoid <= 2.\n" );
+    }
+
+    printf( "# All counts are per element of input (per lookup for the bound searches).\n" );
+    printf( "%-30s %-11s %8s %9s", "kernel", "layout", "n", "ns" );
+    fprintf( csv, "kernel,layout,n,repetitions,ns" );
+    for( int idx = 0; idx < PERF_COUNTER_COUNT; idx++ )
+    {
+        printf( " %10s", perf_counter_names[idx] );
+        fprintf( csv, ",%s", perf_counter_names[idx] );
+    }
+    printf( " %6s\n", "IPC" );
+    fprintf( csv, ",IPC\n" );
+
+    for( size_t kernel = 0; kernel < sizeof(kernels) / sizeof(kernels[0]); kernel++ )
+    {
+        for( size_t size = 0; size < sizeof(sizes) / sizeof(sizes[0]); size++ )
+        {
+            size_t num = sizes[size];
+
+            if( kernels[kernel].max_num && num > kernels[kernel].max_num ) continue;
+
+            if( !kernels[kernel].is_list )
+            {
+                profile_kernel( &kernels[kernel], num, "array", &counters, csv );
+                continue;
+            }
+
+            set_layout( num, false );
+            profile_kernel( &kernels[kernel], num, "list-seq", &counters, csv );
+            set_layout( num, true );
+            profile_kernel( &kernels[kernel], num, "list-shuffl", &counters, csv );
+        }
+    }
+
+    perf_counters_close( &counters );
+    fclose( csv );
+    printf( "# CSV written to %s\n", csv_path );
+
+    return 0;
+}
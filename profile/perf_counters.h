@@ -0,0 +1,117 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>             // For memset
+#include <unistd.h>             // For syscall, read, close
+#include <sys/ioctl.h>          // For ioctl
+#include <sys/syscall.h>        // For SYS_perf_event_open
+#include <linux/perf_event.h>   // For perf_event_attr, PERF_*
+
+// Thin wrapper around Linux's "perf_event_open" that counts a fixed set of hardware events for the calling thread
+// (user space only) between "perf_counters_start" and "perf_counters_stop".
+//
+// Each event is opened on its own rather than as one group, so that an event the CPU (or the virtual machine, or the
+// "perf_event_paranoid" setting) doesn't allow is simply reported as unavailable instead of disabling all of them. If
+// the kernel multiplexes the counters (more events than hardware counters), the counts are scaled by the fraction of
+// time each one was actually running.
+
+typedef enum perf_counter_id_t
+{
+    PERF_COUNTER_CYCLES,
+    PERF_COUNTER_INSTRUCTIONS,
+    PERF_COUNTER_L1D_MISSES,
+    PERF_COUNTER_LLC_MISSES,
+    PERF_COUNTER_DTLB_MISSES,
+    PERF_COUNTER_BRANCH_MISSES,
+    PERF_COUNTER_COUNT
+} perf_counter_id_t;
+
+static const char * const perf_counter_names[PERF_COUNTER_COUNT] =
+{
+    "cycles", "instructions", "L1D-misses", "LLC-misses", "dTLB-misses", "branch-misses"
+};
+
+typedef struct perf_counters_t
+{
+    int         fd[PERF_COUNTER_COUNT];         // -1 if the event couldn't be opened
+    double      value[PERF_COUNTER_COUNT];      // Counts from the last start/stop, or -1 if unavailable
+} perf_counters_t;
+
+// Opens every counter that's available. Returns the number that were opened (0 if hardware counters can't be used at
+// all, e.g. inside most containers and virtual machines).
+//
+static inline int perf_counters_open( perf_counters_t * counters )
+{
+    static const struct { uint32_t type; uint64_t config; } events[PERF_COUNTER_COUNT] =
+    {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 ) },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 ) },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 ) },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    };
+    int opened = 0;
+
+    for( int idx = 0; idx < PERF_COUNTER_COUNT; idx++ )
+    {
+        struct perf_event_attr attr;
+
+        memset( &attr, 0, sizeof(attr) );
+        attr.size = sizeof(attr);
+        attr.type = events[idx].type;
+        attr.config = events[idx].config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        counters->fd[idx] = syscall( SYS_perf_event_open, &attr, 0, -1, -1, 0 );
+        counters->value[idx] = -1;
+        if( counters->fd[idx] >= 0 ) opened++;
+    }
+
+    return opened;
+}
+
+static inline void perf_counters_start( perf_counters_t * counters )
+{
+    for( int idx = 0; idx < PERF_COUNTER_COUNT; idx++ )
+    {
+        if( counters->fd[idx] < 0 ) continue;
+        ioctl( counters->fd[idx], PERF_EVENT_IOC_RESET, 0 );
+        ioctl( counters->fd[idx], PERF_EVENT_IOC_ENABLE, 0 );
+    }
+}
+
+static inline void perf_counters_stop( perf_counters_t * counters )
+{
+    for( int idx = 0; idx < PERF_COUNTER_COUNT; idx++ )
+    {
+        if( counters->fd[idx] >= 0 ) ioctl( counters->fd[idx], PERF_EVENT_IOC_DISABLE, 0 );
+    }
+
+    for( int idx = 0; idx < PERF_COUNTER_COUNT; idx++ )
+    {
+        uint64_t data[3];   // value, time enabled, time running
+
+        counters->value[idx] = -1;
+        if( counters->fd[idx] < 0 || read( counters->fd[idx], data, sizeof(data) ) != sizeof(data) ) continue;
+
+        if( data[2] == 0 ) continue;    // Never got scheduled onto a hardware counter
+        counters->value[idx] = data[2] < data[1] ? (double)data[0] * data[1] / data[2] : (double)data[0];
+    }
+}
+
+static inline void perf_counters_close( perf_counters_t * counters )
+{
+    for( int idx = 0; idx < PERF_COUNTER_COUNT; idx++ )
+    {
+        if( counters->fd[idx] >= 0 ) close( counters->fd[idx] );
+        counters->fd[idx] = -1;
+    }
+}
+
+#endif // PERF_COUNTERS_H
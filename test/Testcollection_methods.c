@@ -4,6 +4,22 @@
 #include "unity.h"
 #include "array_methods.h"
 #include "linked_list_methods_EmbArt.h"
+#include "ring_buffer.h"
+#include "vector.h"
+#include "array_file.h"
+#include "offset_list.h"
+#include "stream_methods.h"
+#include "pool_list.h"
+#include "array_sort_small.h"
+#include "radix_sort.h"
+#include "parallel_sort.h"
+#include "list_segments.h"
+#include "tlist.h"
+#include "lru_cache.h"
+#include "pairing_heap.h"
+#include "timer_wheel.h"
+#include "array_set_simd.h"
+#include "bplus_tree.h"
 #include "ll.h"
 
 uint32_t actual[5];
@@ -74,6 +90,12 @@ static inline int compare_myStructs( const void * item_one, const void * item_tw
     return ((myStruct_t *)item_one)->data - ((myStruct_t *)item_two)->data;
 }
 
+static inline int compare_uint32( const void * item_one, const void * item_two )
+{
+    uint32_t one = *(uint32_t *)item_one, two = *(uint32_t *)item_two;
+    return (one > two) - (one < two);
+}
+
 static inline int compare_myStructs_for_qsort( const void * item_one, const void * item_two )
 {
     return (*(myStruct_t **)item_one)->data - (*(myStruct_t **)item_two)->data;
@@ -159,6 +181,268 @@ void test_array_reverse(void)
     TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, actual, LEN_ARRAY(actual));
 }
 
+void test_array_find_max_and_min(void)
+{
+    uint32_t values[] = {7,3,9,1,9,4,1,8};
+    TEST_ASSERT_EQUAL( 2, array_find_max(values, LEN_ARRAY(values), sizeof(values[0]), compare_uint32) );
+    TEST_ASSERT_EQUAL( 3, array_find_min(values, LEN_ARRAY(values), sizeof(values[0]), compare_uint32) );
+}
+
+void test_array_find_minmax(void)
+{
+    uint32_t values[] = {7,3,9,1,9,4,1,8};
+    int min, max;
+    array_find_minmax(values, LEN_ARRAY(values), sizeof(values[0]), &min, &max, compare_uint32);
+    TEST_ASSERT_EQUAL( 3, min );
+    TEST_ASSERT_EQUAL( 2, max );
+}
+
+void test_array_find_minmax_odd_length(void)
+{
+    int min, max;
+    array_find_minmax(actual, LEN_ARRAY(actual), sizeof(actual[0]), &min, &max, compare_uint32);
+    TEST_ASSERT_EQUAL( 0, min );
+    TEST_ASSERT_EQUAL( 4, max );
+}
+
+void test_array_nth_element(void)
+{
+    uint32_t values[64];
+    ARRAY_FOR_EACH(values, idx) values[idx] = (idx * 37) % 64;
+    array_nth_element(values, LEN_ARRAY(values), sizeof(values[0]), 50, compare_uint32);
+    TEST_ASSERT_EQUAL_UINT32( 50, values[50] );
+    ARRAY_FOR_EACH(values, idx)
+    {
+        if( idx < 50 ) TEST_ASSERT_TRUE( values[idx] <= 50 );
+        if( idx > 50 ) TEST_ASSERT_TRUE( values[idx] >= 50 );
+    }
+}
+
+void test_array_nth_element_with_duplicates(void)
+{
+    uint32_t values[100];
+    ARRAY_FOR_EACH(values, idx) values[idx] = idx % 3;
+    array_nth_element(values, LEN_ARRAY(values), sizeof(values[0]), 40, compare_uint32);
+    TEST_ASSERT_EQUAL_UINT32( 1, values[40] );
+    ARRAY_FOR_EACH(values, idx)
+    {
+        if( idx < 40 ) TEST_ASSERT_TRUE( values[idx] <= 1 );
+        if( idx > 40 ) TEST_ASSERT_TRUE( values[idx] >= 1 );
+    }
+}
+
+void test_array_top_k(void)
+{
+    uint32_t values[] = {5,17,3,12,9,20,1,14};
+    uint32_t copy[LEN_ARRAY(values)];
+    memcpy(copy, values, sizeof(values));
+    uint32_t top[3], expected[] = {20,17,14};
+    int count = array_top_k(values, LEN_ARRAY(values), sizeof(values[0]), LEN_ARRAY(top), top, compare_uint32);
+    TEST_ASSERT_EQUAL( 3, count );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, top, LEN_ARRAY(top));
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(copy, values, LEN_ARRAY(values));
+}
+
+void test_array_top_k_returns_all_items_when_k_exceeds_num(void)
+{
+    uint32_t top[8], expected[] = {5,4,3,2,1};
+    int count = array_top_k(actual, LEN_ARRAY(actual), sizeof(actual[0]), LEN_ARRAY(top), top, compare_uint32);
+    TEST_ASSERT_EQUAL( 5, count );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, top, count);
+}
+
+void test_array_sorted_insert(void)
+{
+    uint32_t values[6] = {1,3,5,7,9}, expected[] = {1,3,5,6,7,9};
+    uint32_t elem_to_insert = 6;
+    int pos = array_sorted_insert(values, 5, sizeof(values[0]), &elem_to_insert, compare_uint32);
+    TEST_ASSERT_EQUAL( 3, pos );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, values, LEN_ARRAY(values));
+}
+
+void test_array_sorted_insert_at_ends(void)
+{
+    uint32_t values[7] = {3,5,7,9,11}, expected[] = {1,3,5,7,9,11,12};
+    uint32_t smallest = 1, largest = 12;
+    TEST_ASSERT_EQUAL( 0, array_sorted_insert(values, 5, sizeof(values[0]), &smallest, compare_uint32) );
+    TEST_ASSERT_EQUAL( 6, array_sorted_insert(values, 6, sizeof(values[0]), &largest, compare_uint32) );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, values, LEN_ARRAY(values));
+}
+
+void test_array_merge_sorted(void)
+{
+    uint32_t one[] = {1,4,6}, two[] = {2,3,7,9}, merged[7], expected[] = {1,2,3,4,6,7,9};
+    int count = array_merge_sorted(one, LEN_ARRAY(one), two, LEN_ARRAY(two), sizeof(one[0]), merged, compare_uint32);
+    TEST_ASSERT_EQUAL( 7, count );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, merged, LEN_ARRAY(merged));
+}
+
+void test_array_merge_sorted_in_place(void)
+{
+    uint32_t values[] = {1,2,6,8,9,3,4,7,10}, scratch[5], expected[] = {1,2,3,4,6,7,8,9,10};
+    array_merge_sorted_in_place(values, 5, LEN_ARRAY(values), sizeof(values[0]), scratch, compare_uint32);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, values, LEN_ARRAY(values));
+}
+
+typedef struct keyed_t
+{
+    uint32_t    key;
+    uint32_t    order;      // Position before sorting, to check stability
+} keyed_t;
+
+static inline int compare_keyed( const void * item_one, const void * item_two )
+{
+    uint32_t one = ((keyed_t *)item_one)->key, two = ((keyed_t *)item_two)->key;
+    return ( two < one ) - ( one < two );
+}
+
+static void check_stable_sort( const keyed_t * sorted, size_t num )
+{
+    for( size_t idx = 1; idx < num; idx++ )
+    {
+        TEST_ASSERT_TRUE( sorted[idx - 1].key <= sorted[idx].key );
+        if( sorted[idx - 1].key == sorted[idx].key ) TEST_ASSERT_TRUE( sorted[idx - 1].order < sorted[idx].order );
+    }
+}
+
+void test_array_stable_sort_keeps_equal_elements_in_order(void)
+{
+    keyed_t values[] = { {3,0}, {1,1}, {3,2}, {2,3}, {1,4}, {2,5}, {3,6} };
+    TEST_ASSERT_TRUE( array_stable_sort(values, LEN_ARRAY(values), sizeof(values[0]), compare_keyed) );
+    check_stable_sort( values, LEN_ARRAY(values) );
+    TEST_ASSERT_EQUAL( 1, values[0].order );
+    TEST_ASSERT_EQUAL( 6, values[6].order );
+}
+
+void test_array_stable_sort_with_scratch_on_runs(void)
+{
+    // Ascending runs, descending runs, and random stretches with many duplicate keys, long enough to need merging.
+    //
+    keyed_t values[2000], scratch[1000];
+    uint32_t state = 1;
+    for( uint32_t idx = 0; idx < LEN_ARRAY(values); idx++ )
+    {
+        state = state * 1103515245 + 12345;
+        if( idx < 500 ) values[idx].key = idx / 4;
+        else if( idx < 1000 ) values[idx].key = 1000 - idx;
+        else values[idx].key = ( state >> 16 ) % 50;
+        values[idx].order = idx;
+    }
+    array_stable_sort_with_scratch( values, LEN_ARRAY(values), sizeof(values[0]), scratch, compare_keyed );
+    check_stable_sort( values, LEN_ARRAY(values) );
+}
+
+void test_array_stable_sort_reversed_input(void)
+{
+    keyed_t values[300];
+    for( uint32_t idx = 0; idx < LEN_ARRAY(values); idx++ )
+    {
+        values[idx].key = LEN_ARRAY(values) - idx / 2;
+        values[idx].order = idx;
+    }
+    TEST_ASSERT_TRUE( array_stable_sort(values, LEN_ARRAY(values), sizeof(values[0]), compare_keyed) );
+    check_stable_sort( values, LEN_ARRAY(values) );
+}
+
+void test_list_splice(void)
+{
+    list_splice( &myList_unsorted, &myList );
+    TEST_ASSERT_TRUE( list_empty( &myList_unsorted ) );
+    uint32_t idx = 0, expected[] = {4,2,3,5,1,1,2,3,4,5};
+    ll_t *node;
+    list_for_each( node, &myList )
+    {
+        TEST_ASSERT_EQUAL_UINT32( expected[idx++], ((myStruct_t *)node)->data);
+    }
+    TEST_ASSERT_EQUAL( 10, idx );
+    list_for_each( node, &myList_unsorted ) idx++;
+    TEST_ASSERT_EQUAL( 10, idx );
+}
+
+void test_list_splice_tail(void)
+{
+    LIST_INIT(test_list);
+    list_splice_tail( &test_list, &myList );
+    list_splice_tail( &myList_unsorted, &myList );
+    uint32_t idx = 0, expected[] = {1,2,3,4,5,4,2,3,5,1};
+    ll_t *node;
+    list_for_each( node, &myList )
+    {
+        TEST_ASSERT_EQUAL_UINT32( expected[idx++], ((myStruct_t *)node)->data);
+    }
+    TEST_ASSERT_EQUAL( 10, idx );
+    TEST_ASSERT_TRUE( myList.prev == &node_F.node );
+}
+
+void test_list_cut_position(void)
+{
+    LIST_INIT(front);
+    list_cut_position( &front, &myList, &node_C.node );
+    uint32_t idx = 0, expected_front[] = {1,2,3}, expected_back[] = {4,5};
+    ll_t *node;
+    list_for_each( node, &front )
+    {
+        TEST_ASSERT_EQUAL_UINT32( expected_front[idx++], ((myStruct_t *)node)->data);
+    }
+    TEST_ASSERT_EQUAL( 3, idx );
+    idx = 0;
+    list_for_each( node, &myList )
+    {
+        TEST_ASSERT_EQUAL_UINT32( expected_back[idx++], ((myStruct_t *)node)->data);
+    }
+    TEST_ASSERT_EQUAL( 2, idx );
+    list_splice( &front, &myList );
+}
+
+void test_list_split_half(void)
+{
+    LIST_INIT(second);
+    list_split_half( &myList, &second );
+    uint32_t idx = 0, expected_first[] = {1,2,3}, expected_second[] = {4,5};
+    ll_t *node;
+    list_for_each( node, &myList )
+    {
+        TEST_ASSERT_EQUAL_UINT32( expected_first[idx++], ((myStruct_t *)node)->data);
+    }
+    TEST_ASSERT_EQUAL( 3, idx );
+    idx = 0;
+    list_for_each( node, &second )
+    {
+        TEST_ASSERT_EQUAL_UINT32( expected_second[idx++], ((myStruct_t *)node)->data);
+    }
+    TEST_ASSERT_EQUAL( 2, idx );
+    TEST_ASSERT_TRUE( second.prev == &node_E.node );
+    list_splice_tail( &second, &myList );
+}
+
+void test_linked_list_merge_sorted(void)
+{
+    LIST_INIT(other);
+    node_F.data = 0, node_G.data = 2, node_H.data = 3, node_I.data = 7, node_J.data = 8;
+    list_del( &node_F.node );
+    list_del( &node_G.node );
+    list_del( &node_H.node );
+    list_del( &node_I.node );
+    list_del( &node_J.node );
+    list_add_tail( &node_F.node, &other );
+    list_add_tail( &node_G.node, &other );
+    list_add_tail( &node_H.node, &other );
+    list_add_tail( &node_I.node, &other );
+    list_add_tail( &node_J.node, &other );
+    linked_list_merge_sorted( &myList, &other, compare_myStructs );
+    TEST_ASSERT_TRUE( list_empty( &other ) );
+    uint32_t idx = 0, expected[] = {0,1,2,2,3,3,4,5,7,8};
+    myStruct_t * expected_nodes[] = {&node_F,&node_A,&node_B,&node_G,&node_C,&node_H,&node_D,&node_E,&node_I,&node_J};
+    ll_t *node;
+    list_for_each( node, &myList )
+    {
+        TEST_ASSERT_TRUE( node == &expected_nodes[idx]->node );
+        TEST_ASSERT_EQUAL_UINT32( expected[idx++], ((myStruct_t *)node)->data);
+    }
+    TEST_ASSERT_EQUAL( 10, idx );
+    node_F.data = 1, node_G.data = 2, node_H.data = 3, node_I.data = 4, node_J.data = 5;
+}
+
 void test_linked_list_find(void)
 {
     myStruct_t key = {.data = 4};
@@ -181,6 +465,38 @@ void test_linked_list_find_min(void)
     TEST_ASSERT_EQUAL_UINT32(node_A.data, found->data);
 }
 
+void test_linked_list_find_minmax(void)
+{
+    void * min, * max;
+    linked_list_find_minmax( &myList_unsorted, &min, &max, compare_myStructs );
+    TEST_ASSERT_TRUE(min == &node_F);
+    TEST_ASSERT_TRUE(max == &node_J);
+}
+
+void test_linked_list_find_minmax_empty_list(void)
+{
+    LIST_INIT(test_list);
+    void * min = &node_K, * max = &node_K;
+    linked_list_find_minmax( &test_list, &min, &max, compare_myStructs );
+    TEST_ASSERT_NULL(min);
+    TEST_ASSERT_NULL(max);
+}
+
+void test_linked_list_top_k(void)
+{
+    void * top[2];
+    int count = linked_list_top_k( &myList_unsorted, LEN_ARRAY(top), top, compare_myStructs );
+    TEST_ASSERT_EQUAL( 2, count );
+    TEST_ASSERT_TRUE(top[0] == &node_J);
+    TEST_ASSERT_TRUE(top[1] == &node_I);
+    uint32_t idx = 0, expected[] = {4,2,3,5,1};
+    ll_t *node;
+    list_for_each( node, &myList_unsorted )
+    {
+        TEST_ASSERT_EQUAL_UINT32( expected[idx++], ((myStruct_t *)node)->data);
+    }
+}
+
 void test_linked_list_count(void)
 {
     int count = linked_list_count( &myList, is_odd_myStruct );
@@ -320,6 +636,1516 @@ void test_linked_list_reverse(void)
     }
 }
 
+void test_ring_buffer_init_rejects_capacity_not_power_of_two(void)
+{
+    uint32_t storage[6];
+    ring_buffer_t rb;
+    TEST_ASSERT_FALSE( ring_buffer_init( &rb, storage, LEN_ARRAY(storage), sizeof(storage[0]) ) );
+}
+
+void test_ring_buffer_push_and_pop(void)
+{
+    uint32_t storage[4], out;
+    ring_buffer_t rb;
+    TEST_ASSERT_TRUE( ring_buffer_init( &rb, storage, LEN_ARRAY(storage), sizeof(storage[0]) ) );
+    TEST_ASSERT_FALSE( ring_buffer_pop( &rb, &out ) );
+    ARRAY_FOR_EACH(storage, idx) TEST_ASSERT_TRUE( ring_buffer_push( &rb, &actual[idx] ) );
+    TEST_ASSERT_TRUE( ring_buffer_is_full( &rb ) );
+    TEST_ASSERT_FALSE( ring_buffer_push( &rb, &actual[4] ) );
+    TEST_ASSERT_TRUE( ring_buffer_pop( &rb, &out ) );
+    TEST_ASSERT_EQUAL_UINT32( 1, out );
+    TEST_ASSERT_EQUAL( 3, ring_buffer_count( &rb ) );
+}
+
+void test_ring_buffer_push_n_and_pop_n_wrap_around(void)
+{
+    uint32_t storage[8], out[8];
+    uint32_t expected[] = {4,5,1,2,3,4,5};
+    ring_buffer_t rb;
+    ring_buffer_init( &rb, storage, LEN_ARRAY(storage), sizeof(storage[0]) );
+    TEST_ASSERT_EQUAL( 5, ring_buffer_push_n( &rb, actual, 5 ) );
+    TEST_ASSERT_EQUAL( 3, ring_buffer_pop_n( &rb, out, 3 ) );
+    TEST_ASSERT_EQUAL( 5, ring_buffer_push_n( &rb, actual, 5 ) );
+    TEST_ASSERT_EQUAL( 2, ring_buffer_peek_n( &rb, out, 2 ) );
+    TEST_ASSERT_EQUAL( 7, ring_buffer_pop_n( &rb, out, LEN_ARRAY(out) ) );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, out, LEN_ARRAY(expected));
+    TEST_ASSERT_TRUE( ring_buffer_is_empty( &rb ) );
+}
+
+void test_ring_buffer_push_n_stops_when_full(void)
+{
+    uint32_t storage[4], out[4];
+    uint32_t expected[] = {1,2,3,4};
+    ring_buffer_t rb;
+    ring_buffer_init( &rb, storage, LEN_ARRAY(storage), sizeof(storage[0]) );
+    TEST_ASSERT_EQUAL( 4, ring_buffer_spsc_push_n( &rb, actual, LEN_ARRAY(actual) ) );
+    TEST_ASSERT_EQUAL( 0, ring_buffer_spsc_push_n( &rb, actual, 1 ) );
+    TEST_ASSERT_EQUAL( 4, ring_buffer_spsc_pop_n( &rb, out, LEN_ARRAY(out) ) );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, out, LEN_ARRAY(expected));
+    TEST_ASSERT_EQUAL( 0, ring_buffer_spsc_pop_n( &rb, out, 1 ) );
+}
+
+void test_vector_push_back_grows_capacity(void)
+{
+    vector_t vec = VECTOR_INIT(sizeof(uint32_t));
+    for( uint32_t idx = 0; idx < 100; idx++ ) TEST_ASSERT_TRUE( vector_push_back( &vec, &idx ) );
+    TEST_ASSERT_EQUAL( 100, vec.len );
+    TEST_ASSERT_TRUE( vec.capacity >= 100 );
+    TEST_ASSERT_EQUAL_UINT32( 42, *(uint32_t *)vector_at( &vec, 42 ) );
+    TEST_ASSERT_NULL( vector_at( &vec, 100 ) );
+    TEST_ASSERT_TRUE( vector_shrink_to_fit( &vec ) );
+    TEST_ASSERT_EQUAL( 100, vec.capacity );
+    vector_free( &vec, NULL );
+    TEST_ASSERT_EQUAL( 0, vec.len );
+}
+
+void test_vector_append_n_and_find(void)
+{
+    vector_t vec = VECTOR_INIT(sizeof(uint32_t));
+    uint32_t key = 4, missing = 9;
+    TEST_ASSERT_TRUE( vector_reserve( &vec, 2 ) );
+    TEST_ASSERT_TRUE( vector_append_n( &vec, actual, LEN_ARRAY(actual) ) );
+    TEST_ASSERT_EQUAL( 3, vector_find( &key, &vec, compare_uint32 ) );
+    TEST_ASSERT_EQUAL( -1, vector_find( &missing, &vec, compare_uint32 ) );
+    TEST_ASSERT_EQUAL( 3, vector_count( &vec, is_odd ) );
+    vector_free( &vec, NULL );
+}
+
+void test_vector_insert_and_remove(void)
+{
+    vector_t vec = VECTOR_INIT(sizeof(uint32_t));
+    uint32_t elem_to_insert = 9, expected_inserted[] = {1,2,9,3,4,5}, expected_removed[] = {2,9,3,4,5};
+    vector_append_n( &vec, actual, LEN_ARRAY(actual) );
+    TEST_ASSERT_TRUE( vector_insert( &vec, 2, &elem_to_insert ) );
+    TEST_ASSERT_EQUAL( 6, vec.len );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY( expected_inserted, vec.data, vec.len );
+    TEST_ASSERT_FALSE( vector_insert( &vec, 7, &elem_to_insert ) );
+    vector_remove( &vec, 0, NULL );
+    TEST_ASSERT_EQUAL( 5, vec.len );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY( expected_removed, vec.data, vec.len );
+    vector_free( &vec, NULL );
+}
+
+void test_vector_filter_and_reverse(void)
+{
+    vector_t vec = VECTOR_INIT(sizeof(uint32_t));
+    uint32_t initial[] = {1,3,4,5,7,8,8,9}, expected[] = {9,7,5,3,1};
+    vector_append_n( &vec, initial, LEN_ARRAY(initial) );
+    TEST_ASSERT_EQUAL( 5, vector_filter( &vec, is_odd, NULL ) );
+    TEST_ASSERT_EQUAL( 5, vec.len );
+    vector_reverse( &vec );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY( expected, vec.data, vec.len );
+    vector_free( &vec, NULL );
+}
+
+void test_vector_sorted_insert(void)
+{
+    vector_t vec = VECTOR_INIT(sizeof(uint32_t));
+    uint32_t values[] = {5,1,4,2,3}, expected[] = {1,2,3,4,5};
+    ARRAY_FOR_EACH(values, idx) vector_sorted_insert( &vec, &values[idx], compare_uint32 );
+    TEST_ASSERT_EQUAL( 5, vec.len );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY( expected, vec.data, vec.len );
+    vector_free( &vec, NULL );
+}
+
+void test_array_save_and_open_mapped(void)
+{
+    uint32_t key = 4, missing = 6;
+    array_view_t view;
+    TEST_ASSERT_EQUAL( 0, array_save( "test_array_file.bin", actual, LEN_ARRAY(actual), sizeof(actual[0]), true ) );
+    TEST_ASSERT_EQUAL( 0, array_open_mapped( "test_array_file.bin", ARRAY_MAP_READ_ONLY, true, &view ) );
+    TEST_ASSERT_EQUAL( LEN_ARRAY(actual), view.num );
+    TEST_ASSERT_EQUAL( sizeof(actual[0]), view.size );
+    TEST_ASSERT_TRUE( view.sorted );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY( actual, view.base, view.num );
+    TEST_ASSERT_EQUAL( 3, array_find( &key, view.base, view.num, view.size, compare_uint32 ) );
+    TEST_ASSERT_EQUAL( 3, array_count( view.base, view.num, view.size, is_odd ) );
+    TEST_ASSERT_NULL( bsearch( &missing, view.base, view.num, view.size, compare_uint32 ) );
+    TEST_ASSERT_EQUAL( 0, array_close_mapped( &view ) );
+    remove( "test_array_file.bin" );
+}
+
+void test_array_open_mapped_copy_on_write_leaves_file_unchanged(void)
+{
+    array_view_t view;
+    array_save( "test_array_file.bin", actual, LEN_ARRAY(actual), sizeof(actual[0]), false );
+    TEST_ASSERT_EQUAL( 0, array_open_mapped( "test_array_file.bin", ARRAY_MAP_COPY_ON_WRITE, false, &view ) );
+    TEST_ASSERT_FALSE( view.sorted );
+    array_reverse( view.base, view.num, view.size );
+    TEST_ASSERT_EQUAL_UINT32( 5, ((uint32_t *)view.base)[0] );
+    array_close_mapped( &view );
+    TEST_ASSERT_EQUAL( 0, array_open_mapped( "test_array_file.bin", ARRAY_MAP_READ_ONLY, true, &view ) );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY( actual, view.base, view.num );
+    array_close_mapped( &view );
+    remove( "test_array_file.bin" );
+}
+
+void test_array_open_mapped_rejects_corrupted_file(void)
+{
+    array_view_t view;
+    uint32_t corrupted = 99;
+    array_save( "test_array_file.bin", actual, LEN_ARRAY(actual), sizeof(actual[0]), false );
+    FILE * file = fopen( "test_array_file.bin", "r+b" );
+    fseek( file, sizeof(array_file_header_t), SEEK_SET );
+    fwrite( &corrupted, sizeof(corrupted), 1, file );
+    fclose( file );
+    TEST_ASSERT_EQUAL( 0, array_open_mapped( "test_array_file.bin", ARRAY_MAP_READ_ONLY, false, &view ) );
+    array_close_mapped( &view );
+    TEST_ASSERT_EQUAL( -1, array_open_mapped( "test_array_file.bin", ARRAY_MAP_READ_ONLY, true, &view ) );
+    TEST_ASSERT_EQUAL( EIO, errno );
+
+    // A header whose offset to the data is past the end of the file
+    uint32_t header_size = 4096;
+    file = fopen( "test_array_file.bin", "r+b" );
+    fseek( file, offsetof(array_file_header_t, header_size), SEEK_SET );
+    fwrite( &header_size, sizeof(header_size), 1, file );
+    fclose( file );
+    TEST_ASSERT_EQUAL( -1, array_open_mapped( "test_array_file.bin", ARRAY_MAP_READ_ONLY, true, &view ) );
+    TEST_ASSERT_EQUAL( EIO, errno );
+
+    // A header whose "num * size" wraps around to fit in the file
+    array_save( "test_array_file.bin", actual, LEN_ARRAY(actual), sizeof(actual[0]), false );
+    uint64_t num = ( UINT64_MAX / sizeof(actual[0]) ) + 2;
+    file = fopen( "test_array_file.bin", "r+b" );
+    fseek( file, offsetof(array_file_header_t, num), SEEK_SET );
+    fwrite( &num, sizeof(num), 1, file );
+    fclose( file );
+    TEST_ASSERT_EQUAL( -1, array_open_mapped( "test_array_file.bin", ARRAY_MAP_READ_ONLY, true, &view ) );
+    TEST_ASSERT_EQUAL( EIO, errno );
+
+    remove( "test_array_file.bin" );
+    TEST_ASSERT_EQUAL( -1, array_open_mapped( "test_array_file.bin", ARRAY_MAP_READ_ONLY, false, &view ) );
+}
+
+typedef struct offset_myStruct_t
+{
+    oll_t       node;
+    uint32_t    data;
+} offset_myStruct_t;
+
+typedef struct offset_region_t
+{
+    oll_t               head;
+    offset_myStruct_t   nodes[5];
+} offset_region_t;
+
+static inline int compare_offset_myStructs( const void * item_one, const void * item_two )
+{
+    return ((offset_myStruct_t *)item_one)->data - ((offset_myStruct_t *)item_two)->data;
+}
+
+static inline bool is_odd_offset_myStruct( const void * item )
+{
+    return ((offset_myStruct_t *)item)->data % 2 == 1;
+}
+
+static void build_offset_region( offset_region_t * region, const uint32_t * values )
+{
+    memset( region, 0, sizeof(*region) );
+    ARRAY_FOR_EACH(region->nodes, idx)
+    {
+        region->nodes[idx].data = values[idx];
+        oll_add_tail( &region->nodes[idx].node, &region->head );
+    }
+}
+
+void test_offset_list_survives_relocation(void)
+{
+    offset_region_t original, * relocated = malloc( sizeof(offset_region_t) );
+    uint32_t values[] = {4,2,3,5,1};
+    build_offset_region( &original, values );
+    memcpy( relocated, &original, sizeof(original) );
+    memset( &original, 0xFF, sizeof(original) );
+    uint32_t idx = 0;
+    oll_t * node;
+    oll_for_each( node, &relocated->head )
+    {
+        TEST_ASSERT_TRUE( node == &relocated->nodes[idx].node );
+        TEST_ASSERT_EQUAL_UINT32( values[idx++], ((offset_myStruct_t *)node)->data );
+    }
+    TEST_ASSERT_EQUAL( 5, idx );
+    offset_myStruct_t key = {.data = 3};
+    TEST_ASSERT_TRUE( offset_list_find( &key, &relocated->head, compare_offset_myStructs ) == &relocated->nodes[2] );
+    TEST_ASSERT_EQUAL( 3, offset_list_count( &relocated->head, is_odd_offset_myStruct ) );
+    free( relocated );
+}
+
+void test_offset_list_zeroed_head_is_empty(void)
+{
+    offset_region_t region;
+    memset( &region, 0, sizeof(region) );
+    TEST_ASSERT_TRUE( oll_empty( &region.head ) );
+    oll_add( &region.nodes[0].node, &region.head );
+    TEST_ASSERT_FALSE( oll_empty( &region.head ) );
+    oll_del( &region.nodes[0].node );
+    TEST_ASSERT_TRUE( oll_empty( &region.head ) );
+}
+
+void test_offset_list_filter_in_place(void)
+{
+    offset_region_t region;
+    uint32_t values[] = {4,2,3,5,1}, expected_remaining[] = {3,5,1}, expected_removed[] = {4,2};
+    OLL_INIT(removed_nodes);
+    build_offset_region( &region, values );
+    TEST_ASSERT_EQUAL( 2, offset_list_filter_in_place( &region.head, &removed_nodes, is_odd_offset_myStruct ) );
+    uint32_t idx = 0;
+    oll_t * node;
+    oll_for_each( node, &region.head ) TEST_ASSERT_EQUAL_UINT32( expected_remaining[idx++], ((offset_myStruct_t *)node)->data );
+    TEST_ASSERT_EQUAL( 3, idx );
+    idx = 0;
+    oll_for_each( node, &removed_nodes ) TEST_ASSERT_EQUAL_UINT32( expected_removed[idx++], ((offset_myStruct_t *)node)->data );
+    TEST_ASSERT_EQUAL( 2, idx );
+}
+
+void test_offset_list_sort_and_reverse(void)
+{
+    offset_region_t region;
+    uint32_t values[] = {4,2,3,5,1}, expected_sorted[] = {1,2,3,4,5}, expected_reversed[] = {5,4,3,2,1};
+    build_offset_region( &region, values );
+    offset_list_sort( &region.head, compare_offset_myStructs );
+    uint32_t idx = 0;
+    oll_t * node;
+    oll_for_each( node, &region.head ) TEST_ASSERT_EQUAL_UINT32( expected_sorted[idx++], ((offset_myStruct_t *)node)->data );
+    TEST_ASSERT_EQUAL( 5, idx );
+    offset_list_reverse( &region.head );
+    idx = 0;
+    oll_for_each( node, &region.head ) TEST_ASSERT_EQUAL_UINT32( expected_reversed[idx++], ((offset_myStruct_t *)node)->data );
+    TEST_ASSERT_EQUAL( 5, idx );
+    TEST_ASSERT_TRUE( oll_prev( &region.head ) == &region.nodes[4].node );
+}
+
+void test_offset_list_sort_is_stable(void)
+{
+    offset_region_t region;
+    uint32_t values[] = {2,1,2,1,1}, expected_order[] = {1,3,4,0,2};
+    build_offset_region( &region, values );
+    offset_list_sort( &region.head, compare_offset_myStructs );
+    uint32_t idx = 0;
+    oll_t * node;
+    oll_for_each( node, &region.head ) TEST_ASSERT_TRUE( node == &region.nodes[expected_order[idx++]].node );
+    TEST_ASSERT_EQUAL( 5, idx );
+    for( node = oll_prev( &region.head ); node != &region.head; node = oll_prev( node ) ) TEST_ASSERT_TRUE( node == &region.nodes[expected_order[--idx]].node );
+    TEST_ASSERT_EQUAL( 0, idx );
+}
+
+void test_offset_list_sorted_insert(void)
+{
+    offset_region_t region;
+    uint32_t values[] = {4,2,3,5,1}, expected[] = {1,2,3,4,5};
+    memset( &region, 0, sizeof(region) );
+    ARRAY_FOR_EACH(region.nodes, idx)
+    {
+        region.nodes[idx].data = values[idx];
+        offset_list_sorted_insert( &region.head, &region.nodes[idx].node, compare_offset_myStructs );
+    }
+    uint32_t idx = 0;
+    oll_t * node;
+    oll_for_each( node, &region.head ) TEST_ASSERT_EQUAL_UINT32( expected[idx++], ((offset_myStruct_t *)node)->data );
+    TEST_ASSERT_EQUAL( 5, idx );
+}
+
+typedef struct memory_stream_t
+{
+    uint8_t *   data;
+    size_t      length;
+    size_t      position;
+    size_t      max_read;
+} memory_stream_t;
+
+static ssize_t read_memory_stream( void * context, void * buffer, size_t count )
+{
+    memory_stream_t * stream = context;
+    if( count > stream->max_read ) count = stream->max_read;
+    if( count > stream->length - stream->position ) count = stream->length - stream->position;
+    memcpy( buffer, stream->data + stream->position, count );
+    stream->position += count;
+    return count;
+}
+
+static ssize_t write_memory_stream( void * context, const void * buffer, size_t count )
+{
+    memory_stream_t * stream = context;
+    if( count > stream->max_read ) count = stream->max_read;
+    memcpy( stream->data + stream->position, buffer, count );
+    stream->position += count;
+    return count;
+}
+
+void test_stream_count_handles_records_split_across_chunks(void)
+{
+    uint32_t values[1000];
+    ARRAY_FOR_EACH(values, idx) values[idx] = idx;
+    memory_stream_t input = { (uint8_t *)values, sizeof(values), 0, 7 };
+    stream_reader_t reader = { read_memory_stream, &input, 10, false };
+    TEST_ASSERT_EQUAL( 500, stream_count( &reader, sizeof(values[0]), is_odd ) );
+    input.position = 0;
+    reader.overlap = true;
+    TEST_ASSERT_EQUAL( 500, stream_count( &reader, sizeof(values[0]), is_odd ) );
+}
+
+void test_stream_find(void)
+{
+    uint32_t values[1000], found = 0, key = 777, missing = 1000;
+    ARRAY_FOR_EACH(values, idx) values[idx] = idx;
+    memory_stream_t input = { (uint8_t *)values, sizeof(values), 0, 64 };
+    stream_reader_t reader = { read_memory_stream, &input, 30, true };
+    TEST_ASSERT_EQUAL( 777, stream_find( &key, &reader, sizeof(values[0]), &found, compare_uint32 ) );
+    TEST_ASSERT_EQUAL_UINT32( 777, found );
+    input.position = 0;
+    TEST_ASSERT_EQUAL( -1, stream_find( &missing, &reader, sizeof(values[0]), NULL, compare_uint32 ) );
+}
+
+void test_stream_filter(void)
+{
+    uint32_t values[1000], filtered[1000];
+    ARRAY_FOR_EACH(values, idx) values[idx] = idx;
+    memory_stream_t input = { (uint8_t *)values, sizeof(values), 0, 13 };
+    memory_stream_t output = { (uint8_t *)filtered, sizeof(filtered), 0, 5 };
+    stream_reader_t reader = { read_memory_stream, &input, 64, true };
+    TEST_ASSERT_EQUAL( 500, stream_filter( &reader, sizeof(values[0]), is_odd, write_memory_stream, &output ) );
+    TEST_ASSERT_EQUAL( 500 * sizeof(uint32_t), output.position );
+    ARRAY_FOR_EACH(values, idx)
+    {
+        if( idx < 500 ) TEST_ASSERT_EQUAL_UINT32( 2 * idx + 1, filtered[idx] );
+    }
+}
+
+void test_stream_count_reports_truncated_record(void)
+{
+    memory_stream_t input = { (uint8_t *)actual, sizeof(actual) - 1, 0, 64 };
+    stream_reader_t reader = { read_memory_stream, &input, 8, false };
+    TEST_ASSERT_EQUAL( -1, stream_count( &reader, sizeof(actual[0]), is_odd ) );
+    TEST_ASSERT_EQUAL( EINVAL, errno );
+}
+
+static void check_pool_list( const pool_list_t * list, const uint32_t * expected, uint32_t num )
+{
+    uint32_t idx, position = 0;
+    pool_list_for_each( idx, list )
+    {
+        TEST_ASSERT_EQUAL_UINT32( expected[position++], *(uint32_t *)pool_list_elem( list, idx ) );
+    }
+    TEST_ASSERT_EQUAL( num, position );
+    TEST_ASSERT_EQUAL( num, list->count );
+}
+
+void test_pool_list_push_back_find_and_count(void)
+{
+    pool_list_t list;
+    uint32_t key = 3, missing = 9;
+    TEST_ASSERT_TRUE( pool_list_init( &list, sizeof(uint32_t), 5 ) );
+    ARRAY_FOR_EACH(actual, idx) TEST_ASSERT_EQUAL( idx + 1, pool_list_push_back( &list, &actual[idx] ) );
+    TEST_ASSERT_EQUAL( POOL_LIST_NONE, pool_list_push_back( &list, &key ) );
+    check_pool_list( &list, actual, LEN_ARRAY(actual) );
+    TEST_ASSERT_EQUAL( 3, pool_list_find( &key, &list, compare_uint32 ) );
+    TEST_ASSERT_EQUAL( POOL_LIST_HEAD, pool_list_find( &missing, &list, compare_uint32 ) );
+    TEST_ASSERT_EQUAL( 3, pool_list_count( &list, is_odd ) );
+    pool_list_free( &list, NULL );
+}
+
+void test_pool_list_filter_in_place_reuses_nodes(void)
+{
+    pool_list_t list;
+    uint32_t expected[] = {1,3,5,6}, six = 6;
+    pool_list_init( &list, sizeof(uint32_t), 5 );
+    ARRAY_FOR_EACH(actual, idx) pool_list_push_back( &list, &actual[idx] );
+    TEST_ASSERT_EQUAL( 2, pool_list_filter_in_place( &list, is_odd, NULL ) );
+    check_pool_list( &list, expected, 3 );
+    uint32_t idx = pool_list_push_back( &list, &six );
+    TEST_ASSERT_TRUE( idx == 2 || idx == 4 );
+    check_pool_list( &list, expected, 4 );
+    pool_list_free( &list, NULL );
+}
+
+void test_pool_list_sort_reverse_and_compact(void)
+{
+    pool_list_t list;
+    uint32_t values[] = {4,2,3,5,1,3}, expected_sorted[] = {1,2,3,3,4,5}, expected_reversed[] = {5,4,3,3,2,1};
+    pool_list_init( &list, sizeof(uint32_t), 10 );
+    ARRAY_FOR_EACH(values, idx) pool_list_push_back( &list, &values[idx] );
+    pool_list_sort( &list, compare_uint32 );
+    check_pool_list( &list, expected_sorted, LEN_ARRAY(expected_sorted) );
+    TEST_ASSERT_EQUAL( 3, pool_list_next( &list, pool_list_next( &list, pool_list_next( &list, POOL_LIST_HEAD ) ) ) );
+    pool_list_reverse( &list );
+    check_pool_list( &list, expected_reversed, LEN_ARRAY(expected_reversed) );
+    TEST_ASSERT_TRUE( pool_list_compact( &list ) );
+    check_pool_list( &list, expected_reversed, LEN_ARRAY(expected_reversed) );
+    uint32_t idx, position = 1;
+    pool_list_for_each( idx, &list ) TEST_ASSERT_EQUAL( position++, idx );
+    TEST_ASSERT_EQUAL( 6, pool_list_prev( &list, POOL_LIST_HEAD ) );
+    pool_list_free( &list, NULL );
+}
+
+void test_pool_list_sorted_insert(void)
+{
+    pool_list_t list;
+    uint32_t values[] = {4,2,3,5,1}, expected[] = {1,2,3,4,5};
+    pool_list_init( &list, sizeof(uint32_t), 5 );
+    ARRAY_FOR_EACH(values, idx)
+    {
+        uint32_t node = pool_list_alloc( &list );
+        *(uint32_t *)pool_list_elem( &list, node ) = values[idx];
+        pool_list_sorted_insert( &list, node, compare_uint32 );
+    }
+    check_pool_list( &list, expected, LEN_ARRAY(expected) );
+    pool_list_free( &list, NULL );
+}
+
+void test_array_sort_small_u32_every_length(void)
+{
+    uint32_t values[ARRAY_SORT_SMALL_MAX + 2], expected[ARRAY_SORT_SMALL_MAX + 2];
+    uint32_t state = 12345;
+    for( size_t num = 0; num <= ARRAY_SORT_SMALL_MAX + 1; num++ )
+    {
+        for( int trial = 0; trial < 20; trial++ )
+        {
+            for( size_t idx = 0; idx < num; idx++ )
+            {
+                state = state * 1103515245 + 12345;
+                values[idx] = expected[idx] = ( state >> 16 ) % 16;
+            }
+            qsort( expected, num, sizeof(uint32_t), compare_uint32 );
+            array_sort_small_u32( values, num );
+            if( num > 0 ) TEST_ASSERT_EQUAL_UINT32_ARRAY( expected, values, num );
+        }
+    }
+}
+
+void test_array_sort_small_signed_and_floating_point(void)
+{
+    int32_t ints[] = {3, -7, 0, 2147483647, -2147483647 - 1, 5, -1};
+    int32_t expected_ints[] = {-2147483647 - 1, -7, -1, 0, 3, 5, 2147483647};
+    double doubles[] = {2.5, -1.0, 0.0, 1e300, -1e-300, 2.5};
+    double expected_doubles[] = {-1.0, -1e-300, 0.0, 2.5, 2.5, 1e300};
+    array_sort_small_i32( ints, LEN_ARRAY(ints) );
+    array_sort_small_double( doubles, LEN_ARRAY(doubles) );
+    TEST_ASSERT_EQUAL_INT32_ARRAY( expected_ints, ints, LEN_ARRAY(ints) );
+    ARRAY_FOR_EACH(doubles, idx) TEST_ASSERT_TRUE( expected_doubles[idx] == doubles[idx] );
+}
+
+void test_array_sort_small_with_compare(void)
+{
+    myStruct_t structs[] = { {.data = 4}, {.data = 2}, {.data = 3}, {.data = 5}, {.data = 1} };
+    array_sort_small( structs, LEN_ARRAY(structs), sizeof(myStruct_t), compare_myStructs );
+    ARRAY_FOR_EACH(structs, idx) TEST_ASSERT_EQUAL( actual[idx], structs[idx].data );
+}
+
+static uint64_t key_of_myStruct( const void * elem )
+{
+    return ((myStruct_t *)elem)->data;
+}
+
+static uint64_t key_of_keyed( const void * elem )
+{
+    return ((keyed_t *)elem)->key;
+}
+
+void test_linked_list_radix_sort(void)
+{
+    ll_t *node, *prev = &myList_unsorted;
+    uint32_t idx = 0;
+    TEST_ASSERT_TRUE( linked_list_radix_sort( &myList_unsorted, key_of_myStruct ) );
+    list_for_each( node, &myList_unsorted )
+    {
+        TEST_ASSERT_EQUAL_UINT32( actual[idx++], ((myStruct_t *)node)->data );
+        TEST_ASSERT_EQUAL_PTR( prev, node->prev );
+        prev = node;
+    }
+    TEST_ASSERT_EQUAL( 5, idx );
+    TEST_ASSERT_EQUAL_PTR( prev, myList_unsorted.prev );
+}
+
+void test_array_radix_sort_is_stable(void)
+{
+    keyed_t values[500];
+    uint32_t state = 7;
+    for( uint32_t idx = 0; idx < LEN_ARRAY(values); idx++ )
+    {
+        state = state * 1103515245 + 12345;
+        values[idx].key = ( state >> 8 ) % 1000 * 0x10001;    // Differs in more than one byte
+        values[idx].order = idx;
+    }
+    TEST_ASSERT_TRUE( array_radix_sort( values, LEN_ARRAY(values), sizeof(values[0]), key_of_keyed ) );
+    check_stable_sort( values, LEN_ARRAY(values) );
+}
+
+void test_radix_keys_preserve_order(void)
+{
+    int64_t ints[] = { INT64_MIN, -5, -1, 0, 1, INT64_MAX };
+    double doubles[] = { -1e300, -2.5, -0.0, 0.0, 1e-300, 3.0 };
+    for( size_t idx = 1; idx < LEN_ARRAY(ints); idx++ )
+    {
+        TEST_ASSERT_TRUE( radix_key_from_int64( ints[idx - 1] ) < radix_key_from_int64( ints[idx] ) );
+        TEST_ASSERT_TRUE( radix_key_from_double( doubles[idx - 1] ) < radix_key_from_double( doubles[idx] ) );
+    }
+}
+
+void test_linked_list_merge_sort(void)
+{
+    ll_t *node;
+    uint32_t idx = 0;
+    linked_list_merge_sort( &myList_unsorted, compare_myStructs );
+    list_for_each( node, &myList_unsorted )
+    {
+        TEST_ASSERT_EQUAL_UINT32( actual[idx++], ((myStruct_t *)node)->data );
+    }
+    TEST_ASSERT_EQUAL( 5, idx );
+}
+
+void test_array_sort_par_is_stable(void)
+{
+    size_t num = 4 * SORT_PAR_MIN_CHUNK + 123;
+    keyed_t * values = malloc( num * sizeof(keyed_t) );
+    uint32_t state = 99;
+    for( uint32_t idx = 0; idx < num; idx++ )
+    {
+        state = state * 1103515245 + 12345;
+        values[idx].key = ( state >> 16 ) % 5000;
+        values[idx].order = idx;
+    }
+    TEST_ASSERT_TRUE( array_sort_par( values, num, sizeof(keyed_t), compare_keyed, 4 ) );
+    check_stable_sort( values, num );
+    free( values );
+}
+
+void test_linked_list_sort_par(void)
+{
+    size_t num = 3 * SORT_PAR_MIN_CHUNK + 7;
+    myStruct_t * nodes = malloc( num * sizeof(myStruct_t) );
+    LIST_INIT(test_list);
+    ll_t *node;
+    uint32_t state = 5, count = 0, last = 0;
+    for( size_t idx = 0; idx < num; idx++ )
+    {
+        state = state * 1103515245 + 12345;
+        nodes[idx].data = state >> 8;
+        list_add_tail( &nodes[idx].node, &test_list );
+    }
+    linked_list_sort_par( &test_list, compare_myStructs, 3 );
+    list_for_each( node, &test_list )
+    {
+        TEST_ASSERT_TRUE( last <= ((myStruct_t *)node)->data );
+        TEST_ASSERT_EQUAL_PTR( node, node->next->prev );
+        last = ((myStruct_t *)node)->data;
+        count++;
+    }
+    TEST_ASSERT_EQUAL( num, count );
+    free( nodes );
+}
+
+void test_linked_list_count_and_find_par(void)
+{
+    list_segments_t segments;
+    myStruct_t key = {.data = 4}, missing = {.data = 9};
+    TEST_ASSERT_TRUE( list_segments_build( &segments, &myList, 2 ) );
+    TEST_ASSERT_EQUAL( 3, segments.num_segments );
+    TEST_ASSERT_EQUAL( 3, linked_list_count_par( &segments, is_odd_myStruct, 3 ) );
+    TEST_ASSERT_EQUAL_PTR( &node_D, linked_list_find_par( &key, &segments, compare_myStructs, 3 ) );
+    TEST_ASSERT_NULL( linked_list_find_par( &missing, &segments, compare_myStructs, 2 ) );
+    list_segments_free( &segments );
+}
+
+void test_linked_list_count_par_sees_nodes_added_after_build(void)
+{
+    list_segments_t segments;
+    list_segments_build( &segments, &myList, 2 );
+    node_K.data = 7;
+    node_L.data = 9;
+    list_add( &node_K.node, &myList );
+    list_add_tail( &node_L.node, &myList );
+    TEST_ASSERT_EQUAL( 5, linked_list_count_par( &segments, is_odd_myStruct, 2 ) );
+    list_segments_free( &segments );
+}
+
+void test_linked_list_filter_in_place_par(void)
+{
+    list_segments_t segments;
+    LIST_INIT(removed);
+    ll_t *node;
+    uint32_t idx = 0, expected[] = {1,3,5}, expected_removed[] = {2,4};
+    list_segments_build( &segments, &myList, 1 );
+    TEST_ASSERT_EQUAL( 2, linked_list_filter_in_place_par( &segments, &removed, is_odd_myStruct, 3 ) );
+    list_for_each( node, &myList ) TEST_ASSERT_EQUAL_UINT32( expected[idx++], ((myStruct_t *)node)->data );
+    TEST_ASSERT_EQUAL( 3, idx );
+    idx = 0;
+    list_for_each( node, &removed ) TEST_ASSERT_EQUAL_UINT32( expected_removed[idx++], ((myStruct_t *)node)->data );
+    TEST_ASSERT_EQUAL( 2, idx );
+    TEST_ASSERT_EQUAL( 3, segments.num_segments );
+    TEST_ASSERT_EQUAL( 3, linked_list_count_par( &segments, is_odd_myStruct, 3 ) );
+    list_segments_free( &segments );
+}
+
+void test_linked_list_filter_in_place_par_without_removed_list(void)
+{
+    list_segments_t segments;
+    ll_t *node;
+    uint32_t idx = 0, expected[] = {1,3,5};
+    list_segments_build( &segments, &myList, 1 );
+    TEST_ASSERT_EQUAL( 2, linked_list_filter_in_place_par( &segments, NULL, is_odd_myStruct, 3 ) );
+    list_for_each( node, &myList ) TEST_ASSERT_EQUAL_UINT32( expected[idx++], ((myStruct_t *)node)->data );
+    TEST_ASSERT_EQUAL( 3, idx );
+    // Like "linked_list_filter_in_place", the removed nodes are unlinked, not left pointing at anything
+    TEST_ASSERT_NULL( node_B.node.next );
+    TEST_ASSERT_NULL( node_B.node.prev );
+    TEST_ASSERT_NULL( node_D.node.next );
+    TEST_ASSERT_NULL( node_D.node.prev );
+    list_segments_free( &segments );
+}
+
+void test_tlist_sort_is_stable_and_relinks_prev(void)
+{
+    TLIST(keyed_t, items);
+    keyed_t sorted[300];
+    size_t idx = 0;
+    for( uint32_t order = 0; order < LEN_ARRAY(sorted); order++ ) TLISTPUSHBACK( items, ((keyed_t){ ( order * 7919u ) % 13, order }) );
+    TLISTSORT( a, b, items, a->_data.key < b->_data.key );
+    TLISTFOREACH( i, items, ({ sorted[idx++] = i->_data; }) );
+    TEST_ASSERT_EQUAL( LEN_ARRAY(sorted), idx );
+    check_stable_sort( sorted, LEN_ARRAY(sorted) );
+    TLISTREVERSE( items );
+    TLISTFOREACH( i, items, ({ TEST_ASSERT_EQUAL_UINT32( sorted[--idx].order, i->_data.order ); TEST_ASSERT_TRUE( i->_prev->_next == i ); }) );
+    TEST_ASSERT_EQUAL( 0, idx );
+    TLISTCLEAR( items );
+}
+
+void test_tlist_filter_and_count(void)
+{
+    TLIST(int, numbers);
+    int idx = 0, expected[] = {1,3,5};
+    for( int value = 1; value <= 5; value++ ) TLISTPUSHBACK( numbers, value );
+    TEST_ASSERT_EQUAL( 3, TLISTCOUNT( i, numbers, i->_data & 1 ) );
+    TEST_ASSERT_EQUAL( 2, TLISTFILTER( i, numbers, i->_data & 1 ) );
+    TLISTFOREACH( i, numbers, ({ TEST_ASSERT_EQUAL( expected[idx++], i->_data ); }) );
+    TEST_ASSERT_EQUAL( 3, idx );
+    TEST_ASSERT_EQUAL( 0, TLISTFILTER( i, numbers, i->_data & 1 ) );
+    TEST_ASSERT_EQUAL( 3, TLISTFILTER( i, numbers, i->_data > 5 ) );
+    TEST_ASSERT_EQUAL( 0, TLISTSIZE( numbers ) );
+}
+
+void test_tlist_minmax_and_sorted_insert(void)
+{
+    TLIST(int, numbers);
+    TLISTITER(numbers) min, max;
+    int idx = 0, unsorted[] = {4,2,3,5,1,6}, expected[] = {1,2,3,4,5,6};
+    TLISTMINMAX( a, b, numbers, a->_data < b->_data, min, max );
+    TEST_ASSERT_TRUE( min == TLISTEND(numbers) && max == TLISTEND(numbers) );
+    ARRAY_FOR_EACH( unsorted, pos ) TEST_ASSERT_NOT_NULL( TLISTSORTEDINSERT( a, b, numbers, a->_data < b->_data, unsorted[pos] ) );
+    TLISTFOREACH( i, numbers, ({ TEST_ASSERT_EQUAL( expected[idx++], i->_data ); }) );
+    TEST_ASSERT_EQUAL( 6, idx );
+    TLISTREVERSE( numbers );
+    TLISTMINMAX( a, b, numbers, a->_data < b->_data, min, max );
+    TEST_ASSERT_EQUAL( 1, min->_data );
+    TEST_ASSERT_EQUAL( 6, max->_data );
+    TLISTERASE( min );
+    TLISTMINMAX( a, b, numbers, a->_data < b->_data, min, max );
+    TEST_ASSERT_EQUAL( 2, min->_data );
+    TEST_ASSERT_EQUAL( 6, max->_data );
+    TLISTCLEAR( numbers );
+}
+
+static uint64_t lru_evicted[16];
+static size_t lru_num_evicted;
+
+static void record_eviction( lru_node_t * node, void * context )
+{
+    lru_evicted[lru_num_evicted++] = node->key;
+    (*(int *)context)++;
+}
+
+void test_lru_cache_evicts_least_recently_used(void)
+{
+    lru_cache_t cache;
+    lru_node_t nodes[4] = { { .key = 1 }, { .key = 2 }, { .key = 3 }, { .key = 4 } };
+    uint64_t expected[] = {4,1,3};
+    int evictions = 0;
+    size_t idx = 0;
+    ll_t * node;
+    lru_num_evicted = 0;
+    TEST_ASSERT_TRUE( lru_cache_init( &cache, 3, record_eviction, &evictions ) );
+    for( int pos = 0; pos < 3; pos++ ) lru_cache_put( &cache, &nodes[pos] );
+    TEST_ASSERT_EQUAL_PTR( &nodes[0], lru_cache_get( &cache, 1 ) );
+    lru_cache_put( &cache, &nodes[3] );
+    TEST_ASSERT_EQUAL( 1, evictions );
+    TEST_ASSERT_EQUAL_UINT64( 2, lru_evicted[0] );
+    TEST_ASSERT_NULL( lru_cache_get( &cache, 2 ) );
+    TEST_ASSERT_EQUAL( 3, cache.count );
+    list_for_each( node, &cache.recency ) TEST_ASSERT_EQUAL_UINT64( expected[idx++], ((lru_node_t *)node)->key );
+    TEST_ASSERT_EQUAL( 3, idx );
+    TEST_ASSERT_EQUAL_PTR( &nodes[2], lru_cache_peek( &cache, 3 ) );
+    TEST_ASSERT_EQUAL_PTR( &nodes[2], cache.recency.prev );
+    TEST_ASSERT_TRUE( lru_cache_evict( &cache ) );
+    TEST_ASSERT_EQUAL_UINT64( 3, lru_evicted[1] );
+    lru_cache_free( &cache );
+    TEST_ASSERT_EQUAL( 4, evictions );
+    TEST_ASSERT_EQUAL_UINT64( 1, lru_evicted[2] );
+    TEST_ASSERT_EQUAL_UINT64( 4, lru_evicted[3] );
+}
+
+void test_lru_cache_put_replaces_and_remove_keeps_table_consistent(void)
+{
+    lru_cache_t cache;
+    static lru_node_t nodes[1000];
+    lru_node_t first = { .key = 7 }, second = { .key = 7 };
+    int evictions = 0;
+    lru_num_evicted = 0;
+    TEST_ASSERT_TRUE( lru_cache_init( &cache, LEN_ARRAY(nodes), record_eviction, &evictions ) );
+    lru_cache_put( &cache, &first );
+    lru_cache_put( &cache, &second );
+    TEST_ASSERT_EQUAL( 1, evictions );
+    TEST_ASSERT_EQUAL( 1, cache.count );
+    TEST_ASSERT_EQUAL_PTR( &second, lru_cache_remove( &cache, 7 ) );
+    TEST_ASSERT_NULL( lru_cache_remove( &cache, 7 ) );
+    TEST_ASSERT_EQUAL( 0, cache.count );
+
+    // Removing keys shifts others back in the table; every key still cached must stay reachable.
+    //
+    for( size_t idx = 0; idx < LEN_ARRAY(nodes); idx++ )
+    {
+        nodes[idx].key = idx * 0x10000;
+        lru_cache_put( &cache, &nodes[idx] );
+    }
+    for( size_t idx = 0; idx < LEN_ARRAY(nodes); idx += 3 ) TEST_ASSERT_EQUAL_PTR( &nodes[idx], lru_cache_remove( &cache, idx * 0x10000 ) );
+    for( size_t idx = 0; idx < LEN_ARRAY(nodes); idx++ )
+    {
+        TEST_ASSERT_EQUAL_PTR( idx % 3 ? &nodes[idx] : NULL, lru_cache_peek( &cache, idx * 0x10000 ) );
+    }
+    TEST_ASSERT_EQUAL( LEN_ARRAY(nodes) - 334, cache.count );
+    TEST_ASSERT_EQUAL( 1, evictions );
+    cache.evict = NULL;
+    lru_cache_free( &cache );
+}
+
+static void copy_lru_key( lru_node_t * node, void * context )
+{
+    *(uint64_t *)context = node->key;
+}
+
+void test_lru_sharded(void)
+{
+    lru_sharded_t sharded;
+    lru_node_t nodes[64];
+    uint64_t key = 0;
+    int evictions = 0;
+    TEST_ASSERT_TRUE( lru_sharded_init( &sharded, 3, 256, record_eviction, &evictions ) );
+    TEST_ASSERT_EQUAL( 4, sharded.num_shards );
+    for( size_t idx = 0; idx < LEN_ARRAY(nodes); idx++ )
+    {
+        nodes[idx].key = idx + 100;
+        lru_sharded_put( &sharded, &nodes[idx] );
+    }
+    TEST_ASSERT_TRUE( lru_sharded_get( &sharded, 150, copy_lru_key, &key ) );
+    TEST_ASSERT_EQUAL_UINT64( 150, key );
+    TEST_ASSERT_FALSE( lru_sharded_get( &sharded, 99, copy_lru_key, &key ) );
+    TEST_ASSERT_EQUAL_PTR( &nodes[50], lru_sharded_remove( &sharded, 150 ) );
+    TEST_ASSERT_FALSE( lru_sharded_get( &sharded, 150, NULL, NULL ) );
+    TEST_ASSERT_EQUAL( 0, evictions );
+    for( size_t idx = 0; idx < sharded.num_shards; idx++ ) sharded.shards[idx].cache.evict = NULL;
+    lru_sharded_free( &sharded );
+}
+
+void test_array_heap_push_pop_and_update(void)
+{
+    uint32_t heap[10], values[] = {5,3,8,1,9,2,7,4,6,0}, top;
+    size_t num = 0;
+    ARRAY_FOR_EACH( values, idx ) num = array_heap_push( heap, num, sizeof(heap[0]), &values[idx], compare_uint32 );
+    TEST_ASSERT_EQUAL( 10, num );
+    TEST_ASSERT_EQUAL_UINT32( 0, heap[0] );
+
+    // Raising the root sends it to the bottom; lowering a leaf brings it to the top.
+    //
+    heap[0] = 20;
+    array_heap_update( heap, num, sizeof(heap[0]), 0, compare_uint32 );
+    TEST_ASSERT_EQUAL_UINT32( 1, heap[0] );
+    uint32_t nine = 9;
+    int pos = array_find( &nine, heap, num, sizeof(heap[0]), compare_uint32 );
+    heap[pos] = 0;
+    TEST_ASSERT_EQUAL( 0, array_heap_update( heap, num, sizeof(heap[0]), pos, compare_uint32 ) );
+
+    uint32_t expected[] = {0,1,2,3,4,5,6,7,8,20};
+    ARRAY_FOR_EACH( expected, idx )
+    {
+        num = array_heap_pop( heap, num, sizeof(heap[0]), &top, compare_uint32 );
+        TEST_ASSERT_EQUAL_UINT32( expected[idx], top );
+    }
+    TEST_ASSERT_EQUAL( 0, num );
+    TEST_ASSERT_EQUAL( 0, array_heap_pop( heap, num, sizeof(heap[0]), &top, compare_uint32 ) );
+}
+
+void test_array_heap4_heapify_and_update(void)
+{
+    uint32_t heap[300], top, last = 0;
+    size_t num = 200;
+    for( size_t idx = 0; idx < num; idx++ ) heap[idx] = ( idx * 7919u ) % 1000;
+    array_heapify4( heap, num, sizeof(heap[0]), compare_uint32 );
+    for( size_t idx = 1; idx < num; idx++ ) TEST_ASSERT_TRUE( heap[( idx - 1 ) / 4] <= heap[idx] );
+    for( size_t idx = 0; idx < num; idx += 17 )
+    {
+        heap[idx] = ( heap[idx] * 31u ) % 1000;
+        array_heap4_update( heap, num, sizeof(heap[0]), idx, compare_uint32 );
+    }
+    for( uint32_t value = 0; value < 100; value++ ) num = array_heap4_push( heap, num, sizeof(heap[0]), &value, compare_uint32 );
+    TEST_ASSERT_EQUAL( 300, num );
+    while( num > 0 )
+    {
+        num = array_heap4_pop( heap, num, sizeof(heap[0]), &top, compare_uint32 );
+        TEST_ASSERT_TRUE( top >= last );
+        last = top;
+    }
+}
+
+typedef struct heap_item_t
+{
+    pairing_node_t  node;
+    uint32_t        key;
+} heap_item_t;
+
+static int compare_heap_items( const void * item_one, const void * item_two )
+{
+    return (int)((heap_item_t *)item_one)->key - (int)((heap_item_t *)item_two)->key;
+}
+
+void test_pairing_heap(void)
+{
+    pairing_heap_t heap, other;
+    heap_item_t items[100];
+    uint32_t last = 0;
+    size_t popped = 0;
+    pairing_heap_init( &heap );
+    pairing_heap_init( &other );
+    TEST_ASSERT_NULL( pairing_heap_pop( &heap, compare_heap_items ) );
+    for( size_t idx = 0; idx < LEN_ARRAY(items); idx++ )
+    {
+        items[idx].key = 1000 + ( idx * 37 ) % 100;
+        pairing_heap_push( idx % 2 ? &heap : &other, &items[idx].node, compare_heap_items );
+    }
+    pairing_node_t * node = pairing_heap_pop( &heap, compare_heap_items );     // Builds some structure below the root
+    TEST_ASSERT_EQUAL_PTR( &items[73].node, node );
+    pairing_heap_push( &heap, node, compare_heap_items );
+    pairing_heap_meld( &heap, &other, compare_heap_items );
+    TEST_ASSERT_EQUAL( 100, heap.count );
+    TEST_ASSERT_TRUE( pairing_heap_empty( &other ) );
+
+    items[42].key = 5;
+    pairing_heap_decrease( &heap, &items[42].node, compare_heap_items );
+    TEST_ASSERT_EQUAL_PTR( &items[42].node, pairing_heap_top( &heap ) );
+    pairing_heap_remove( &heap, &items[7].node, compare_heap_items );
+    pairing_heap_remove( &heap, &items[42].node, compare_heap_items );
+    TEST_ASSERT_EQUAL( 98, heap.count );
+
+    for( heap_item_t * item; ( item = (heap_item_t *)pairing_heap_pop( &heap, compare_heap_items ) ); popped++ )
+    {
+        TEST_ASSERT_TRUE( item->key >= last );
+        TEST_ASSERT_TRUE( item != &items[7] && item != &items[42] );
+        last = item->key;
+    }
+    TEST_ASSERT_EQUAL( 98, popped );
+    TEST_ASSERT_EQUAL( 0, heap.count );
+}
+
+void test_timer_wheel_expires_timers_on_their_tick(void)
+{
+    static timer_wheel_t wheel;
+    timer_node_t timers[500];
+    uint64_t state = 1, now = 1000;
+    size_t expired_count = 0;
+    LIST_INIT(expired);
+    timer_wheel_init( &wheel, now );
+    for( size_t idx = 0; idx < LEN_ARRAY(timers); idx++ )
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        timer_init( &timers[idx] );
+        timer_wheel_arm( &wheel, &timers[idx], now + ( state >> 33 ) % 300000 );       // Spans three levels
+    }
+
+    // Steps of varying length, so that some advances cross cascades and some don't.
+    //
+    while( expired_count < LEN_ARRAY(timers) )
+    {
+        uint64_t previous = now;
+        now += 1 + now % 997;
+        timer_wheel_advance( &wheel, now, &expired );
+        while( !list_empty( &expired ) )
+        {
+            timer_node_t * timer = (timer_node_t *)expired.next;
+            TEST_ASSERT_TRUE( timer->expires > previous && timer->expires <= now );
+            list_del( &timer->list );
+            TEST_ASSERT_FALSE( timer_pending( timer ) );
+            expired_count++;
+        }
+        TEST_ASSERT_TRUE( now < 1000 + 400000 );
+    }
+}
+
+void test_timer_wheel_cancel_and_rearm(void)
+{
+    static timer_wheel_t wheel;
+    timer_node_t one, two, three;
+    LIST_INIT(expired);
+    timer_wheel_init( &wheel, 50 );
+    timer_init( &one );
+    timer_init( &two );
+    timer_init( &three );
+    TEST_ASSERT_FALSE( timer_wheel_cancel( &one ) );
+    timer_wheel_arm( &wheel, &one, 60 );
+    timer_wheel_arm( &wheel, &two, 60 );
+    timer_wheel_arm( &wheel, &three, 5000 );
+    TEST_ASSERT_TRUE( timer_wheel_cancel( &two ) );
+    TEST_ASSERT_FALSE( timer_pending( &two ) );
+    timer_wheel_arm( &wheel, &three, 55 );                  // Re-arming moves it from level 1 to level 0
+
+    TEST_ASSERT_FALSE( timer_wheel_advance( &wheel, 54, &expired ) );
+    TEST_ASSERT_TRUE( timer_wheel_advance( &wheel, 55, &expired ) );
+    TEST_ASSERT_EQUAL_PTR( &three.list, expired.next );
+    TEST_ASSERT_EQUAL_PTR( &three.list, expired.prev );
+
+    // A timer armed for a tick that's already been processed is due at the next one.
+    //
+    timer_wheel_arm( &wheel, &three, 10 );
+    TEST_ASSERT_TRUE( list_empty( &expired ) );
+    timer_wheel_arm( &wheel, &two, 58 );
+    TEST_ASSERT_TRUE( timer_wheel_advance( &wheel, 60, &expired ) );
+    TEST_ASSERT_EQUAL_PTR( &three.list, expired.next );
+    TEST_ASSERT_EQUAL_PTR( &two.list, expired.next->next );
+    TEST_ASSERT_EQUAL_PTR( &one.list, expired.prev );
+}
+
+void test_timer_wheel_timer_beyond_last_level(void)
+{
+    static timer_wheel_t wheel;
+    timer_node_t far, near;
+    uint64_t span = 1ULL << ( TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS ), due = 123 + 2 * span + 777;
+    LIST_INIT(expired);
+    timer_wheel_init( &wheel, 123 );
+    timer_init( &far );
+    timer_init( &near );
+    timer_wheel_arm( &wheel, &far, due );
+    timer_wheel_arm( &wheel, &near, 123 + span - 1 );
+    TEST_ASSERT_FALSE( timer_wheel_advance( &wheel, 123 + span - 2, &expired ) );
+    TEST_ASSERT_TRUE( timer_wheel_advance( &wheel, 123 + span - 1, &expired ) );
+    TEST_ASSERT_EQUAL_PTR( &near.list, expired.next );
+    list_del( &near.list );
+    TEST_ASSERT_FALSE( timer_wheel_advance( &wheel, due - 1, &expired ) );
+    TEST_ASSERT_TRUE( timer_wheel_advance( &wheel, due, &expired ) );
+    TEST_ASSERT_EQUAL_PTR( &far.list, expired.next );
+}
+
+static inline bool is_multiple_of_three( const void * item )
+{
+    return (*(uint32_t *)item) % 3 == 0;
+}
+
+void test_array_filter_select_and_gather(void)
+{
+    uint32_t values[20], selection[20], gathered[20], expected[] = {3,9,15};
+    ARRAY_FOR_EACH( values, idx ) values[idx] = idx;
+    size_t num_selected = array_filter_select( values, LEN_ARRAY(values), sizeof(values[0]), selection, is_odd );
+    TEST_ASSERT_EQUAL( 10, num_selected );
+    TEST_ASSERT_EQUAL_UINT32( 19, selection[9] );
+    num_selected = array_filter_select_more( values, sizeof(values[0]), selection, num_selected, is_multiple_of_three );
+    TEST_ASSERT_EQUAL( 3, num_selected );
+    TEST_ASSERT_EQUAL( 3, array_gather( values, sizeof(values[0]), selection, num_selected, gathered ) );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY( expected, gathered, 3 );
+    TEST_ASSERT_EQUAL( 0, array_filter_select( values, 0, sizeof(values[0]), selection, is_odd ) );
+}
+
+void test_array_filter_bitmap_and_or_count(void)
+{
+    uint32_t values[130];
+    uint64_t odd[ARRAY_BITMAP_WORDS(130)], threes[ARRAY_BITMAP_WORDS(130)], both[ARRAY_BITMAP_WORDS(130)];
+    TEST_ASSERT_EQUAL( 3, LEN_ARRAY(odd) );
+    ARRAY_FOR_EACH( values, idx ) values[idx] = idx;
+    memset( odd, 0xFF, sizeof(odd) );                       // Every word is written, including the unused bits
+    TEST_ASSERT_EQUAL( 65, array_filter_bitmap( values, LEN_ARRAY(values), sizeof(values[0]), odd, is_odd ) );
+    TEST_ASSERT_EQUAL_UINT64( 0x2, odd[2] );                // 129 is odd; bits for 130 and up are clear
+    TEST_ASSERT_EQUAL( 44, array_filter_bitmap( values, LEN_ARRAY(values), sizeof(values[0]), threes, is_multiple_of_three ) );
+    TEST_ASSERT_EQUAL( 65, array_count_bitmap( odd, LEN_ARRAY(values) ) );
+
+    memcpy( both, odd, sizeof(odd) );
+    array_bitmap_and( both, threes, LEN_ARRAY(values) );
+    TEST_ASSERT_EQUAL( 22, array_count_bitmap( both, LEN_ARRAY(values) ) );    // Odd multiples of 3 up to 129
+    array_bitmap_or( odd, threes, LEN_ARRAY(values) );
+    TEST_ASSERT_EQUAL( 65 + 44 - 22, array_count_bitmap( odd, LEN_ARRAY(values) ) );
+}
+
+void test_array_bitmap_to_selection_matches_filter_pure(void)
+{
+    uint32_t values[200], selection[200], gathered[200], filtered[200], state = 7;
+    uint64_t bitmap[ARRAY_BITMAP_WORDS(200)];
+    ARRAY_FOR_EACH( values, idx )
+    {
+        state = state * 1103515245 + 12345;
+        values[idx] = state >> 16;
+    }
+    size_t count = array_filter_bitmap( values, LEN_ARRAY(values), sizeof(values[0]), bitmap, is_odd );
+    TEST_ASSERT_EQUAL( count, array_bitmap_to_selection( bitmap, LEN_ARRAY(values), selection ) );
+    array_gather( values, sizeof(values[0]), selection, count, gathered );
+    TEST_ASSERT_EQUAL( count, array_filter_pure( values, LEN_ARRAY(values), sizeof(values[0]), filtered, is_odd ) );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY( filtered, gathered, count );
+}
+
+typedef struct record_t
+{
+    uint64_t    id;
+    uint32_t    status;
+    uint16_t    region;
+    uint8_t     flags;
+    char        name[28];
+} record_t;
+
+static void make_records( record_t * records, size_t num )
+{
+    for( size_t idx = 0; idx < num; idx++ )
+    {
+        records[idx] = (record_t){ .id = 1000 + idx, .status = idx % 7, .region = ( idx * 37 ) % 50, .flags = idx & 3 };
+        snprintf( records[idx].name, sizeof(records[idx].name), "record %zu", idx );
+    }
+}
+
+void test_array_find_and_count_field(void)
+{
+    record_t records[100];
+    make_records( records, LEN_ARRAY(records) );
+    TEST_ASSERT_EQUAL( 42, array_find_field( records, LEN_ARRAY(records), sizeof(record_t), offsetof(record_t, id), 8, 1042 ) );
+    TEST_ASSERT_EQUAL( -1, array_find_field( records, LEN_ARRAY(records), sizeof(record_t), offsetof(record_t, id), 8, 999 ) );
+    TEST_ASSERT_EQUAL( 3, array_find_field( records, LEN_ARRAY(records), sizeof(record_t), offsetof(record_t, flags), 1, 3 ) );
+    TEST_ASSERT_EQUAL( -1, array_find_field( records, LEN_ARRAY(records), sizeof(record_t), offsetof(record_t, flags), 3, 3 ) );
+
+    TEST_ASSERT_EQUAL( 15, array_count_field_range( records, LEN_ARRAY(records), sizeof(record_t), offsetof(record_t, status), 4, 0, 0 ) );
+    TEST_ASSERT_EQUAL( 100, array_count_field_range( records, LEN_ARRAY(records), sizeof(record_t), offsetof(record_t, region), 2, 0, 49 ) );
+    TEST_ASSERT_EQUAL( 20, array_count_field_range( records, LEN_ARRAY(records), sizeof(record_t), offsetof(record_t, region), 2, 10, 19 ) );
+    TEST_ASSERT_EQUAL( 0, array_count_field_range( records, LEN_ARRAY(records), sizeof(record_t), offsetof(record_t, region), 2, 50, 60 ) );
+}
+
+void test_array_find_minmax_field(void)
+{
+    record_t records[100];
+    int min, max;
+    make_records( records, LEN_ARRAY(records) );
+    array_find_minmax_field( records, LEN_ARRAY(records), sizeof(record_t), offsetof(record_t, region), 2, &min, &max );
+    TEST_ASSERT_EQUAL( 0, min );
+    TEST_ASSERT_EQUAL( 27, max );                           // 27 * 37 % 50 == 49, its first occurrence
+    records[60].id = 1;
+    array_find_minmax_field( records, LEN_ARRAY(records), sizeof(record_t), offsetof(record_t, id), 8, &min, &max );
+    TEST_ASSERT_EQUAL( 60, min );
+    TEST_ASSERT_EQUAL( 99, max );
+    array_find_minmax_field( records, 0, sizeof(record_t), offsetof(record_t, id), 8, &min, &max );
+    TEST_ASSERT_EQUAL( -1, min );
+    TEST_ASSERT_EQUAL( -1, max );
+}
+
+void test_array_aos_to_soa_round_trip(void)
+{
+    record_t records[100], copy[100];
+    uint32_t status[100];
+    uint16_t region[100];
+    char names[100][28];
+    size_t offsets[] = { offsetof(record_t, status), offsetof(record_t, region), offsetof(record_t, name) };
+    size_t widths[] = { 4, 2, 28 };
+    void * columns[] = { status, region, names };
+    make_records( records, LEN_ARRAY(records) );
+    memcpy( copy, records, sizeof(records) );
+
+    array_aos_to_soa( records, LEN_ARRAY(records), sizeof(record_t), offsets, widths, LEN_ARRAY(offsets), columns );
+    TEST_ASSERT_EQUAL_UINT32( 5, status[12] );
+    TEST_ASSERT_EQUAL_MEMORY( "record 99", names[99], 10 );
+
+    // Scanning the dense column gives the same answer as scanning the records.
+    //
+    TEST_ASSERT_EQUAL( array_count_field_range( records, LEN_ARRAY(records), sizeof(record_t), offsetof(record_t, region), 2, 5, 30 ),
+                       array_count_field_range( region, LEN_ARRAY(region), sizeof(region[0]), 0, 2, 5, 30 ) );
+
+    ARRAY_FOR_EACH( status, idx ) status[idx] += 100;
+    array_soa_to_aos( records, LEN_ARRAY(records), sizeof(record_t), offsets, widths, LEN_ARRAY(offsets), (const void * const *)columns );
+    ARRAY_FOR_EACH( records, idx )
+    {
+        TEST_ASSERT_EQUAL_UINT32( copy[idx].status + 100, records[idx].status );
+        TEST_ASSERT_EQUAL_UINT64( copy[idx].id, records[idx].id );
+        TEST_ASSERT_EQUAL_MEMORY( copy[idx].name, records[idx].name, sizeof(copy[idx].name) );
+    }
+}
+
+static int deleted_count;
+
+static void count_deletes( void * item )
+{
+    deleted_count++;
+}
+
+static uint64_t hash_uint32( const void * elem )
+{
+    return *(const uint32_t *)elem;
+}
+
+static uint64_t hash_myStruct( const void * elem )
+{
+    return ((const myStruct_t *)elem)->data;
+}
+
+void test_array_unique_sorted(void)
+{
+    uint32_t values[] = {1,1,2,4,4,4,5,7,7}, expected[] = {1,2,4,5,7,0,0,0,0};
+    uint32_t same[] = {3,3,3}, distinct[] = {1,2,3};
+    deleted_count = 0;
+    TEST_ASSERT_EQUAL( 5, array_unique_sorted( values, LEN_ARRAY(values), sizeof(values[0]), compare_uint32, count_deletes ) );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY( expected, values, LEN_ARRAY(values) );
+    TEST_ASSERT_EQUAL( 4, deleted_count );
+    TEST_ASSERT_EQUAL( 1, array_unique_sorted( same, LEN_ARRAY(same), sizeof(same[0]), compare_uint32, NULL ) );
+    TEST_ASSERT_EQUAL_UINT32( 0, same[1] );
+    TEST_ASSERT_EQUAL( 3, array_unique_sorted( distinct, LEN_ARRAY(distinct), sizeof(distinct[0]), compare_uint32, NULL ) );
+    TEST_ASSERT_EQUAL_UINT32( 3, distinct[2] );
+    TEST_ASSERT_EQUAL( 0, array_unique_sorted( distinct, 0, sizeof(distinct[0]), compare_uint32, NULL ) );
+}
+
+void test_array_unique_hash_keeps_first_occurrences_in_order(void)
+{
+    uint32_t values[] = {7,3,7,1,3,3,9,1,7}, expected[] = {7,3,1,9,0,0,0,0,0}, many[1000], sorted[1000];
+    deleted_count = 0;
+    TEST_ASSERT_EQUAL( 4, array_unique_hash( values, LEN_ARRAY(values), sizeof(values[0]), hash_uint32, compare_uint32, count_deletes ) );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY( expected, values, LEN_ARRAY(values) );
+    TEST_ASSERT_EQUAL( 5, deleted_count );
+
+    // Agrees with sorting and "array_unique_sorted" on the number of distinct values.
+    //
+    ARRAY_FOR_EACH( many, idx ) many[idx] = ( idx * 7919 ) % 311;
+    memcpy( sorted, many, sizeof(many) );
+    qsort( sorted, LEN_ARRAY(sorted), sizeof(sorted[0]), compare_uint32 );
+    TEST_ASSERT_EQUAL( 311, array_unique_sorted( sorted, LEN_ARRAY(sorted), sizeof(sorted[0]), compare_uint32, NULL ) );
+    TEST_ASSERT_EQUAL( 311, array_unique_hash( many, LEN_ARRAY(many), sizeof(many[0]), hash_uint32, compare_uint32, NULL ) );
+    TEST_ASSERT_EQUAL_UINT32( 0, many[0] );
+    TEST_ASSERT_EQUAL_UINT32( 7919 % 311, many[1] );
+}
+
+void test_linked_list_unique(void)
+{
+    myStruct_t nodes[8];
+    uint32_t data[] = {2,5,2,2,8,5,1,8}, expected[] = {2,5,8,1}, sorted_expected[] = {1,2,5,8};
+    LIST_INIT(list);
+    LIST_INIT(removed);
+    ll_t * node;
+    int idx = 0;
+    ARRAY_FOR_EACH( nodes, i )
+    {
+        nodes[i].data = data[i];
+        list_add_tail( &nodes[i].node, &list );
+    }
+    TEST_ASSERT_EQUAL( 4, linked_list_unique( &list, &removed, hash_myStruct, compare_myStructs ) );
+    list_for_each( node, &list ) TEST_ASSERT_EQUAL_UINT32( expected[idx++], ((myStruct_t *)node)->data );
+    TEST_ASSERT_EQUAL( 4, idx );
+    TEST_ASSERT_EQUAL_PTR( &nodes[2].node, removed.next );
+    TEST_ASSERT_EQUAL_PTR( &nodes[7].node, removed.prev );
+
+    // Without a hash function, on a sorted list.
+    //
+    list_splice_tail( &removed, &list );
+    linked_list_merge_sort( &list, compare_myStructs );
+    TEST_ASSERT_EQUAL( 4, linked_list_unique( &list, NULL, NULL, compare_myStructs ) );
+    idx = 0;
+    list_for_each( node, &list ) TEST_ASSERT_EQUAL_UINT32( sorted_expected[idx++], ((myStruct_t *)node)->data );
+    TEST_ASSERT_EQUAL( 4, idx );
+    TEST_ASSERT_EQUAL( 0, linked_list_unique( &list, NULL, hash_myStruct, compare_myStructs ) );
+}
+
+void test_array_set_operations(void)
+{
+    uint32_t x[] = {1,3,3,3,5,7}, y[] = {3,4,5,5,6}, out[16];
+    uint32_t intersect[] = {3,5}, set_union[] = {1,3,3,3,4,5,5,6,7}, difference[] = {1,3,3,7}, symmetric[] = {1,3,3,4,5,6,7};
+    TEST_ASSERT_EQUAL( 2, array_set_intersect( x, LEN_ARRAY(x), y, LEN_ARRAY(y), sizeof(x[0]), out, compare_uint32 ) );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY( intersect, out, 2 );
+    TEST_ASSERT_EQUAL( 9, array_set_union( x, LEN_ARRAY(x), y, LEN_ARRAY(y), sizeof(x[0]), out, compare_uint32 ) );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY( set_union, out, 9 );
+    TEST_ASSERT_EQUAL( 4, array_set_difference( x, LEN_ARRAY(x), y, LEN_ARRAY(y), sizeof(x[0]), out, compare_uint32 ) );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY( difference, out, 4 );
+    TEST_ASSERT_EQUAL( 7, array_set_symmetric_difference( x, LEN_ARRAY(x), y, LEN_ARRAY(y), sizeof(x[0]), out, compare_uint32 ) );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY( symmetric, out, 7 );
+    TEST_ASSERT_EQUAL( 0, array_set_intersect( x, 0, y, LEN_ARRAY(y), sizeof(x[0]), out, compare_uint32 ) );
+}
+
+void test_array_set_operations_gallop_on_very_different_sizes(void)
+{
+    static uint32_t big[1000], out[1010];
+    uint32_t small[] = {0,5,10,499,500,1998,2001,3000}, expected[] = {0,10,500,1998};
+    ARRAY_FOR_EACH( big, idx ) big[idx] = 2 * idx;
+    TEST_ASSERT_EQUAL( 4, array_set_intersect( small, LEN_ARRAY(small), big, LEN_ARRAY(big), sizeof(big[0]), out, compare_uint32 ) );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY( expected, out, 4 );
+    TEST_ASSERT_EQUAL( 4, array_set_intersect( big, LEN_ARRAY(big), small, LEN_ARRAY(small), sizeof(big[0]), out, compare_uint32 ) );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY( expected, out, 4 );
+    TEST_ASSERT_EQUAL( 1004, array_set_union( big, LEN_ARRAY(big), small, LEN_ARRAY(small), sizeof(big[0]), out, compare_uint32 ) );
+    for( int idx = 1; idx < 1004; idx++ ) TEST_ASSERT_TRUE( out[idx - 1] < out[idx] );
+    TEST_ASSERT_EQUAL( 996, array_set_difference( big, LEN_ARRAY(big), small, LEN_ARRAY(small), sizeof(big[0]), out, compare_uint32 ) );
+    TEST_ASSERT_EQUAL_UINT32( 2, out[0] );
+    TEST_ASSERT_EQUAL_UINT32( 1996, out[995] );
+}
+
+void test_linked_list_set_operations(void)
+{
+    myStruct_t one[5], two[4];
+    uint32_t data_one[] = {1,2,4,6,8}, data_two[] = {2,3,6,9};
+    uint32_t symmetric[] = {1,3,4,8,9};
+    LIST_INIT(head);
+    LIST_INIT(other);
+    LIST_INIT(removed);
+    ll_t * node;
+    int idx = 0;
+    ARRAY_FOR_EACH( one, i ) { one[i].data = data_one[i]; list_add_tail( &one[i].node, &head ); }
+    ARRAY_FOR_EACH( two, i ) { two[i].data = data_two[i]; list_add_tail( &two[i].node, &other ); }
+
+    linked_list_set_symmetric_difference( &head, &other, &removed, compare_myStructs );
+    list_for_each( node, &head ) TEST_ASSERT_EQUAL_UINT32( symmetric[idx++], ((myStruct_t *)node)->data );
+    TEST_ASSERT_EQUAL( 5, idx );
+    TEST_ASSERT_EQUAL_PTR( &one[1].node, removed.next );            // 2 and 6 were in both
+    TEST_ASSERT_EQUAL_PTR( &one[3].node, removed.prev );
+    TEST_ASSERT_EQUAL_PTR( &two[0].node, other.next );              // The 2 and 6 from "other" stay there
+    TEST_ASSERT_EQUAL_PTR( &two[2].node, other.prev );
+
+    // {1,3,4,8,9} intersected with {2,6}, then the union with them, then the difference.
+    //
+    linked_list_set_intersect( &head, &other, NULL, compare_myStructs );
+    TEST_ASSERT_TRUE( list_empty( &head ) );
+    list_add_tail( &one[0].node, &head );
+    list_add_tail( &one[4].node, &head );
+    linked_list_set_union( &head, &other, compare_myStructs );
+    TEST_ASSERT_TRUE( list_empty( &other ) );
+    TEST_ASSERT_EQUAL_PTR( &two[0].node, one[0].node.next );
+    TEST_ASSERT_EQUAL_PTR( &two[2].node, one[4].node.prev );
+    list_add_tail( &one[3].node, &other );
+    linked_list_set_difference( &head, &other, NULL, compare_myStructs );
+    idx = 0;
+    list_for_each( node, &head ) idx++;
+    TEST_ASSERT_EQUAL( 3, idx );
+    TEST_ASSERT_EQUAL_PTR( &one[4].node, two[0].node.next );
+}
+
+void test_array_set_intersect_simd_matches_scalar(void)
+{
+    static uint32_t one32[1000], two32[700], out32[1000], expected32[1000];
+    static uint64_t one64[1000], two64[700], out64[1000], expected64[1000];
+    uint32_t state = 11;
+    size_t num_one = 0, num_two = 0;
+    for( uint32_t value = 0; num_one < LEN_ARRAY(one32) || num_two < LEN_ARRAY(two32); value++ )
+    {
+        state = state * 1103515245 + 12345;
+        if( ( state >> 16 ) % 3 && num_one < LEN_ARRAY(one32) ) one32[num_one++] = value;
+        if( ( state >> 20 ) % 2 && num_two < LEN_ARRAY(two32) ) two32[num_two++] = value;
+    }
+    ARRAY_FOR_EACH( one32, idx ) one64[idx] = ( (uint64_t)one32[idx] << 32 ) | one32[idx];
+    ARRAY_FOR_EACH( two32, idx ) two64[idx] = ( (uint64_t)two32[idx] << 32 ) | two32[idx];
+
+    // Every length from 0 up, so that every way of running out partway through a block is covered.
+    //
+    for( size_t num = 0; num < 40; num++ )
+    {
+        size_t count = array_set_intersect_u32_scalar( one32, 1000 - num, two32, 700 - num * 3, expected32 );
+        TEST_ASSERT_EQUAL( count, array_set_intersect_u32( one32, 1000 - num, two32, 700 - num * 3, out32 ) );
+        TEST_ASSERT_EQUAL_UINT32_ARRAY( expected32, out32, count );
+        TEST_ASSERT_EQUAL( count, array_set_intersect( one32, 1000 - num, two32, 700 - num * 3, sizeof(one32[0]), out32, compare_uint32 ) );
+        TEST_ASSERT_EQUAL( count, array_set_intersect_u64_scalar( one64, 1000 - num, two64, 700 - num * 3, expected64 ) );
+        TEST_ASSERT_EQUAL( count, array_set_intersect_u64( one64, 1000 - num, two64, 700 - num * 3, out64 ) );
+        TEST_ASSERT_EQUAL_MEMORY( expected64, out64, count * sizeof(uint64_t) );
+#if ARRAY_SET_SIMD
+        TEST_ASSERT_EQUAL( count, array_set_intersect_u32_sse2( one32, 1000 - num, two32, 700 - num * 3, out32 ) );
+        TEST_ASSERT_EQUAL_UINT32_ARRAY( expected32, out32, count );
+        if( __builtin_cpu_supports( "sse4.1" ) )
+        {
+            TEST_ASSERT_EQUAL( count, array_set_intersect_u64_sse41( one64, 1000 - num, two64, 700 - num * 3, out64 ) );
+            TEST_ASSERT_EQUAL_MEMORY( expected64, out64, count * sizeof(uint64_t) );
+        }
+#endif
+    }
+}
+
+void test_linked_list_sorted_insert_hint(void)
+{
+    myStruct_t items[8];
+    uint32_t values[] = {10,20,30,25,26,5,40,26}, idx = 0, expected[] = {5,10,20,25,26,26,30,40};
+    LIST_INIT(test_list);
+    ll_t *node, *finger = NULL;
+    ARRAY_FOR_EACH( values, jdx )
+    {
+        items[jdx].data = values[jdx];
+        finger = linked_list_sorted_insert_hint( &test_list, &items[jdx].node, finger, compare_myStructs );
+        TEST_ASSERT_TRUE( finger == &items[jdx].node );
+    }
+    list_for_each( node, &test_list )
+    {
+        TEST_ASSERT_EQUAL_UINT32( expected[idx++], ((myStruct_t *)node)->data);
+    }
+    TEST_ASSERT_EQUAL( 8, idx );
+    // The second 26 was reached walking back from 40, and still goes after the first one
+    TEST_ASSERT_TRUE( items[4].node.next == &items[7].node );
+}
+
+void test_linked_list_sorted_insert_hint_null_finger_matches_sorted_insert(void)
+{
+    myStruct_t items[6], copies[6];
+    uint32_t values[] = {3,1,4,1,5,2};
+    LIST_INIT(hinted);
+    LIST_INIT(plain);
+    ARRAY_FOR_EACH( values, idx )
+    {
+        items[idx].data = copies[idx].data = values[idx];
+        linked_list_sorted_insert_hint( &hinted, &items[idx].node, NULL, compare_myStructs );
+        linked_list_sorted_insert( &plain, &copies[idx].node, compare_myStructs );
+    }
+    ll_t *node = hinted.next, *other = plain.next;
+    for( ; node != &hinted; node = node->next, other = other->next )
+    {
+        TEST_ASSERT_TRUE( other != &plain );
+        TEST_ASSERT_EQUAL( (myStruct_t *)node - items, (myStruct_t *)other - copies );
+    }
+    TEST_ASSERT_TRUE( other == &plain );
+}
+
+void test_linked_list_adaptive_insertion_sort(void)
+{
+    myStruct_t items[10];
+    uint32_t values[] = {1,2,4,3,5,6,6,9,8,7}, idx = 0, expected[] = {1,2,3,4,5,6,6,7,8,9};
+    LIST_INIT(test_list);
+    ll_t *node;
+    ARRAY_FOR_EACH( values, jdx )
+    {
+        items[jdx].data = values[jdx];
+        list_add_tail( &items[jdx].node, &test_list );
+    }
+    linked_list_adaptive_insertion_sort( &test_list, compare_myStructs );
+    list_for_each( node, &test_list )
+    {
+        TEST_ASSERT_EQUAL_UINT32( expected[idx++], ((myStruct_t *)node)->data);
+    }
+    TEST_ASSERT_EQUAL( 10, idx );
+    TEST_ASSERT_TRUE( items[5].node.next == &items[6].node );  // Stable
+
+    linked_list_reverse( &test_list );
+    linked_list_adaptive_insertion_sort( &test_list, compare_myStructs );
+    idx = 0;
+    list_for_each( node, &test_list )
+    {
+        TEST_ASSERT_EQUAL_UINT32( expected[idx++], ((myStruct_t *)node)->data);
+    }
+    TEST_ASSERT_EQUAL( 10, idx );
+
+    LIST_INIT(empty_list);
+    linked_list_adaptive_insertion_sort( &empty_list, compare_myStructs );
+    TEST_ASSERT_TRUE( list_empty( &empty_list ) );
+}
+
+void test_bplus_tree_insert_find_remove(void)
+{
+    bplus_tree_t tree;
+    uint32_t value, removed, *found;
+    TEST_ASSERT_TRUE( bplus_tree_init( &tree, sizeof(uint32_t), 128, compare_uint32 ) );    // 26 values per leaf
+    TEST_ASSERT_NULL( bplus_tree_find_min( &tree ) );
+
+    // 1000 values in a scrambled order (7 * 143 = 1001), so that leaves and branches split
+    for( uint32_t idx = 0; idx < 1000; idx++ )
+    {
+        value = ( idx * 143 ) % 1000;
+        TEST_ASSERT_EQUAL( 1, bplus_tree_insert( &tree, &value ) );
+    }
+    TEST_ASSERT_EQUAL( 0, bplus_tree_insert( &tree, &value ) );
+    TEST_ASSERT_EQUAL( 1000, tree.count );
+    TEST_ASSERT_TRUE( tree.height >= 3 );
+    for( value = 0; value < 1000; value++ )
+    {
+        found = bplus_tree_find( &tree, &value );
+        TEST_ASSERT_NOT_NULL( found );
+        TEST_ASSERT_EQUAL_UINT32( value, *found );
+    }
+    value = 1000;
+    TEST_ASSERT_NULL( bplus_tree_find( &tree, &value ) );
+
+    // Removing the even values makes leaves borrow from and merge with their siblings
+    for( value = 0; value < 1000; value += 2 )
+    {
+        TEST_ASSERT_TRUE( bplus_tree_remove( &tree, &value, &removed ) );
+        TEST_ASSERT_EQUAL_UINT32( value, removed );
+    }
+    value = 500;
+    TEST_ASSERT_FALSE( bplus_tree_remove( &tree, &value, NULL ) );
+    TEST_ASSERT_EQUAL( 500, tree.count );
+    TEST_ASSERT_EQUAL_UINT32( 1, *(uint32_t *)bplus_tree_find_min( &tree ) );
+    TEST_ASSERT_EQUAL_UINT32( 999, *(uint32_t *)bplus_tree_find_max( &tree ) );
+
+    bplus_iter_t iter;
+    uint32_t expected = 1;
+    bplus_tree_for_each( found, &iter, &tree )
+    {
+        TEST_ASSERT_EQUAL_UINT32( expected, *found );
+        expected += 2;
+    }
+    TEST_ASSERT_EQUAL_UINT32( 1001, expected );
+
+    for( value = 1; value < 1000; value += 2 ) TEST_ASSERT_TRUE( bplus_tree_remove( &tree, &value, NULL ) );
+    TEST_ASSERT_NULL( tree.root );
+    TEST_ASSERT_EQUAL( 0, tree.count );
+    bplus_tree_free( &tree, NULL );
+}
+
+void test_bplus_tree_bulk_load_seek_and_count_range(void)
+{
+    bplus_tree_t tree;
+    bplus_iter_t iter;
+    uint32_t values[500], lo, hi, *found;
+    ARRAY_FOR_EACH( values, idx ) values[idx] = idx * 10;
+    bplus_tree_init( &tree, sizeof(uint32_t), 128, compare_uint32 );
+    TEST_ASSERT_TRUE( bplus_tree_bulk_load( &tree, values, LEN_ARRAY(values) ) );
+    TEST_ASSERT_FALSE( bplus_tree_bulk_load( &tree, values, LEN_ARRAY(values) ) );    // Not empty
+    TEST_ASSERT_EQUAL( 500, tree.count );
+    TEST_ASSERT_EQUAL_UINT32( 4990, *(uint32_t *)bplus_tree_find_max( &tree ) );
+
+    lo = 1234;
+    found = bplus_tree_seek( &tree, &lo, &iter );
+    TEST_ASSERT_EQUAL_UINT32( 1240, *found );
+    TEST_ASSERT_EQUAL_UINT32( 1250, *(uint32_t *)bplus_tree_next( &tree, &iter ) );
+    lo = 4991;
+    TEST_ASSERT_NULL( bplus_tree_seek( &tree, &lo, &iter ) );
+
+    lo = 1234; hi = 2000;
+    TEST_ASSERT_EQUAL( 77, bplus_tree_count_range( &tree, &lo, &hi ) );     // 1240, 1250, ..., 2000
+    TEST_ASSERT_EQUAL( 201, bplus_tree_count_range( &tree, NULL, &hi ) );
+    TEST_ASSERT_EQUAL( 376, bplus_tree_count_range( &tree, &lo, NULL ) );
+    TEST_ASSERT_EQUAL( 0, bplus_tree_count_range( &tree, &hi, &lo ) );
+    lo = 1241; hi = 1249;
+    TEST_ASSERT_EQUAL( 0, bplus_tree_count_range( &tree, &lo, &hi ) );
+
+    // Inserting after a bulk load splits the (full) leaves
+    lo = 15;
+    TEST_ASSERT_EQUAL( 1, bplus_tree_insert( &tree, &lo ) );
+    TEST_ASSERT_EQUAL( 3, bplus_tree_count_range( &tree, NULL, &lo ) );
+    bplus_tree_free( &tree, NULL );
+    TEST_ASSERT_EQUAL( 0, bplus_tree_count_range( &tree, NULL, NULL ) );
+}
+
+void test_bplus_tree_filter_and_count(void)
+{
+    bplus_tree_t tree;
+    bplus_iter_t iter;
+    uint32_t values[600], *found, expected = 1;
+    ARRAY_FOR_EACH( values, idx ) values[idx] = idx;
+    bplus_tree_init( &tree, sizeof(uint32_t), 0, compare_uint32 );
+    bplus_tree_bulk_load( &tree, values, LEN_ARRAY(values) );
+    TEST_ASSERT_EQUAL( 300, bplus_tree_count( &tree, is_odd ) );
+
+    deleted_count = 0;
+    TEST_ASSERT_EQUAL( 300, bplus_tree_filter( &tree, is_odd, count_deletes ) );
+    TEST_ASSERT_EQUAL( 300, deleted_count );
+    TEST_ASSERT_EQUAL( 300, tree.count );
+    bplus_tree_for_each( found, &iter, &tree )
+    {
+        TEST_ASSERT_EQUAL_UINT32( expected, *found );
+        expected += 2;
+    }
+    TEST_ASSERT_EQUAL_UINT32( 601, expected );
+    TEST_ASSERT_NOT_NULL( bplus_tree_find( &tree, &values[301] ) );
+    TEST_ASSERT_NULL( bplus_tree_find( &tree, &values[300] ) );
+
+    TEST_ASSERT_EQUAL( 1, bplus_tree_insert( &tree, &values[300] ) );
+    TEST_ASSERT_EQUAL( 296, bplus_tree_filter( &tree, greater_than_ten, NULL ) );    // Drops 1, 3, 5, 7 and 9
+    deleted_count = 0;
+    bplus_tree_free( &tree, count_deletes );
+    TEST_ASSERT_NULL( tree.root );
+    TEST_ASSERT_EQUAL( 296, deleted_count );    // 11, 13, ..., 599 and 300
+}
+
 int main(void)
 {
     UNITY_BEGIN();
@@ -332,9 +2158,31 @@ int main(void)
     RUN_TEST(test_array_remove);
     RUN_TEST(test_array_remove_from_end);
     RUN_TEST(test_array_reverse);
+    RUN_TEST(test_array_find_max_and_min);
+    RUN_TEST(test_array_find_minmax);
+    RUN_TEST(test_array_find_minmax_odd_length);
+    RUN_TEST(test_array_nth_element);
+    RUN_TEST(test_array_nth_element_with_duplicates);
+    RUN_TEST(test_array_top_k);
+    RUN_TEST(test_array_top_k_returns_all_items_when_k_exceeds_num);
+    RUN_TEST(test_array_sorted_insert);
+    RUN_TEST(test_array_sorted_insert_at_ends);
+    RUN_TEST(test_array_merge_sorted);
+    RUN_TEST(test_array_merge_sorted_in_place);
+    RUN_TEST(test_array_stable_sort_keeps_equal_elements_in_order);
+    RUN_TEST(test_array_stable_sort_with_scratch_on_runs);
+    RUN_TEST(test_array_stable_sort_reversed_input);
+    RUN_TEST(test_list_splice);
+    RUN_TEST(test_list_splice_tail);
+    RUN_TEST(test_list_cut_position);
+    RUN_TEST(test_list_split_half);
+    RUN_TEST(test_linked_list_merge_sorted);
     RUN_TEST(test_linked_list_find);
     RUN_TEST(test_linked_list_find_max);
     RUN_TEST(test_linked_list_find_min);
+    RUN_TEST(test_linked_list_find_minmax);
+    RUN_TEST(test_linked_list_find_minmax_empty_list);
+    RUN_TEST(test_linked_list_top_k);
     RUN_TEST(test_linked_list_count);
     RUN_TEST(test_linked_list_filter_in_place);
     RUN_TEST(test_linked_list_filter_pure);
@@ -345,5 +2193,75 @@ int main(void)
     RUN_TEST(test_linked_list_sorted_insert_adds_to_middle);
     RUN_TEST(test_linked_list_insertion_sort);
     RUN_TEST(test_linked_list_reverse);
+    RUN_TEST(test_ring_buffer_init_rejects_capacity_not_power_of_two);
+    RUN_TEST(test_ring_buffer_push_and_pop);
+    RUN_TEST(test_ring_buffer_push_n_and_pop_n_wrap_around);
+    RUN_TEST(test_ring_buffer_push_n_stops_when_full);
+    RUN_TEST(test_vector_push_back_grows_capacity);
+    RUN_TEST(test_vector_append_n_and_find);
+    RUN_TEST(test_vector_insert_and_remove);
+    RUN_TEST(test_vector_filter_and_reverse);
+    RUN_TEST(test_vector_sorted_insert);
+    RUN_TEST(test_array_save_and_open_mapped);
+    RUN_TEST(test_array_open_mapped_copy_on_write_leaves_file_unchanged);
+    RUN_TEST(test_array_open_mapped_rejects_corrupted_file);
+    RUN_TEST(test_offset_list_survives_relocation);
+    RUN_TEST(test_offset_list_zeroed_head_is_empty);
+    RUN_TEST(test_offset_list_filter_in_place);
+    RUN_TEST(test_offset_list_sort_and_reverse);
+    RUN_TEST(test_offset_list_sort_is_stable);
+    RUN_TEST(test_offset_list_sorted_insert);
+    RUN_TEST(test_stream_count_handles_records_split_across_chunks);
+    RUN_TEST(test_stream_find);
+    RUN_TEST(test_stream_filter);
+    RUN_TEST(test_stream_count_reports_truncated_record);
+    RUN_TEST(test_pool_list_push_back_find_and_count);
+    RUN_TEST(test_pool_list_filter_in_place_reuses_nodes);
+    RUN_TEST(test_pool_list_sort_reverse_and_compact);
+    RUN_TEST(test_pool_list_sorted_insert);
+    RUN_TEST(test_array_sort_small_u32_every_length);
+    RUN_TEST(test_array_sort_small_signed_and_floating_point);
+    RUN_TEST(test_array_sort_small_with_compare);
+    RUN_TEST(test_linked_list_radix_sort);
+    RUN_TEST(test_array_radix_sort_is_stable);
+    RUN_TEST(test_radix_keys_preserve_order);
+    RUN_TEST(test_linked_list_merge_sort);
+    RUN_TEST(test_array_sort_par_is_stable);
+    RUN_TEST(test_linked_list_sort_par);
+    RUN_TEST(test_linked_list_count_and_find_par);
+    RUN_TEST(test_linked_list_count_par_sees_nodes_added_after_build);
+    RUN_TEST(test_linked_list_filter_in_place_par);
+    RUN_TEST(test_linked_list_filter_in_place_par_without_removed_list);
+    RUN_TEST(test_tlist_sort_is_stable_and_relinks_prev);
+    RUN_TEST(test_tlist_filter_and_count);
+    RUN_TEST(test_tlist_minmax_and_sorted_insert);
+    RUN_TEST(test_lru_cache_evicts_least_recently_used);
+    RUN_TEST(test_lru_cache_put_replaces_and_remove_keeps_table_consistent);
+    RUN_TEST(test_lru_sharded);
+    RUN_TEST(test_array_heap_push_pop_and_update);
+    RUN_TEST(test_array_heap4_heapify_and_update);
+    RUN_TEST(test_pairing_heap);
+    RUN_TEST(test_timer_wheel_expires_timers_on_their_tick);
+    RUN_TEST(test_timer_wheel_cancel_and_rearm);
+    RUN_TEST(test_timer_wheel_timer_beyond_last_level);
+    RUN_TEST(test_array_filter_select_and_gather);
+    RUN_TEST(test_array_filter_bitmap_and_or_count);
+    RUN_TEST(test_array_bitmap_to_selection_matches_filter_pure);
+    RUN_TEST(test_array_find_and_count_field);
+    RUN_TEST(test_array_find_minmax_field);
+    RUN_TEST(test_array_aos_to_soa_round_trip);
+    RUN_TEST(test_array_unique_sorted);
+    RUN_TEST(test_array_unique_hash_keeps_first_occurrences_in_order);
+    RUN_TEST(test_linked_list_unique);
+    RUN_TEST(test_array_set_operations);
+    RUN_TEST(test_array_set_operations_gallop_on_very_different_sizes);
+    RUN_TEST(test_linked_list_set_operations);
+    RUN_TEST(test_array_set_intersect_simd_matches_scalar);
+    RUN_TEST(test_linked_list_sorted_insert_hint);
+    RUN_TEST(test_linked_list_sorted_insert_hint_null_finger_matches_sorted_insert);
+    RUN_TEST(test_linked_list_adaptive_insertion_sort);
+    RUN_TEST(test_bplus_tree_insert_find_remove);
+    RUN_TEST(test_bplus_tree_bulk_load_seek_and_count_range);
+    RUN_TEST(test_bplus_tree_filter_and_count);
     return UNITY_END();
 }
\ No newline at end of file